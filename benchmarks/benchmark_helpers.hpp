@@ -0,0 +1,29 @@
+// Copyright (C) 2024 - zsliu98
+// This file is part of ZLEqualizer
+//
+// ZLEqualizer is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License Version 3 as published by the Free Software Foundation.
+//
+// ZLEqualizer is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License along with ZLEqualizer. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ZLEQUALIZER_BENCHMARK_HELPERS_HPP
+#define ZLEQUALIZER_BENCHMARK_HELPERS_HPP
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include <string>
+
+#include "../tests/test_helpers.hpp"
+
+namespace zlBenchmark {
+    inline auto static constexpr sampleRates = std::array{44100.0, 96000.0, 192000.0};
+
+    inline auto static constexpr blockSizes = std::array{64, 512, 2048};
+
+    inline std::string formatRate(const double sampleRate) {
+        return std::to_string(static_cast<int>(sampleRate / 1000.0)) + "k";
+    }
+}
+
+#endif //ZLEQUALIZER_BENCHMARK_HELPERS_HPP
@@ -0,0 +1,96 @@
+// Copyright (C) 2024 - zsliu98
+// This file is part of ZLEqualizer
+//
+// ZLEqualizer is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License Version 3 as published by the Free Software Foundation.
+//
+// ZLEqualizer is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License along with ZLEqualizer. If not, see <https://www.gnu.org/licenses/>.
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "PluginProcessor.hpp"
+#include "benchmark_helpers.hpp"
+
+namespace {
+    constexpr size_t activeBandNum = 8;
+
+    constexpr std::array structureNames{"minimum", "svf", "parallel", "matched", "mixed", "linear"};
+
+    enum Routing { stereo, lrms };
+
+    constexpr std::array routingNames{"stereo", "lrms"};
+
+    enum Dynamic { off, on, hq };
+
+    constexpr std::array dynamicNames{"static", "dynamic", "dynamic-hq"};
+
+    /**
+     * activate bands with high pass, peak and high shelf filters spread over the spectrum
+     * with lrms routing, the bands are assigned to stereo, left, right, mid and side in turn
+     */
+    void setBands(PluginProcessor &processor, const Routing routing, const Dynamic dynamic) {
+        for (size_t i = 0; i < activeBandNum; ++i) {
+            const auto filterType = i == 0
+                                        ? zlDSP::fType::highPass
+                                        : (i == activeBandNum - 1 ? zlDSP::fType::highShelf : zlDSP::fType::peak);
+            const auto freq = 40.f * std::pow(2.f, static_cast<float>(i) * 1.25f);
+            zlTest::setParameter(processor.parametersNA, zlDSP::appendSuffix(zlState::active::ID, i), 1.f);
+            zlTest::setParameter(processor.parameters, zlDSP::appendSuffix(zlDSP::fType::ID, i),
+                                      static_cast<float>(filterType));
+            zlTest::setParameter(processor.parameters, zlDSP::appendSuffix(zlDSP::freq::ID, i), freq);
+            zlTest::setParameter(processor.parameters, zlDSP::appendSuffix(zlDSP::gain::ID, i),
+                                      i % 2 == 0 ? 6.f : -6.f);
+            zlTest::setParameter(processor.parameters, zlDSP::appendSuffix(zlDSP::Q::ID, i), 1.f);
+            zlTest::setParameter(processor.parameters, zlDSP::appendSuffix(zlDSP::lrType::ID, i),
+                                      routing == Routing::stereo ? 0.f : static_cast<float>(i % 5));
+            zlTest::setParameter(processor.parameters, zlDSP::appendSuffix(zlDSP::bypass::ID, i), 0.f);
+            if (dynamic != Dynamic::off) {
+                zlTest::setParameter(processor.parameters, zlDSP::appendSuffix(zlDSP::dynamicON::ID, i), 1.f);
+                zlTest::setParameter(processor.parameters, zlDSP::appendSuffix(zlDSP::targetGain::ID, i),
+                                          i % 2 == 0 ? -6.f : 6.f);
+                zlTest::setParameter(processor.parameters, zlDSP::appendSuffix(zlDSP::threshold::ID, i),
+                                          -30.f);
+            }
+        }
+        zlTest::setParameter(processor.parameters, zlDSP::dynHQ::ID, dynamic == Dynamic::hq ? 1.f : 0.f);
+    }
+}
+
+TEST_CASE("Controller process", "[controller]") {
+    const auto structure = GENERATE(range(0, static_cast<int>(structureNames.size())));
+    const auto routing = static_cast<Routing>(GENERATE(range(0, static_cast<int>(routingNames.size()))));
+    const auto dynamic = static_cast<Dynamic>(GENERATE(range(0, static_cast<int>(dynamicNames.size()))));
+    const auto sampleRate = GENERATE(from_range(zlBenchmark::sampleRates));
+    const auto blockSize = GENERATE(from_range(zlBenchmark::blockSizes));
+
+    PluginProcessor processor;
+    zlTest::setParameter(processor.parameters, zlDSP::filterStructure::ID, static_cast<float>(structure));
+    setBands(processor, routing, dynamic);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    auto &controller = processor.getController();
+    juce::AudioBuffer<zlDSP::EngineFloatType> buffer(4, blockSize);
+    juce::AudioBuffer<zlDSP::EngineFloatType> source(4, blockSize);
+    zlTest::fillNoise(source);
+    // let parameters, structure switches and latency settle before measuring
+    for (int i = 0; i < static_cast<int>(sampleRate) / blockSize; ++i) {
+        buffer.makeCopyOf(source, true);
+        controller.process(buffer);
+    }
+
+    const auto name = std::string(structureNames[static_cast<size_t>(structure)])
+                      + "/" + routingNames[static_cast<size_t>(routing)]
+                      + "/" + dynamicNames[static_cast<size_t>(dynamic)]
+                      + "/" + zlBenchmark::formatRate(sampleRate)
+                      + "/" + std::to_string(blockSize);
+    BENCHMARK_ADVANCED(name.c_str())(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            buffer.makeCopyOf(source, true);
+            controller.process(buffer);
+            return buffer.getSample(0, 0);
+        });
+    };
+}
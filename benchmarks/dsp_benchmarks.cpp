@@ -0,0 +1,396 @@
+// Copyright (C) 2024 - zsliu98
+// This file is part of ZLEqualizer
+//
+// ZLEqualizer is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License Version 3 as published by the Free Software Foundation.
+//
+// ZLEqualizer is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License along with ZLEqualizer. If not, see <https://www.gnu.org/licenses/>.
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <numbers>
+
+#include "dsp/dsp.hpp"
+#include "dsp/interpolation/interpolation.hpp"
+#include "benchmark_helpers.hpp"
+
+namespace {
+    /**
+     * RBJ peak biquad coefficients {a0, a1, a2, b0, b1, b2}
+     */
+    std::array<double, 6> getPeakCoeff(const double freq, const double sampleRate,
+                                       const double gain, const double q) {
+        const auto A = std::pow(10.0, gain / 40.0);
+        const auto w0 = 2.0 * std::numbers::pi * freq / sampleRate;
+        const auto alpha = std::sin(w0) / (2.0 * q);
+        const auto cosW0 = std::cos(w0);
+        return {
+            1.0 + alpha / A, -2.0 * cosW0, 1.0 - alpha / A,
+            1.0 + alpha * A, -2.0 * cosW0, 1.0 - alpha * A
+        };
+    }
+}
+
+TEST_CASE("IIRBase process", "[iir]") {
+    const auto numChannels = GENERATE(1, 2);
+    const auto blockSize = GENERATE(from_range(zlBenchmark::blockSizes));
+    constexpr double sampleRate = 48000.0;
+
+    zlFilter::IIRBase<double> filter;
+    filter.prepare({sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels)});
+    filter.updateFromBiquad(getPeakCoeff(1000.0, sampleRate, 6.0, 0.707));
+    juce::AudioBuffer<double> buffer(numChannels, blockSize);
+    zlTest::fillNoise(buffer);
+
+    BENCHMARK_ADVANCED(("static/" + std::to_string(numChannels) + "ch/" + std::to_string(blockSize)).c_str())(
+        Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            auto block = juce::dsp::AudioBlock<double>(buffer);
+            filter.process(juce::dsp::ProcessContextReplacing<double>(block));
+            return buffer.getSample(0, 0);
+        });
+    };
+
+    BENCHMARK_ADVANCED(("ramp/" + std::to_string(numChannels) + "ch/" + std::to_string(blockSize)).c_str())(
+        Catch::Benchmark::Chronometer meter) {
+        bool flip = false;
+        meter.measure([&] {
+            flip = !flip;
+            filter.updateFromBiquad<true>(getPeakCoeff(1000.0, sampleRate, flip ? 6.0 : -6.0, 0.707));
+            auto block = juce::dsp::AudioBlock<double>(buffer);
+            filter.process(juce::dsp::ProcessContextReplacing<double>(block));
+            return buffer.getSample(0, 0);
+        });
+    };
+}
+
+TEST_CASE("IIRCascade process", "[iir]") {
+    const auto blockSize = GENERATE(from_range(zlBenchmark::blockSizes));
+    constexpr double sampleRate = 48000.0;
+    constexpr size_t sectionNum = 64;
+
+    std::array<zlFilter::IIRBase<double>, sectionNum> filters;
+    for (size_t i = 0; i < sectionNum; ++i) {
+        filters[i].prepare({sampleRate, static_cast<juce::uint32>(blockSize), 2});
+        filters[i].updateFromBiquad(getPeakCoeff(40.0 * std::pow(2.0, static_cast<double>(i % 16) * 0.6),
+                                                 sampleRate, i % 2 == 0 ? 3.0 : -3.0, 0.707));
+    }
+    zlFilter::IIRCascade<double, sectionNum> cascade;
+    juce::AudioBuffer<double> buffer(2, blockSize);
+    zlTest::fillNoise(buffer);
+
+    BENCHMARK_ADVANCED(("sequential/" + std::to_string(blockSize)).c_str())(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            auto block = juce::dsp::AudioBlock<double>(buffer);
+            const auto context = juce::dsp::ProcessContextReplacing<double>(block);
+            for (auto &f: filters) {
+                f.process(context);
+            }
+            return buffer.getSample(0, 0);
+        });
+    };
+
+    BENCHMARK_ADVANCED(("fused/" + std::to_string(blockSize)).c_str())(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            for (auto &f: filters) {
+                cascade.push(f, false);
+            }
+            cascade.process(buffer);
+            return buffer.getSample(0, 0);
+        });
+    };
+}
+
+TEST_CASE("Coefficient design", "[filter_design]") {
+    const auto order = GENERATE(2, 8);
+    constexpr double sampleRate = 48000.0;
+    constexpr size_t arraySize = 16;
+    std::array<std::array<double, 6>, arraySize> coeffs{};
+    // the gains of 16 static bands, which are designed again and again with the same parameters
+    size_t step = 0;
+    const auto getGain = [&]() {
+        step = (step + 1) % 16;
+        return static_cast<double>(step) * 0.75 - 6.0;
+    };
+
+    BENCHMARK(("direct/" + std::to_string(order)).c_str()) {
+        return zlFilter::FilterDesign::updateCoeffs<arraySize,
+            zlFilter::MartinCoeff::get1LowShelf, zlFilter::MartinCoeff::get1HighShelf,
+            zlFilter::MartinCoeff::get1TiltShelf,
+            zlFilter::MartinCoeff::get1LowPass, zlFilter::MartinCoeff::get1HighPass,
+            zlFilter::MartinCoeff::get2Peak,
+            zlFilter::MartinCoeff::get2LowShelf, zlFilter::MartinCoeff::get2HighShelf,
+            zlFilter::MartinCoeff::get2TiltShelf,
+            zlFilter::MartinCoeff::get2LowPass, zlFilter::MartinCoeff::get2HighPass,
+            zlFilter::MartinCoeff::get2BandPass, zlFilter::MartinCoeff::get2Notch>(
+            zlFilter::FilterType::peak, static_cast<size_t>(order), 1000.0, sampleRate, getGain(), 0.707, coeffs);
+    };
+
+    BENCHMARK(("cached/" + std::to_string(order)).c_str()) {
+        return zlFilter::MartinCoeff::updateCoeffs(zlFilter::FilterType::peak, static_cast<size_t>(order),
+                                                   1000.0, sampleRate, getGain(), 0.707, coeffs);
+    };
+}
+
+TEST_CASE("dB to gain", "[filter_design]") {
+    std::array<double, 256> dbs{};
+    for (size_t i = 0; i < dbs.size(); ++i) {
+        dbs[i] = std::round((static_cast<double>(i) * 0.237 - 30.0) * 100.0) * 0.01;
+    }
+
+    BENCHMARK("pow") {
+        double sum = 0.0;
+        for (const auto db: dbs) {
+            sum += zlFilter::db_to_gain(db);
+        }
+        return sum;
+    };
+
+    BENCHMARK("table") {
+        double sum = 0.0;
+        for (const auto db: dbs) {
+            sum += zlFilter::db_to_gain_fast(db);
+        }
+        return sum;
+    };
+}
+
+TEST_CASE("Peak design", "[filter_design]") {
+    constexpr size_t batchSize = zlDSP::bandNUM;
+    constexpr double sampleRate = 48000.0;
+    std::array<double, batchSize> freqs{}, gains{};
+    for (size_t i = 0; i < batchSize; ++i) {
+        freqs[i] = 20.0 * std::pow(2.0, static_cast<double>(i) * 0.3);
+        gains[i] = static_cast<double>(i % 13) - 6.0;
+    }
+
+    BENCHMARK("scalar") {
+        double sum = 0.0;
+        for (size_t i = 0; i < batchSize; ++i) {
+            const auto coeff = zlFilter::MartinCoeff::get2Peak(2 * std::numbers::pi * freqs[i] / sampleRate,
+                                                               zlFilter::db_to_gain(gains[i]), 0.707);
+            sum += coeff[3];
+        }
+        return sum;
+    };
+
+    zlFilter::BatchDesign<batchSize> batch;
+    BENCHMARK("batch") {
+        batch.clear();
+        for (size_t i = 0; i < batchSize; ++i) {
+            batch.push(freqs[i], sampleRate, gains[i], 0.707);
+        }
+        batch.design();
+        double sum = 0.0;
+        for (size_t i = 0; i < batchSize; ++i) {
+            sum += batch.getCoeff(i)[3];
+        }
+        return sum;
+    };
+}
+
+TEST_CASE("FIR frame process", "[fir]") {
+    const auto sampleRate = GENERATE(from_range(zlBenchmark::sampleRates));
+    const auto useMS = GENERATE(false, true);
+    constexpr size_t filterNum = zlDSP::bandNUM, filterSize = 16;
+    constexpr int blockSize = 512;
+
+    std::array<zlFilter::Ideal<double, filterSize>, filterNum> ideals;
+    std::array<zlContainer::FixedMaxSizeArray<size_t, filterNum>, 5> indices;
+    std::array<bool, filterNum> bypass{};
+    std::vector<std::complex<double> > ws;
+    std::array<zlFilter::FIR<double, filterNum, filterSize>, 5> firs{
+        zlFilter::FIR<double, filterNum, filterSize>{ideals, indices[0], bypass, ws},
+        zlFilter::FIR<double, filterNum, filterSize>{ideals, indices[1], bypass, ws},
+        zlFilter::FIR<double, filterNum, filterSize>{ideals, indices[2], bypass, ws},
+        zlFilter::FIR<double, filterNum, filterSize>{ideals, indices[3], bypass, ws},
+        zlFilter::FIR<double, filterNum, filterSize>{ideals, indices[4], bypass, ws}
+    };
+    zlFilter::CorrectionWorker worker;
+    zlFilter::StereoCorrection<double, zlFilter::FIR<double, filterNum, filterSize> > stage{firs, worker};
+
+    stage.prepare({sampleRate, static_cast<juce::uint32>(blockSize), 2});
+    ws.resize(firs[0].getCorrectionSize());
+    zlFilter::calculateWsForPrototype<double>(ws);
+    for (size_t i = 0; i < 8; ++i) {
+        auto &f = ideals[i];
+        f.prepare(sampleRate);
+        f.prepareResponseSize(firs[0].getCorrectionSize());
+        f.setFilterType(zlFilter::FilterType::peak);
+        f.setFreq(40.0 * std::pow(2.0, static_cast<double>(i) * 1.25));
+        f.setGain(i % 2 == 0 ? 6.0 : -6.0);
+        f.setQ(1.0);
+        indices[useMS ? 3 + i % 2 : 0].push(i);
+    }
+    stage.setGroups(false, useMS);
+    stage.setToUpdate();
+    worker.start();
+
+    juce::AudioBuffer<double> buffer(2, blockSize);
+    juce::AudioBuffer<double> source(2, blockSize);
+    zlTest::fillNoise(source);
+    // request the corrections, wait for the worker and process again so that they are swapped in before measuring
+    for (size_t round = 0; round < 2; ++round) {
+        for (size_t i = 0; i < static_cast<size_t>(stage.getLatency() / blockSize) + 1; ++i) {
+            buffer.makeCopyOf(source, true);
+            stage.process(buffer);
+        }
+        juce::Thread::sleep(100);
+    }
+
+    BENCHMARK_ADVANCED((std::string(useMS ? "ms/" : "stereo/") + zlBenchmark::formatRate(sampleRate)).c_str())(
+        Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            buffer.makeCopyOf(source, true);
+            stage.process(buffer);
+            return buffer.getSample(0, 0);
+        });
+    };
+}
+
+TEST_CASE("FIR frequency sweep", "[fir]") {
+    const auto sampleRate = GENERATE(from_range(zlBenchmark::sampleRates));
+    constexpr size_t filterNum = zlDSP::bandNUM, filterSize = 16;
+    constexpr int blockSize = 512;
+
+    std::array<zlFilter::Ideal<double, filterSize>, filterNum> ideals;
+    std::array<zlContainer::FixedMaxSizeArray<size_t, filterNum>, 5> indices;
+    std::array<bool, filterNum> bypass{};
+    std::vector<std::complex<double> > ws;
+    std::array<zlFilter::FIR<double, filterNum, filterSize>, 5> firs{
+        zlFilter::FIR<double, filterNum, filterSize>{ideals, indices[0], bypass, ws},
+        zlFilter::FIR<double, filterNum, filterSize>{ideals, indices[1], bypass, ws},
+        zlFilter::FIR<double, filterNum, filterSize>{ideals, indices[2], bypass, ws},
+        zlFilter::FIR<double, filterNum, filterSize>{ideals, indices[3], bypass, ws},
+        zlFilter::FIR<double, filterNum, filterSize>{ideals, indices[4], bypass, ws}
+    };
+    zlFilter::CorrectionWorker worker;
+    zlFilter::StereoCorrection<double, zlFilter::FIR<double, filterNum, filterSize> > stage{firs, worker};
+
+    stage.prepare({sampleRate, static_cast<juce::uint32>(blockSize), 2});
+    ws.resize(firs[0].getCorrectionSize());
+    zlFilter::calculateWsForPrototype<double>(ws);
+    for (size_t i = 0; i < 8; ++i) {
+        auto &f = ideals[i];
+        f.prepare(sampleRate);
+        f.prepareResponseSize(firs[0].getCorrectionSize());
+        f.setFilterType(zlFilter::FilterType::peak);
+        f.setFreq(40.0 * std::pow(2.0, static_cast<double>(i) * 1.25));
+        f.setGain(i % 2 == 0 ? 6.0 : -6.0);
+        f.setQ(1.0);
+        indices[0].push(i);
+    }
+    stage.setGroups(false, false);
+    stage.setToUpdate();
+
+    size_t sweepIdx = 0;
+    const auto sweep = [&]() {
+        sweepIdx = (sweepIdx + 1) % 256;
+        ideals[0].setFreq(40.0 * std::pow(2.0, static_cast<double>(sweepIdx) / 32.0));
+    };
+
+    // the correction which used to be built on the audio thread at every frame during a sweep
+    BENCHMARK_ADVANCED(("build/" + zlBenchmark::formatRate(sampleRate)).c_str())(
+        Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            sweep();
+            firs[0].syncRouting();
+            return firs[0].update();
+        });
+    };
+
+    // the audio thread only swaps in the matrices built by the worker
+    worker.start();
+    juce::AudioBuffer<double> buffer(2, blockSize);
+    juce::AudioBuffer<double> source(2, blockSize);
+    zlTest::fillNoise(source);
+    BENCHMARK_ADVANCED(("process/" + zlBenchmark::formatRate(sampleRate)).c_str())(
+        Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            sweep();
+            buffer.makeCopyOf(source, true);
+            stage.process(buffer);
+            return buffer.getSample(0, 0);
+        });
+    };
+}
+
+TEST_CASE("SpectrumHub analyze", "[fft]") {
+    const auto sampleRate = GENERATE(from_range(zlBenchmark::sampleRates));
+    constexpr int blockSize = 512;
+    const juce::dsp::ProcessSpec spec{sampleRate, static_cast<juce::uint32>(blockSize), 2};
+
+    zlFFT::SpectrumHub<double> hub;
+    zlFFT::PrePostFFTAnalyzer<double> analyzer(hub);
+    hub.addConsumer(analyzer);
+    hub.prepare(spec);
+    analyzer.setSideON(true);
+    analyzer.setON(true);
+    std::array<juce::AudioBuffer<double>, 3> buffers{
+        juce::AudioBuffer<double>(2, blockSize), juce::AudioBuffer<double>(2, blockSize),
+        juce::AudioBuffer<double>(2, blockSize)
+    };
+    for (size_t i = 0; i < buffers.size(); ++i) {
+        zlTest::fillNoise(buffers[i], static_cast<unsigned int>(i));
+    }
+
+    BENCHMARK_ADVANCED(zlBenchmark::formatRate(sampleRate).c_str())(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            hub.updateSignals();
+            hub.pushPreBuffer(buffers[0]);
+            hub.pushPostBuffer(buffers[1]);
+            hub.pushSideBuffer(buffers[2]);
+            hub.process();
+            hub.analyze();
+        });
+    };
+}
+
+TEST_CASE("SeqMakima eval", "[interpolation]") {
+    const auto inputNum = GENERATE(64, 512, 4096);
+    constexpr size_t outputNum = 251;
+
+    std::vector<float> xs(static_cast<size_t>(inputNum)), ys(static_cast<size_t>(inputNum));
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> dist(-72.f, 0.f);
+    for (size_t i = 0; i < xs.size(); ++i) {
+        xs[i] = 10.f * std::pow(2200.f, static_cast<float>(i) / static_cast<float>(xs.size() - 1));
+        ys[i] = dist(gen);
+    }
+    std::vector<float> outXs(outputNum), outYs(outputNum);
+    for (size_t i = 0; i < outputNum; ++i) {
+        outXs[i] = 10.f * std::pow(2200.f, static_cast<float>(i) / static_cast<float>(outputNum - 1));
+    }
+    zlInterpolation::SeqMakima<float> makima(xs.data(), ys.data(), xs.size(), 0.f, 0.f);
+
+    BENCHMARK(std::to_string(inputNum).c_str()) {
+        makima.prepare();
+        makima.eval(outXs.data(), outYs.data(), outYs.size());
+        return outYs[0];
+    };
+}
+
+TEST_CASE("EqMatchOptimizer run", "[eq_match]") {
+    constexpr size_t diffsSize = 251;
+    // a smooth target curve with a low shelf, a presence peak and a high cut
+    std::vector<double> diffs(diffsSize);
+    for (size_t i = 0; i < diffsSize; ++i) {
+        const auto x = static_cast<double>(i) / static_cast<double>(diffsSize - 1);
+        diffs[i] = 4.0 / (1.0 + std::exp(30.0 * (x - .2)))
+                   + 3.0 * std::exp(-std::pow((x - .65) / .05, 2.0))
+                   - 8.0 / (1.0 + std::exp(-40.0 * (x - .9)));
+    }
+
+    BENCHMARK_ADVANCED("deterministic")(Catch::Benchmark::Chronometer meter) {
+        auto optimizer = std::make_unique<zlEqMatch::EqMatchOptimizer<16> >();
+        optimizer->setDiffs(diffs.data(), diffs.size());
+        meter.measure([&] {
+            optimizer->setDiffs(diffs.data(), diffs.size());
+            optimizer->runDeterministic();
+            return optimizer->getMSE()[0];
+        });
+    };
+}
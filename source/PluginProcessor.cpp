@@ -66,7 +66,9 @@ bool PluginProcessor::isMidiEffect() const {
 }
 
 double PluginProcessor::getTailLengthSeconds() const {
-    return 0.0;
+    const auto sampleRate = getSampleRate();
+    if (sampleRate <= 0.0) return 0.0;
+    return static_cast<double>(controller.getTailSamples()) / sampleRate;
 }
 
 int PluginProcessor::getNumPrograms() {
@@ -93,16 +95,22 @@ void PluginProcessor::changeProgramName(int index, const juce::String &newName)
 
 //==============================================================================
 void PluginProcessor::prepareToPlay(const double sampleRate, const int samplesPerBlock) {
+    // determine current channel layout
+    updateChannelLayout();
     // prepare to play
+    // with a mono main bus and a mono (or no) aux bus, the engine processes a single main & side channel
+    const auto isMono = channelLayout == ChannelLayout::main1aux0 || channelLayout == ChannelLayout::main1aux1;
     const juce::dsp::ProcessSpec spec{
         sampleRate,
         static_cast<juce::uint32>(samplesPerBlock),
-        2
+        static_cast<juce::uint32>(isMono ? 1 : 2)
     };
-    doubleBuffer.setSize(4, samplesPerBlock);
-    doubleBuffer.clear();
+    engineBuffer.setSize(4, samplesPerBlock);
+    engineBuffer.clear();
     controller.prepare(spec);
-    // determine current channel layout
+}
+
+void PluginProcessor::updateChannelLayout() {
     const auto *mainBus = getBus(true, 0);
     const auto *auxBus = getBus(true, 1);
     channelLayout = ChannelLayout::invalid;
@@ -153,124 +161,168 @@ void PluginProcessor::processBlock(juce::AudioBuffer<float> &buffer,
                                    juce::MidiBuffer &midiMessages) {
     juce::ignoreUnused(midiMessages);
     juce::ScopedNoDenormals noDenormals;
-    doubleBuffer.setSize(4, buffer.getNumSamples(), false, false, true);
+    const zlChore::RTAudit::ScopedRealtime scopedRealtime;
+    processEngine(buffer);
+}
+
+void PluginProcessor::processBlock(juce::AudioBuffer<double> &buffer, juce::MidiBuffer &midiMessages) {
+    juce::ignoreUnused(midiMessages);
+    juce::ScopedNoDenormals noDenormals;
+    const zlChore::RTAudit::ScopedRealtime scopedRealtime;
+    processEngine(buffer);
+}
+
+void PluginProcessor::processBlockBypassed(juce::AudioBuffer<float> &buffer, juce::MidiBuffer &midiMessages) {
+    juce::ignoreUnused(buffer, midiMessages);
+}
+
+void PluginProcessor::processBlockBypassed(juce::AudioBuffer<double> &buffer, juce::MidiBuffer &midiMessages) {
+    juce::ignoreUnused(buffer, midiMessages);
+}
+
+bool PluginProcessor::hasEditor() const {
+    return true;
+}
+
+juce::AudioProcessorEditor *PluginProcessor::createEditor() {
+    return new PluginEditor(*this);
+}
+
+void PluginProcessor::getStateInformation(juce::MemoryBlock &destData) {
+    auto tempTree = juce::ValueTree("ZLEqualizerParaState");
+    tempTree.appendChild(parameters.copyState(), nullptr);
+    tempTree.appendChild(parametersNA.copyState(), nullptr);
+    const std::unique_ptr<juce::XmlElement> xml(tempTree.createXml());
+    copyXmlToBinary(*xml, destData);
+}
+
+void PluginProcessor::setStateInformation(const void *data, int sizeInBytes) {
+    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
+    if (xmlState != nullptr && xmlState->hasTagName("ZLEqualizerParaState")) {
+        const auto tempTree = juce::ValueTree::fromXml(*xmlState);
+        parameters.replaceState(tempTree.getChildWithName(parameters.state.getType()));
+        parametersNA.replaceState(tempTree.getChildWithName(parametersNA.state.getType()));
+    }
+}
+
+template<typename FloatType>
+void PluginProcessor::processEngine(juce::AudioBuffer<FloatType> &buffer) {
+    if constexpr (std::is_same_v<FloatType, zlDSP::EngineFloatType>) {
+        processInPlace(buffer);
+    } else {
+        processConverted(buffer);
+    }
+}
+
+template<typename FloatType>
+void PluginProcessor::processInPlace(juce::AudioBuffer<FloatType> &buffer) {
+    // the main channels are processed in the host buffer, only the missing channels are copied
+    engineBuffer.setSize(4, buffer.getNumSamples(), false, false, true);
+    auto *const *host = buffer.getArrayOfWritePointers();
+    auto *const *scratch = engineBuffer.getArrayOfWritePointers();
+    std::array<FloatType *, 4> pointers{};
+    int numChannels = 4;
     switch (channelLayout) {
         case ChannelLayout::main1aux0: {
-            doubleBufferCopyFrom(0, buffer, 0);
-            doubleBufferCopyFrom(1, buffer, 0);
-            doubleBufferCopyFrom(2, buffer, 0);
-            doubleBufferCopyFrom(3, buffer, 0);
-            controller.process(doubleBuffer);
-            doubleBufferCopyTo(0, buffer, 0);
+            // mono engine: {main, side}
+            engineBufferCopyFrom(1, buffer, 0);
+            pointers = {host[0], scratch[1], nullptr, nullptr};
+            numChannels = 2;
             break;
         }
         case ChannelLayout::main1aux1: {
-            doubleBufferCopyFrom(0, buffer, 0);
-            doubleBufferCopyFrom(1, buffer, 0);
-            doubleBufferCopyFrom(2, buffer, 1);
-            doubleBufferCopyFrom(3, buffer, 1);
-            controller.process(doubleBuffer);
-            doubleBufferCopyTo(0, buffer, 0);
+            // mono engine: {main, side}
+            pointers = {host[0], host[1], nullptr, nullptr};
+            numChannels = 2;
             break;
         }
         case ChannelLayout::main1aux2: {
-            doubleBufferCopyFrom(0, buffer, 0);
-            doubleBufferCopyFrom(1, buffer, 0);
-            doubleBufferCopyFrom(2, buffer, 1);
-            doubleBufferCopyFrom(3, buffer, 2);
-            controller.process(doubleBuffer);
-            doubleBufferCopyTo(0, buffer, 0);
+            engineBufferCopyFrom(1, buffer, 0);
+            pointers = {host[0], scratch[1], host[1], host[2]};
             break;
         }
         case ChannelLayout::main2aux0: {
-            doubleBufferCopyFrom(0, buffer, 0);
-            doubleBufferCopyFrom(1, buffer, 1);
-            doubleBufferCopyFrom(2, buffer, 0);
-            doubleBufferCopyFrom(3, buffer, 1);
-            controller.process(doubleBuffer);
-            doubleBufferCopyTo(0, buffer, 0);
-            doubleBufferCopyTo(1, buffer, 1);
+            engineBufferCopyFrom(2, buffer, 0);
+            engineBufferCopyFrom(3, buffer, 1);
+            pointers = {host[0], host[1], scratch[2], scratch[3]};
             break;
         }
         case ChannelLayout::main2aux1: {
-            doubleBufferCopyFrom(0, buffer, 0);
-            doubleBufferCopyFrom(1, buffer, 1);
-            doubleBufferCopyFrom(2, buffer, 2);
-            doubleBufferCopyFrom(3, buffer, 2);
-            controller.process(doubleBuffer);
-            doubleBufferCopyTo(0, buffer, 0);
-            doubleBufferCopyTo(1, buffer, 1);
+            engineBufferCopyFrom(3, buffer, 2);
+            pointers = {host[0], host[1], host[2], scratch[3]};
             break;
         }
         case ChannelLayout::main2aux2: {
-            doubleBufferCopyFrom(0, buffer, 0);
-            doubleBufferCopyFrom(1, buffer, 1);
-            doubleBufferCopyFrom(2, buffer, 2);
-            doubleBufferCopyFrom(3, buffer, 3);
-            controller.process(doubleBuffer);
-            doubleBufferCopyTo(0, buffer, 0);
-            doubleBufferCopyTo(1, buffer, 1);
+            pointers = {host[0], host[1], host[2], host[3]};
             break;
         }
         case ChannelLayout::invalid: {
+            return;
         }
     }
+    juce::AudioBuffer<FloatType> block(pointers.data(), numChannels, buffer.getNumSamples());
+    controller.process(block);
 }
 
-void PluginProcessor::processBlock(juce::AudioBuffer<double> &buffer, juce::MidiBuffer &midiMessages) {
-    juce::ignoreUnused(midiMessages);
-    juce::ScopedNoDenormals noDenormals;
-    doubleBuffer.setSize(4, buffer.getNumSamples(), false, false, true);
+template<typename FloatType>
+void PluginProcessor::processConverted(juce::AudioBuffer<FloatType> &buffer) {
+    engineBuffer.setSize(4, buffer.getNumSamples(), false, false, true);
     switch (channelLayout) {
         case ChannelLayout::main1aux0: {
-            doubleBufferCopyFrom(0, buffer, 0);
-            doubleBufferCopyFrom(1, buffer, 0);
-            doubleBufferCopyFrom(2, buffer, 0);
-            doubleBufferCopyFrom(3, buffer, 0);
-            controller.process(doubleBuffer);
-            doubleBufferCopyTo(0, buffer, 0);
+            engineBufferCopyFrom(0, buffer, 0);
+            engineBufferCopyFrom(1, buffer, 0);
+            juce::AudioBuffer<zlDSP::EngineFloatType> block(engineBuffer.getArrayOfWritePointers(), 2,
+                                                            buffer.getNumSamples());
+            controller.process(block);
+            engineBufferCopyTo(0, buffer, 0);
             break;
         }
         case ChannelLayout::main1aux1: {
-            doubleBufferCopyFrom(0, buffer, 0);
-            doubleBufferCopyFrom(1, buffer, 0);
-            doubleBufferCopyFrom(2, buffer, 1);
-            doubleBufferCopyFrom(3, buffer, 1);
-            controller.process(doubleBuffer);
-            doubleBufferCopyTo(0, buffer, 0);
+            engineBufferCopyFrom(0, buffer, 0);
+            engineBufferCopyFrom(1, buffer, 1);
+            juce::AudioBuffer<zlDSP::EngineFloatType> block(engineBuffer.getArrayOfWritePointers(), 2,
+                                                            buffer.getNumSamples());
+            controller.process(block);
+            engineBufferCopyTo(0, buffer, 0);
             break;
         }
         case ChannelLayout::main1aux2: {
-            doubleBufferCopyFrom(0, buffer, 0);
-            doubleBufferCopyFrom(1, buffer, 0);
-            doubleBufferCopyFrom(2, buffer, 1);
-            doubleBufferCopyFrom(3, buffer, 2);
-            controller.process(doubleBuffer);
-            doubleBufferCopyTo(0, buffer, 0);
+            engineBufferCopyFrom(0, buffer, 0);
+            engineBufferCopyFrom(1, buffer, 0);
+            engineBufferCopyFrom(2, buffer, 1);
+            engineBufferCopyFrom(3, buffer, 2);
+            controller.process(engineBuffer);
+            engineBufferCopyTo(0, buffer, 0);
             break;
         }
         case ChannelLayout::main2aux0: {
-            doubleBufferCopyFrom(0, buffer, 0);
-            doubleBufferCopyFrom(1, buffer, 1);
-            doubleBufferCopyFrom(2, buffer, 0);
-            doubleBufferCopyFrom(3, buffer, 1);
-            controller.process(doubleBuffer);
-            doubleBufferCopyTo(0, buffer, 0);
-            doubleBufferCopyTo(1, buffer, 1);
+            engineBufferCopyFrom(0, buffer, 0);
+            engineBufferCopyFrom(1, buffer, 1);
+            engineBufferCopyFrom(2, buffer, 0);
+            engineBufferCopyFrom(3, buffer, 1);
+            controller.process(engineBuffer);
+            engineBufferCopyTo(0, buffer, 0);
+            engineBufferCopyTo(1, buffer, 1);
             break;
         }
         case ChannelLayout::main2aux1: {
-            doubleBufferCopyFrom(0, buffer, 0);
-            doubleBufferCopyFrom(1, buffer, 1);
-            doubleBufferCopyFrom(2, buffer, 2);
-            doubleBufferCopyFrom(3, buffer, 2);
-            controller.process(doubleBuffer);
-            doubleBufferCopyTo(0, buffer, 0);
-            doubleBufferCopyTo(1, buffer, 1);
+            engineBufferCopyFrom(0, buffer, 0);
+            engineBufferCopyFrom(1, buffer, 1);
+            engineBufferCopyFrom(2, buffer, 2);
+            engineBufferCopyFrom(3, buffer, 2);
+            controller.process(engineBuffer);
+            engineBufferCopyTo(0, buffer, 0);
+            engineBufferCopyTo(1, buffer, 1);
             break;
         }
         case ChannelLayout::main2aux2: {
-            controller.process(buffer);
+            engineBufferCopyFrom(0, buffer, 0);
+            engineBufferCopyFrom(1, buffer, 1);
+            engineBufferCopyFrom(2, buffer, 2);
+            engineBufferCopyFrom(3, buffer, 3);
+            controller.process(engineBuffer);
+            engineBufferCopyTo(0, buffer, 0);
+            engineBufferCopyTo(1, buffer, 1);
             break;
         }
         case ChannelLayout::invalid: {
@@ -278,71 +330,34 @@ void PluginProcessor::processBlock(juce::AudioBuffer<double> &buffer, juce::Midi
     }
 }
 
-void PluginProcessor::processBlockBypassed(juce::AudioBuffer<float> &buffer, juce::MidiBuffer &midiMessages) {
-    juce::ignoreUnused(buffer, midiMessages);
-}
-
-void PluginProcessor::processBlockBypassed(juce::AudioBuffer<double> &buffer, juce::MidiBuffer &midiMessages) {
-    juce::ignoreUnused(buffer, midiMessages);
-}
-
-bool PluginProcessor::hasEditor() const {
-    return true;
-}
-
-juce::AudioProcessorEditor *PluginProcessor::createEditor() {
-    return new PluginEditor(*this);
-}
-
-void PluginProcessor::getStateInformation(juce::MemoryBlock &destData) {
-    auto tempTree = juce::ValueTree("ZLEqualizerParaState");
-    tempTree.appendChild(parameters.copyState(), nullptr);
-    tempTree.appendChild(parametersNA.copyState(), nullptr);
-    const std::unique_ptr<juce::XmlElement> xml(tempTree.createXml());
-    copyXmlToBinary(*xml, destData);
-}
-
-void PluginProcessor::setStateInformation(const void *data, int sizeInBytes) {
-    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
-    if (xmlState != nullptr && xmlState->hasTagName("ZLEqualizerParaState")) {
-        const auto tempTree = juce::ValueTree::fromXml(*xmlState);
-        parameters.replaceState(tempTree.getChildWithName(parameters.state.getType()));
-        parametersNA.replaceState(tempTree.getChildWithName(parametersNA.state.getType()));
-    }
-}
-
-void PluginProcessor::doubleBufferCopyFrom(const int destChan,
-                                           const juce::AudioBuffer<float> &buffer, const int srcChan) {
-    auto *dest = doubleBuffer.getWritePointer(destChan);
+template<typename FloatType>
+void PluginProcessor::engineBufferCopyFrom(const int destChan,
+                                           const juce::AudioBuffer<FloatType> &buffer, const int srcChan) {
+    auto *dest = engineBuffer.getWritePointer(destChan);
     auto *src = buffer.getReadPointer(srcChan);
-    for (int i = 0; i < buffer.getNumSamples(); ++i) {
-        dest[i] = static_cast<double>(src[i]);
+    if constexpr (std::is_same_v<FloatType, zlDSP::EngineFloatType>) {
+        juce::FloatVectorOperations::copy(dest, src, buffer.getNumSamples());
+    } else {
+        for (int i = 0; i < buffer.getNumSamples(); ++i) {
+            dest[i] = static_cast<zlDSP::EngineFloatType>(src[i]);
+        }
     }
 }
 
-void PluginProcessor::doubleBufferCopyFrom(const int destChan,
-                                           const juce::AudioBuffer<double> &buffer, const int srcChan) {
-    juce::FloatVectorOperations::copy(doubleBuffer.getWritePointer(destChan),
-                                      buffer.getReadPointer(srcChan),
-                                      buffer.getNumSamples());
-}
-
-void PluginProcessor::doubleBufferCopyTo(const int srcChan,
-                                         juce::AudioBuffer<float> &buffer, int const destChan) const {
-    auto *src = doubleBuffer.getReadPointer(srcChan);
+template<typename FloatType>
+void PluginProcessor::engineBufferCopyTo(const int srcChan,
+                                         juce::AudioBuffer<FloatType> &buffer, const int destChan) const {
+    auto *src = engineBuffer.getReadPointer(srcChan);
     auto *dest = buffer.getWritePointer(destChan);
-    for (int i = 0; i < buffer.getNumSamples(); ++i) {
-        dest[i] = static_cast<float>(src[i]);
+    if constexpr (std::is_same_v<FloatType, zlDSP::EngineFloatType>) {
+        juce::FloatVectorOperations::copy(dest, src, buffer.getNumSamples());
+    } else {
+        for (int i = 0; i < buffer.getNumSamples(); ++i) {
+            dest[i] = static_cast<FloatType>(src[i]);
+        }
     }
 }
 
-void PluginProcessor::doubleBufferCopyTo(const int srcChan,
-                                         juce::AudioBuffer<double> &buffer, int const destChan) const {
-    juce::FloatVectorOperations::copy(buffer.getWritePointer(destChan),
-                                      doubleBuffer.getReadPointer(srcChan),
-                                      buffer.getNumSamples());
-}
-
 juce::AudioProcessor *JUCE_CALLTYPE
 
 createPluginFilter() {
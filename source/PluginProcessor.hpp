@@ -72,18 +72,20 @@ public:
 
     void setStateInformation(const void *data, int sizeInBytes) override;
 
-    bool supportsDoublePrecisionProcessing() const override { return true; }
+    bool supportsDoublePrecisionProcessing() const override {
+        return std::is_same_v<zlDSP::EngineFloatType, double>;
+    }
 
-    inline zlDSP::Controller<double> &getController() { return controller; }
+    inline zlDSP::Controller<zlDSP::EngineFloatType> &getController() { return controller; }
 
-    inline zlDSP::FiltersAttach<double> &getFiltersAttach() { return filtersAttach; }
+    inline zlDSP::FiltersAttach<zlDSP::EngineFloatType> &getFiltersAttach() { return filtersAttach; }
 
 private:
-    zlDSP::Controller<double> controller;
-    zlDSP::FiltersAttach<double> filtersAttach;
-    zlDSP::SoloAttach<double> soloAttach;
-    zlDSP::ChoreAttach<double> choreAttach;
-    juce::AudioBuffer<double> doubleBuffer;
+    zlDSP::Controller<zlDSP::EngineFloatType> controller;
+    zlDSP::FiltersAttach<zlDSP::EngineFloatType> filtersAttach;
+    zlDSP::SoloAttach<zlDSP::EngineFloatType> soloAttach;
+    zlDSP::ChoreAttach<zlDSP::EngineFloatType> choreAttach;
+    juce::AudioBuffer<zlDSP::EngineFloatType> engineBuffer;
 
     enum ChannelLayout {
         main1aux0, main1aux1, main1aux2,
@@ -92,13 +94,22 @@ private:
     };
     ChannelLayout channelLayout{invalid};
 
-    void doubleBufferCopyFrom(int destChan, const juce::AudioBuffer<float> &buffer, int srcChan);
+    void updateChannelLayout();
 
-    void doubleBufferCopyTo(int srcChan, juce::AudioBuffer<float> &buffer, int destChan) const;
+    template<typename FloatType>
+    void processEngine(juce::AudioBuffer<FloatType> &buffer);
 
-    void doubleBufferCopyFrom(int destChan, const juce::AudioBuffer<double> &buffer, int srcChan);
+    template<typename FloatType>
+    void processInPlace(juce::AudioBuffer<FloatType> &buffer);
 
-    void doubleBufferCopyTo(int srcChan, juce::AudioBuffer<double> &buffer, int destChan) const;
+    template<typename FloatType>
+    void processConverted(juce::AudioBuffer<FloatType> &buffer);
+
+    template<typename FloatType>
+    void engineBufferCopyFrom(int destChan, const juce::AudioBuffer<FloatType> &buffer, int srcChan);
+
+    template<typename FloatType>
+    void engineBufferCopyTo(int srcChan, juce::AudioBuffer<FloatType> &buffer, int destChan) const;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PluginProcessor)
 };
@@ -12,7 +12,6 @@
 namespace zlAudioBuffer {
     template<typename FloatType>
     FixedAudioBuffer<FloatType>::FixedAudioBuffer(int subBufferSize) :
-            inputBuffer(2, 441), outputBuffer(2, 441),
             subSpec{44100, 441, 2},
             mainSpec{44100, 441, 2} {
         setSubBufferSize(subBufferSize);
@@ -20,14 +19,21 @@ namespace zlAudioBuffer {
 
     template<typename FloatType>
     void FixedAudioBuffer<FloatType>::clear() {
-        inputBuffer.clear();
-        outputBuffer.clear();
-        subBuffer.clear();
+        hostNum = 0;
+        hostPos = 0;
+        subNum = 0;
+        isSubInScratch = false;
+        carryNum = 0;
+        for (auto &buffer: delayBuffers) {
+            buffer.clear();
+        }
+        // put latency samples
+        delayNum = static_cast<int>(latencyInSamples.load());
     }
 
     template<typename FloatType>
     void FixedAudioBuffer<FloatType>::setSubBufferSize(int subBufferSize) {
-        clear();
+        jassert(subBufferSize > 0);
         // init internal spec
         subSpec = mainSpec;
         subSpec.maximumBlockSize = static_cast<juce::uint32>(subBufferSize);
@@ -36,24 +42,16 @@ namespace zlAudioBuffer {
         } else {
             latencyInSamples.store(0);
         }
-        // resize subBuffer, inputBuffer and outputBuffer
-        subBuffer.setSize(static_cast<int>(subSpec.numChannels),
-                          static_cast<int>(subSpec.maximumBlockSize));
-        inputBuffer.setSize(static_cast<int>(mainSpec.numChannels),
-                            static_cast<int>(mainSpec.maximumBlockSize) + subBufferSize);
-        outputBuffer.setSize(static_cast<int>(mainSpec.numChannels),
-                             static_cast<int>(mainSpec.maximumBlockSize) + subBufferSize);
-        // put latency samples
-        if (subBufferSize > 1) {
-            juce::AudioBuffer<FloatType> zeroBuffer(inputBuffer.getNumChannels(), subBufferSize);
-            for (int channel = 0; channel < zeroBuffer.getNumChannels(); ++channel) {
-                auto *channelData = zeroBuffer.getWritePointer(channel);
-                for (int index = 0; index < subBufferSize; ++index) {
-                    channelData[index] = 0;
-                }
-            }
-            inputBuffer.push(zeroBuffer, subBufferSize);
+        // resize pointers, scratch, carry and delay buffers
+        const auto numChannels = static_cast<int>(mainSpec.numChannels);
+        hostPointers.resize(mainSpec.numChannels);
+        subPointers.resize(mainSpec.numChannels);
+        scratchBuffer.setSize(numChannels, static_cast<int>(getMaxSubBufferSize()));
+        carryBuffer.setSize(numChannels, subBufferSize);
+        for (auto &buffer: delayBuffers) {
+            buffer.setSize(numChannels, static_cast<int>(latencyInSamples.load() + mainSpec.maximumBlockSize));
         }
+        clear();
     }
 
     template<typename FloatType>
@@ -63,55 +61,144 @@ namespace zlAudioBuffer {
 
     template<typename FloatType>
     void FixedAudioBuffer<FloatType>::pushBuffer(juce::AudioBuffer<FloatType> &buffer) {
-        inputBuffer.push(buffer);
+        pushBlock(juce::dsp::AudioBlock<FloatType>(buffer));
     }
 
     template<typename FloatType>
     void FixedAudioBuffer<FloatType>::pushBlock(juce::dsp::AudioBlock<FloatType> block) {
-        inputBuffer.push(block);
+        jassert(block.getNumChannels() >= hostPointers.size());
+        jassert(block.getNumSamples() <= mainSpec.maximumBlockSize);
+        for (size_t channel = 0; channel < hostPointers.size(); ++channel) {
+            hostPointers[channel] = block.getChannelPointer(channel);
+        }
+        hostNum = static_cast<int>(block.getNumSamples());
+        hostPos = 0;
     }
 
     template<typename FloatType>
     void FixedAudioBuffer<FloatType>::popSubBuffer() {
-        inputBuffer.pop(subBuffer);
+        const auto subBufferSize = static_cast<int>(subSpec.maximumBlockSize);
+        if (carryNum > 0) {
+            popScratchSubBuffer(subBufferSize - carryNum);
+        } else {
+            for (size_t channel = 0; channel < subPointers.size(); ++channel) {
+                subPointers[channel] = hostPointers[channel] + hostPos;
+            }
+            subNum = subBufferSize;
+            hostPos += subBufferSize;
+        }
+    }
+
+    template<typename FloatType>
+    void FixedAudioBuffer<FloatType>::popWholeSubBuffer() {
+        if (carryNum > 0) {
+            popScratchSubBuffer(hostNum - hostPos);
+        } else {
+            for (size_t channel = 0; channel < subPointers.size(); ++channel) {
+                subPointers[channel] = hostPointers[channel] + hostPos;
+            }
+            subNum = hostNum - hostPos;
+            hostPos = hostNum;
+        }
+    }
+
+    template<typename FloatType>
+    void FixedAudioBuffer<FloatType>::popScratchSubBuffer(const int hostTakeNum) {
+        // the carried-over samples followed by the first samples of the block
+        for (size_t channel = 0; channel < subPointers.size(); ++channel) {
+            const auto c = static_cast<int>(channel);
+            scratchBuffer.copyFrom(c, 0, carryBuffer, c, 0, carryNum);
+            scratchBuffer.copyFrom(c, carryNum, hostPointers[channel] + hostPos, hostTakeNum);
+            subPointers[channel] = scratchBuffer.getWritePointer(c);
+        }
+        subNum = carryNum + hostTakeNum;
+        isSubInScratch = true;
+        scratchCarryNum = carryNum;
+        scratchHostStart = hostPos;
+        hostPos += hostTakeNum;
+        carryNum = 0;
     }
 
     template<typename FloatType>
     void FixedAudioBuffer<FloatType>::pushSubBuffer() {
-        outputBuffer.push(subBuffer);
+        if (!isSubInScratch) { return; }
+        // the carried-over part goes to the output, the rest goes back to the block
+        auto &delayBuffer = delayBuffers[delayIdx];
+        for (size_t channel = 0; channel < subPointers.size(); ++channel) {
+            const auto c = static_cast<int>(channel);
+            delayBuffer.copyFrom(c, delayNum, scratchBuffer, c, 0, scratchCarryNum);
+            juce::FloatVectorOperations::copy(hostPointers[channel] + scratchHostStart,
+                                              scratchBuffer.getReadPointer(c, scratchCarryNum),
+                                              subNum - scratchCarryNum);
+        }
+        delayNum += scratchCarryNum;
+        isSubInScratch = false;
     }
 
     template<typename FloatType>
     void FixedAudioBuffer<FloatType>::popBuffer(juce::AudioBuffer<FloatType> &buffer, bool write) {
-        if (write) {
-            outputBuffer.pop(buffer);
-        } else {
-            outputBuffer.pop(buffer.getNumSamples());
-        }
+        popBlock(juce::dsp::AudioBlock<FloatType>(buffer), write);
     }
 
     template<typename FloatType>
     void FixedAudioBuffer<FloatType>::popBlock(juce::dsp::AudioBlock<FloatType> block, bool write) {
-        if (write) {
-            outputBuffer.pop(block);
+        jassert(static_cast<int>(block.getNumSamples()) == hostNum);
+        juce::ignoreUnused(block);
+        if (hostNum == 0) { return; }
+        // carry over the samples which do not fill a sub buffer
+        const auto remainNum = hostNum - hostPos;
+        for (size_t channel = 0; channel < hostPointers.size(); ++channel) {
+            carryBuffer.copyFrom(static_cast<int>(channel), carryNum, hostPointers[channel] + hostPos, remainNum);
+        }
+        carryNum += remainNum;
+        // the output is the delayed samples followed by the processed samples of this block
+        const auto processedNum = hostPos;
+        const auto newDelayNum = delayNum + processedNum - hostNum;
+        jassert(newDelayNum >= 0);
+        auto &delayBuffer = delayBuffers[delayIdx];
+        if (delayNum >= hostNum) {
+            for (size_t channel = 0; channel < hostPointers.size(); ++channel) {
+                const auto c = static_cast<int>(channel);
+                auto *delayData = delayBuffer.getWritePointer(c);
+                auto *hostData = hostPointers[channel];
+                std::copy(hostData, hostData + processedNum, delayData + delayNum);
+                if (write) {
+                    std::copy(delayData, delayData + hostNum, hostData);
+                }
+                std::copy(delayData + hostNum, delayData + hostNum + newDelayNum, delayData);
+            }
         } else {
-            outputBuffer.pop(static_cast<int>(block.getNumSamples()));
+            auto &nextDelayBuffer = delayBuffers[1 - delayIdx];
+            for (size_t channel = 0; channel < hostPointers.size(); ++channel) {
+                const auto c = static_cast<int>(channel);
+                auto *delayData = delayBuffer.getWritePointer(c);
+                auto *hostData = hostPointers[channel];
+                std::copy(hostData + hostNum - delayNum, hostData + processedNum, nextDelayBuffer.getWritePointer(c));
+                if (write && delayNum > 0) {
+                    std::copy_backward(hostData, hostData + hostNum - delayNum, hostData + hostNum);
+                    std::copy(delayData, delayData + delayNum, hostData);
+                }
+            }
+            delayIdx = 1 - delayIdx;
         }
+        delayNum = newDelayNum;
+        hostNum = 0;
+        hostPos = 0;
     }
 
     template<typename FloatType>
     juce::AudioBuffer<FloatType> FixedAudioBuffer<FloatType>::getSubBufferChannels(
             int channelOffset, int numChannels) {
         return juce::AudioBuffer<FloatType>(
-                subBuffer.getArrayOfWritePointers() + channelOffset,
-                numChannels, subBuffer.getNumSamples());
+                subPointers.data() + channelOffset, numChannels, subNum);
     }
 
     template<typename FloatType>
     juce::dsp::AudioBlock<FloatType> FixedAudioBuffer<FloatType>::getSubBlockChannels(int channelOffset,
                                                                                       int numChannels) {
-        return juce::dsp::AudioBlock<FloatType>(subBuffer).getSubsetChannelBlock(static_cast<size_t>(channelOffset),
-                                                                                 static_cast<size_t>(numChannels));
+        return juce::dsp::AudioBlock<FloatType>(subPointers.data() + channelOffset,
+                                                static_cast<size_t>(numChannels),
+                                                static_cast<size_t>(subNum));
     }
 
     template
@@ -119,4 +206,4 @@ namespace zlAudioBuffer {
 
     template
     class FixedAudioBuffer<double>;
-}
\ No newline at end of file
+}
@@ -12,14 +12,18 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
-#include "fifo_audio_buffer.hpp"
 
 namespace zlAudioBuffer {
+    /**
+     * split blocks of any size into sub buffers of a fixed size, with a latency of one sub buffer
+     * sub buffers are handed out as views into the pushed block, so aligned samples are processed in place
+     * only the sub buffer which straddles two blocks is assembled in a scratch buffer from the carried-over remainder
+     * the latency itself costs a single in-place shift of the block when it is popped
+     * @tparam FloatType
+     */
     template<typename FloatType>
     class FixedAudioBuffer {
     public:
-        juce::AudioBuffer<FloatType> subBuffer;
-
         explicit FixedAudioBuffer(int subBufferSize = 1);
 
         void clear();
@@ -30,36 +34,79 @@ namespace zlAudioBuffer {
 
         void pushBuffer(juce::AudioBuffer<FloatType> &buffer);
 
+        /**
+         * start a block, the block must stay valid until popBlock()
+         */
         void pushBlock(juce::dsp::AudioBlock<FloatType> block);
 
         void popSubBuffer();
 
+        /**
+         * pop all ready samples into the sub buffer, so that they can be processed as a single block
+         * the latency stays the same, and it can be mixed with popSubBuffer() freely
+         */
+        void popWholeSubBuffer();
+
+        /**
+         * finish the processing of the current sub buffer
+         */
         void pushSubBuffer();
 
         void popBuffer(juce::AudioBuffer<FloatType> &buffer, bool write = true);
 
+        /**
+         * finish the block and write the delayed output into it
+         */
         void popBlock(juce::dsp::AudioBlock<FloatType> block, bool write = true);
 
+        /**
+         * get a view of some channels of the current sub buffer
+         */
         juce::AudioBuffer<FloatType> getSubBufferChannels(int channelOffset, int numChannels);
 
         juce::dsp::AudioBlock<FloatType> getSubBlockChannels(int channelOffset, int numChannels);
 
         inline auto isSubReady() {
-            return inputBuffer.getNumReady() >= subBuffer.getNumSamples();
+            return carryNum + hostNum - hostPos >= static_cast<int>(subSpec.maximumBlockSize);
         }
 
         inline auto getMainSpec() { return mainSpec; }
 
         inline auto getSubSpec() { return subSpec; }
 
+        /**
+         * get the maximum number of samples of the sub buffer, which is reached by popWholeSubBuffer()
+         */
+        inline auto getMaxSubBufferSize() const {
+            return subSpec.maximumBlockSize + mainSpec.maximumBlockSize;
+        }
+
         inline juce::uint32 getLatencySamples() {
             return static_cast<juce::uint32>(latencyInSamples.load());
         }
 
     private:
-        FIFOAudioBuffer<FloatType> inputBuffer, outputBuffer;
         juce::dsp::ProcessSpec subSpec, mainSpec;
         std::atomic<juce::uint32> latencyInSamples{0};
+
+        // the pushed block, samples before hostPos have been handed out
+        std::vector<FloatType *> hostPointers;
+        int hostNum{0}, hostPos{0};
+        // the current sub buffer, which points into the pushed block or the scratch buffer
+        std::vector<FloatType *> subPointers;
+        int subNum{0};
+        bool isSubInScratch{false};
+        int scratchCarryNum{0}, scratchHostStart{0};
+        juce::AudioBuffer<FloatType> scratchBuffer;
+        // unprocessed samples at the end of the last block
+        juce::AudioBuffer<FloatType> carryBuffer;
+        int carryNum{0};
+        // processed samples which wait for the output, the two buffers take turns
+        std::array<juce::AudioBuffer<FloatType>, 2> delayBuffers;
+        size_t delayIdx{0};
+        int delayNum{0};
+
+        void popScratchSubBuffer(int hostTakeNum);
     };
 }
 
@@ -11,5 +11,6 @@
 #define ZLCHORE_HPP
 
 #include "para_updater.hpp"
+#include "rt_audit.hpp"
 
 #endif //ZLCHORE_HPP
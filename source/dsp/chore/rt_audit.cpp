@@ -0,0 +1,348 @@
+// Copyright (C) 2024 - zsliu98
+// This file is part of ZLEqualizer
+//
+// ZLEqualizer is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License Version 3 as published by the Free Software Foundation.
+//
+// ZLEqualizer is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License along with ZLEqualizer. If not, see <https://www.gnu.org/licenses/>.
+
+#include "rt_audit.hpp"
+
+#if ZL_RT_AUDIT
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#define ZL_RT_AUDIT_TLS thread_local
+#else
+#include <execinfo.h>
+#include <unistd.h>
+// initial-exec keeps the flags away from the lazy TLS allocation, which would call malloc again
+#define ZL_RT_AUDIT_TLS __thread __attribute__((tls_model("initial-exec")))
+#endif
+
+#if defined(__linux__)
+#include <dlfcn.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <sys/select.h>
+#include <time.h>
+#endif
+
+namespace zlChore::RTAudit {
+    namespace {
+        ZL_RT_AUDIT_TLS int realtimeDepth = 0;
+        ZL_RT_AUDIT_TLS bool isReporting = false;
+        ZL_RT_AUDIT_TLS const char *oneShotName = nullptr;
+        std::atomic<size_t> violationNum{0}, oneShotViolationNum{0};
+
+        // hashes of the reported call stacks, 0 marks an empty slot
+        constexpr size_t maxStackNum = 1024;
+        std::array<std::atomic<uint64_t>, maxStackNum> stackHashes{};
+
+        bool isNewStack(uint64_t hash) {
+            hash |= 1;
+            for (size_t i = 0; i < maxStackNum; ++i) {
+                auto &slot = stackHashes[(hash + i) % maxStackNum];
+                auto current = slot.load();
+                if (current == 0 && slot.compare_exchange_strong(current, hash)) {
+                    return true;
+                }
+                if (current == hash) {
+                    return false;
+                }
+            }
+            return false;
+        }
+    }
+
+    ScopedRealtime::ScopedRealtime() {
+        ++realtimeDepth;
+    }
+
+    ScopedRealtime::~ScopedRealtime() {
+        --realtimeDepth;
+    }
+
+    ScopedOneShot::ScopedOneShot(const char *name) : previousName(oneShotName) {
+        oneShotName = name;
+    }
+
+    ScopedOneShot::~ScopedOneShot() {
+        oneShotName = previousName;
+    }
+
+    bool isRealtime() {
+        return realtimeDepth > 0 && !isReporting;
+    }
+
+    void report(const char *what) {
+        isReporting = true;
+        if (oneShotName != nullptr) {
+            oneShotViolationNum.fetch_add(1);
+        } else {
+            violationNum.fetch_add(1);
+        }
+        const char *oneShot = oneShotName != nullptr ? oneShotName : "none";
+#if defined(_WIN32)
+        if (isNewStack(reinterpret_cast<uintptr_t>(what) ^ reinterpret_cast<uintptr_t>(oneShot))) {
+            std::fprintf(stderr, "[rt_audit] %s on the audio thread (one-shot: %s)\n", what, oneShot);
+        }
+#else
+        std::array<void *, 64> frames{};
+        const auto frameNum = backtrace(frames.data(), static_cast<int>(frames.size()));
+        uint64_t hash = 14695981039346656037ull ^ reinterpret_cast<uintptr_t>(what);
+        for (int i = 0; i < frameNum; ++i) {
+            hash = (hash ^ reinterpret_cast<uintptr_t>(frames[static_cast<size_t>(i)])) * 1099511628211ull;
+        }
+        if (isNewStack(hash)) {
+            dprintf(STDERR_FILENO, "[rt_audit] %s on the audio thread (one-shot: %s)\n", what, oneShot);
+            backtrace_symbols_fd(frames.data(), frameNum, STDERR_FILENO);
+        }
+#endif
+        isReporting = false;
+    }
+
+    size_t getViolationNum() {
+        return violationNum.load();
+    }
+
+    size_t getOneShotViolationNum() {
+        return oneShotViolationNum.load();
+    }
+
+    void resetViolationNum() {
+        violationNum.store(0);
+        oneShotViolationNum.store(0);
+    }
+}
+
+namespace {
+    inline void check(const char *what) {
+        if (zlChore::RTAudit::isRealtime()) {
+            zlChore::RTAudit::report(what);
+        }
+    }
+}
+
+#if defined(__linux__)
+// glibc: interpose the C allocation, locking and blocking functions
+// the interposers take effect in executables, e.g. the Tests and Standalone targets
+namespace {
+    // resolved lazily without function-local statics, whose guards may lock
+    template<typename Func>
+    Func *getNext(std::atomic<void *> &cache, const char *name) {
+        auto *ptr = cache.load(std::memory_order_relaxed);
+        if (ptr == nullptr) {
+            ptr = dlsym(RTLD_NEXT, name);
+            cache.store(ptr, std::memory_order_relaxed);
+        }
+        return reinterpret_cast<Func *>(ptr);
+    }
+
+    std::atomic<void *> nextMutexLock{nullptr}, nextSpinLock{nullptr};
+    std::atomic<void *> nextRWLockRd{nullptr}, nextRWLockWr{nullptr};
+    std::atomic<void *> nextCondWait{nullptr}, nextCondTimedWait{nullptr};
+    std::atomic<void *> nextSemWait{nullptr}, nextSemTimedWait{nullptr};
+    std::atomic<void *> nextSchedYield{nullptr}, nextNanoSleep{nullptr}, nextClockNanoSleep{nullptr};
+    std::atomic<void *> nextUSleep{nullptr}, nextPoll{nullptr}, nextSelect{nullptr};
+    std::atomic<void *> nextRead{nullptr}, nextWrite{nullptr};
+}
+
+extern "C" {
+    void *__libc_malloc(size_t size);
+
+    void *__libc_calloc(size_t num, size_t size);
+
+    void *__libc_realloc(void *ptr, size_t size);
+
+    void __libc_free(void *ptr);
+
+    void *__libc_memalign(size_t alignment, size_t size);
+
+    void *malloc(size_t size) __THROW {
+        check("malloc");
+        return __libc_malloc(size);
+    }
+
+    void *calloc(size_t num, size_t size) __THROW {
+        check("calloc");
+        return __libc_calloc(num, size);
+    }
+
+    void *realloc(void *ptr, size_t size) __THROW {
+        check("realloc");
+        return __libc_realloc(ptr, size);
+    }
+
+    void free(void *ptr) __THROW {
+        if (ptr != nullptr) {
+            check("free");
+        }
+        __libc_free(ptr);
+    }
+
+    void *memalign(size_t alignment, size_t size) __THROW {
+        check("memalign");
+        return __libc_memalign(alignment, size);
+    }
+
+    void *aligned_alloc(size_t alignment, size_t size) __THROW {
+        check("aligned_alloc");
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void **ptr, size_t alignment, size_t size) __THROW {
+        check("posix_memalign");
+        if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0) {
+            return EINVAL;
+        }
+        *ptr = __libc_memalign(alignment, size);
+        return *ptr == nullptr ? ENOMEM : 0;
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t *mutex) __THROWNL {
+        check("pthread_mutex_lock");
+        return getNext<int(pthread_mutex_t *)>(nextMutexLock, "pthread_mutex_lock")(mutex);
+    }
+
+    int pthread_spin_lock(pthread_spinlock_t *lock) __THROWNL {
+        check("pthread_spin_lock");
+        return getNext<int(pthread_spinlock_t *)>(nextSpinLock, "pthread_spin_lock")(lock);
+    }
+
+    int pthread_rwlock_rdlock(pthread_rwlock_t *lock) __THROWNL {
+        check("pthread_rwlock_rdlock");
+        return getNext<int(pthread_rwlock_t *)>(nextRWLockRd, "pthread_rwlock_rdlock")(lock);
+    }
+
+    int pthread_rwlock_wrlock(pthread_rwlock_t *lock) __THROWNL {
+        check("pthread_rwlock_wrlock");
+        return getNext<int(pthread_rwlock_t *)>(nextRWLockWr, "pthread_rwlock_wrlock")(lock);
+    }
+
+    int pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex) {
+        check("pthread_cond_wait");
+        return getNext<int(pthread_cond_t *, pthread_mutex_t *)>(nextCondWait, "pthread_cond_wait")(cond, mutex);
+    }
+
+    int pthread_cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *mutex, const timespec *time) {
+        check("pthread_cond_timedwait");
+        return getNext<int(pthread_cond_t *, pthread_mutex_t *, const timespec *)>(
+            nextCondTimedWait, "pthread_cond_timedwait")(cond, mutex, time);
+    }
+
+    int sem_wait(sem_t *sem) {
+        check("sem_wait");
+        return getNext<int(sem_t *)>(nextSemWait, "sem_wait")(sem);
+    }
+
+    int sem_timedwait(sem_t *sem, const timespec *time) {
+        check("sem_timedwait");
+        return getNext<int(sem_t *, const timespec *)>(nextSemTimedWait, "sem_timedwait")(sem, time);
+    }
+
+    // a contended juce::SpinLock yields the thread
+    int sched_yield() __THROW {
+        check("sched_yield");
+        return getNext<int()>(nextSchedYield, "sched_yield")();
+    }
+
+    int nanosleep(const timespec *request, timespec *remaining) {
+        check("nanosleep");
+        return getNext<int(const timespec *, timespec *)>(nextNanoSleep, "nanosleep")(request, remaining);
+    }
+
+    int clock_nanosleep(clockid_t clock, int flags, const timespec *request, timespec *remaining) {
+        check("clock_nanosleep");
+        return getNext<int(clockid_t, int, const timespec *, timespec *)>(
+            nextClockNanoSleep, "clock_nanosleep")(clock, flags, request, remaining);
+    }
+
+    int usleep(useconds_t time) {
+        check("usleep");
+        return getNext<int(useconds_t)>(nextUSleep, "usleep")(time);
+    }
+
+    int poll(pollfd *fds, nfds_t num, int timeout) {
+        check("poll");
+        return getNext<int(pollfd *, nfds_t, int)>(nextPoll, "poll")(fds, num, timeout);
+    }
+
+    int select(int num, fd_set *readFDs, fd_set *writeFDs, fd_set *exceptFDs, timeval *timeout) {
+        check("select");
+        return getNext<int(int, fd_set *, fd_set *, fd_set *, timeval *)>(
+            nextSelect, "select")(num, readFDs, writeFDs, exceptFDs, timeout);
+    }
+
+    ssize_t read(int fd, void *buf, size_t num) {
+        check("read");
+        return getNext<ssize_t(int, void *, size_t)>(nextRead, "read")(fd, buf, num);
+    }
+
+    ssize_t write(int fd, const void *buf, size_t num) {
+        check("write");
+        return getNext<ssize_t(int, const void *, size_t)>(nextWrite, "write")(fd, buf, num);
+    }
+}
+#else
+// other platforms: replace the global allocation functions only
+void *operator new(const size_t size) {
+    check("operator new");
+    if (auto *ptr = std::malloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](const size_t size) {
+    check("operator new[]");
+    if (auto *ptr = std::malloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(const size_t size, const std::nothrow_t &) noexcept {
+    check("operator new");
+    return std::malloc(size);
+}
+
+void *operator new[](const size_t size, const std::nothrow_t &) noexcept {
+    check("operator new[]");
+    return std::malloc(size);
+}
+
+void operator delete(void *ptr) noexcept {
+    if (ptr != nullptr) {
+        check("operator delete");
+    }
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    if (ptr != nullptr) {
+        check("operator delete[]");
+    }
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    operator delete(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept {
+    operator delete[](ptr);
+}
+#endif
+
+#endif
@@ -0,0 +1,99 @@
+// Copyright (C) 2024 - zsliu98
+// This file is part of ZLEqualizer
+//
+// ZLEqualizer is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License Version 3 as published by the Free Software Foundation.
+//
+// ZLEqualizer is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License along with ZLEqualizer. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ZLCHORE_RT_AUDIT_HPP
+#define ZLCHORE_RT_AUDIT_HPP
+
+#include <cstddef>
+
+#ifndef ZL_RT_AUDIT
+#define ZL_RT_AUDIT 0
+#endif
+
+/**
+ * real-time safety audit of the audio thread, enabled with ZL_RT_AUDIT=1
+ * while a ScopedRealtime is alive on a thread, memory allocations, lock acquisitions
+ * and blocking syscalls made by that thread are counted and their call stacks are
+ * written to stderr (once per call stack)
+ */
+namespace zlChore::RTAudit {
+#if ZL_RT_AUDIT
+    class ScopedRealtime {
+    public:
+        ScopedRealtime();
+
+        ~ScopedRealtime();
+
+        ScopedRealtime(const ScopedRealtime &) = delete;
+
+        ScopedRealtime &operator=(const ScopedRealtime &) = delete;
+    };
+
+    /**
+     * marks a known one-shot call on the audio thread, e.g. notifying the host of the tail
+     * violations inside it are counted as one-shot violations and reported under its name
+     */
+    class ScopedOneShot {
+    public:
+        explicit ScopedOneShot(const char *name);
+
+        ~ScopedOneShot();
+
+        ScopedOneShot(const ScopedOneShot &) = delete;
+
+        ScopedOneShot &operator=(const ScopedOneShot &) = delete;
+
+    private:
+        const char *previousName;
+    };
+
+    /**
+     * @return whether the calling thread is inside a ScopedRealtime
+     */
+    bool isRealtime();
+
+    /**
+     * count a violation and report the call stack if it is new
+     * @param what the name of the offending call
+     */
+    void report(const char *what);
+
+    size_t getViolationNum();
+
+    size_t getOneShotViolationNum();
+
+    void resetViolationNum();
+#else
+    class ScopedRealtime {
+    public:
+        ScopedRealtime() noexcept {
+        }
+    };
+
+    class ScopedOneShot {
+    public:
+        explicit ScopedOneShot(const char *) noexcept {
+        }
+    };
+
+    inline bool isRealtime() { return false; }
+
+    inline void report(const char *) {
+    }
+
+    inline size_t getViolationNum() { return 0; }
+
+    inline size_t getOneShotViolationNum() { return 0; }
+
+    inline void resetViolationNum() {
+    }
+#endif
+}
+
+#endif //ZLCHORE_RT_AUDIT_HPP
@@ -19,7 +19,10 @@ namespace zlDSP {
           parameterRef(parameters), parameterNARef(parametersNA),
           controllerRef(controller),
           decaySpeed(zlState::ffTSpeed::speeds[static_cast<size_t>(zlState::ffTSpeed::defaultI)]) {
-        juce::ignoreUnused(parameterRef);
+        for (size_t i = 0; i < bandNUM; ++i) {
+            gainParas[i] = parameterRef.getRawParameterValue(appendSuffix(gain::ID, i));
+            targetGainParas[i] = parameterRef.getRawParameterValue(appendSuffix(targetGain::ID, i));
+        }
         addListeners();
         initDefaultValues();
     }
@@ -66,8 +69,8 @@ namespace zlDSP {
             controllerRef.getAutoGain().enable(newValue > .5f);
         } else if (parameterID == scale::ID) {
             for (size_t i = 0; i < bandNUM; ++i) {
-                auto baseGain = parameterRef.getRawParameterValue(appendSuffix(gain::ID, i))->load();
-                auto targetGain = parameterRef.getRawParameterValue(appendSuffix(targetGain::ID, i))->load();
+                auto baseGain = gainParas[i]->load();
+                auto targetGain = targetGainParas[i]->load();
                 baseGain = zlDSP::gain::range.snapToLegalValue(baseGain * scale::formatV(newValue));
                 targetGain = zlDSP::targetGain::range.snapToLegalValue(targetGain * scale::formatV(newValue));
                 controllerRef.getBaseFilter(i).setGain(baseGain);
@@ -86,6 +89,8 @@ namespace zlDSP {
             }
         } else if (parameterID == zeroLatency::ID) {
             controllerRef.setZeroLatency(newValue > .5f);
+        } else if (parameterID == silenceFloor::ID) {
+            controllerRef.setSilenceFloor(static_cast<FloatType>(newValue));
         } else if (parameterID == zlState::fftPreON::ID) {
             switch (static_cast<size_t>(newValue)) {
                 case 0:
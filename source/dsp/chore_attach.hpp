@@ -30,6 +30,8 @@ namespace zlDSP {
         juce::AudioProcessor &processorRef;
         juce::AudioProcessorValueTreeState &parameterRef, &parameterNARef;
         Controller<FloatType> &controllerRef;
+        // cached so that an automated scale does not look up the parameters on the audio thread
+        std::array<std::atomic<float> *, bandNUM> gainParas{}, targetGainParas{};
         std::atomic<float> decaySpeed;
         std::array<std::atomic<int>, 3> isFFTON{1, 1, 0};
 
@@ -38,7 +40,7 @@ namespace zlDSP {
             dynRMS::ID, dynSmooth::ID,
             effectON::ID, phaseFlip::ID, staticAutoGain::ID, autoGain::ID,
             scale::ID, outputGain::ID,
-            filterStructure::ID, dynHQ::ID, zeroLatency::ID
+            filterStructure::ID, dynHQ::ID, zeroLatency::ID, silenceFloor::ID
         };
         constexpr static std::array defaultVs{
             static_cast<float>(sideChain::defaultV),
@@ -53,7 +55,8 @@ namespace zlDSP {
             static_cast<float>(outputGain::defaultV),
             static_cast<float>(filterStructure::defaultI),
             static_cast<float>(dynHQ::defaultI),
-            static_cast<float>(zeroLatency::defaultI)
+            static_cast<float>(zeroLatency::defaultI),
+            static_cast<float>(silenceFloor::defaultV)
         };
 
         constexpr static std::array NAIDs{
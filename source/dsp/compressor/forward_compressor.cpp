@@ -23,7 +23,7 @@ namespace zlCompressor {
     }
 
     template<typename FloatType>
-    FloatType ForwardCompressor<FloatType>::process(juce::AudioBuffer<FloatType> buffer) {
+    FloatType ForwardCompressor<FloatType>::process(const juce::AudioBuffer<FloatType> &buffer) {
         tracker.process(buffer);
         auto x = tracker.getMomentaryLoudness() - baseLine.load();
         x = computer.process(x);
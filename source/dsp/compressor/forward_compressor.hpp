@@ -35,7 +35,7 @@ namespace zlCompressor {
          * @param buffer side chain audio buffer
          * @return gain (in gain)
          */
-        FloatType process(juce::AudioBuffer<FloatType> buffer);
+        FloatType process(const juce::AudioBuffer<FloatType> &buffer);
 
         inline KneeComputer<FloatType> &getComputer() { return computer; }
 
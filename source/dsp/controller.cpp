@@ -13,7 +13,11 @@ namespace zlDSP {
     template<typename FloatType>
     Controller<FloatType>::Controller(juce::AudioProcessor &processor, const size_t fftOrder)
         : processorRef(processor),
-          fftAnalyzer(fftOrder), conflictAnalyzer(fftOrder), matchAnalyzer(13) {
+          fftAnalyzer(analyzerHub, fftOrder), conflictAnalyzer(analyzerHub, fftOrder),
+          matchAnalyzer(analyzerHub, 13) {
+        analyzerHub.addConsumer(fftAnalyzer);
+        analyzerHub.addConsumer(conflictAnalyzer);
+        analyzerHub.addConsumer(matchAnalyzer);
         for (size_t i = 0; i < bandNUM; ++i) {
             histograms[i].setDecayRate(FloatType(0.99999));
             subHistograms[i].setDecayRate(FloatType(0.9995));
@@ -34,11 +38,19 @@ namespace zlDSP {
         delay.setMaximumDelayInSamples(static_cast<int>(
                                            zlDSP::dynLookahead::range.end / 1000.f * static_cast<float>(spec.
                                                sampleRate)) + 1);
-        delay.prepare({spec.sampleRate, spec.maximumBlockSize, 2});
+        // a mono spec runs every stage on a single main channel (and a single side channel)
+        isMono = spec.numChannels == 1;
+        const auto numChannels = static_cast<juce::uint32>(isMono ? 1 : 2);
+        delay.prepare({spec.sampleRate, spec.maximumBlockSize, numChannels});
 
-        subBuffer.prepare({spec.sampleRate, spec.maximumBlockSize, 4});
+        subBuffer.prepare({spec.sampleRate, spec.maximumBlockSize, numChannels * 2});
+        silentSamples = 0;
+        isIdle = false;
         sampleRate.store(spec.sampleRate);
+        // the correction stages & their filters are prepared while the correction worker is stopped
+        correctionWorker.stop();
         updateSubBuffer();
+        correctionWorker.start();
     }
 
     template<typename FloatType>
@@ -51,33 +63,33 @@ namespace zlDSP {
             f.getCompressor().getTracker().setMaximumMomentarySize(numRMS);
         }
 
-        juce::dsp::ProcessSpec subSpec{sampleRate.load(), subBuffer.getSubSpec().maximumBlockSize, 2};
+        // a sub block may cover a whole block if nothing modulates
+        const auto maximumBlockSize = subBuffer.getMaxSubBufferSize();
+        juce::dsp::ProcessSpec subSpec{sampleRate.load(), maximumBlockSize, static_cast<juce::uint32>(isMono ? 1 : 2)};
+        // dynamic filters are always prepared for stereo, since a mono signal may get expanded for them
+        juce::dsp::ProcessSpec stereoSpec{sampleRate.load(), maximumBlockSize, 2};
         for (auto &f: filters) {
-            f.prepare(subSpec);
+            f.prepare(stereoSpec);
         }
-
-        prototypeCorrections[0].prepare(subSpec);
-        for (size_t i = 1; i < 5; ++i) {
-            prototypeCorrections[i].prepare(juce::dsp::ProcessSpec{subSpec.sampleRate, subSpec.maximumBlockSize, 1});
+        for (auto &bank: parallelBanks) {
+            bank.prepare(stereoSpec);
         }
+        monoExpandBuffer.setSize(isMono ? 4 : 0, static_cast<int>(maximumBlockSize));
+        monoSideBuffer.setSize(isMono ? 1 : 0, static_cast<int>(maximumBlockSize));
+
+        prototypeStage.prepare(subSpec);
         prototypeW1.resize(prototypeCorrections[0].getCorrectionSize());
         prototypeW2.resize(prototypeCorrections[0].getCorrectionSize());
         zlFilter::calculateWsForPrototype<FloatType>(prototypeW1);
         zlFilter::calculateWsForBiquad<FloatType>(prototypeW2);
 
-        mixedCorrections[0].prepare(subSpec);
-        for (size_t i = 1; i < 5; ++i) {
-            mixedCorrections[i].prepare(juce::dsp::ProcessSpec{subSpec.sampleRate, subSpec.maximumBlockSize, 1});
-        }
+        mixedStage.prepare(subSpec);
         mixedW1.resize(mixedCorrections[0].getCorrectionSize());
         mixedW2.resize(mixedCorrections[0].getCorrectionSize());
         zlFilter::calculateWsForPrototype<FloatType>(mixedW1);
         zlFilter::calculateWsForBiquad<FloatType>(mixedW2);
 
-        linearFilters[0].prepare(subSpec);
-        for (size_t i = 1; i < 5; ++i) {
-            linearFilters[i].prepare(juce::dsp::ProcessSpec{subSpec.sampleRate, subSpec.maximumBlockSize, 1});
-        }
+        linearStage.prepare(subSpec);
         linearW1.resize(linearFilters[0].getCorrectionSize());
         zlFilter::calculateWsForPrototype<FloatType>(linearW1);
 
@@ -100,19 +112,11 @@ namespace zlDSP {
         outputGain.prepare(subSpec);
         autoGain.prepare(subSpec);
         for (auto &g: compensationGains) {
-            g.prepare(subSpec);
+            g.prepare(stereoSpec);
         }
-        fftAnalyzer.prepare(subSpec);
-        fftAnalyzer.getPreDelay().setMaximumDelayInSamples(linearFilters[0].getLatency() * 3 + 10);
-        fftAnalyzer.getPreDelay().prepare(subSpec);
-        fftAnalyzer.getSideDelay().setMaximumDelayInSamples(linearFilters[0].getLatency() * 3 + 10);
-        fftAnalyzer.getSideDelay().prepare(subSpec);
-
-        conflictAnalyzer.prepare(subSpec);
-        conflictAnalyzer.getSideDelay().setMaximumDelayInSamples(linearFilters[0].getLatency() * 3 + 10);
-        conflictAnalyzer.getSideDelay().prepare(subSpec);
-
-        matchAnalyzer.prepare(subSpec);
+        analyzerHub.getPreDelay().setMaximumDelayInSamples(linearStage.getLatency() + 10);
+        analyzerHub.getSideDelay().setMaximumDelayInSamples(linearStage.getLatency() + 10);
+        analyzerHub.prepare(subSpec);
 
         for (auto &t: trackers) {
             t.prepare(subSpec);
@@ -130,12 +134,16 @@ namespace zlDSP {
         }
         if (toUpdateDynamicON.exchange(false)) {
             updateDynamicONs();
+            toUpdateSideChain.store(true);
         }
         if (toUpdateLRs.exchange(false)) {
             updateLRs();
-            updateTrackersON();
             updateCorrections();
             toUpdateSgc.store(true);
+            toUpdateSideChain.store(true);
+        }
+        if (toUpdateSideChain.exchange(false)) {
+            updateSideChain();
         }
         if (toUpdateBypass.exchange(false)) {
             for (size_t i = 0; i < bandNUM; ++i) {
@@ -147,8 +155,9 @@ namespace zlDSP {
         if (currentIsSgcON != isSgcON.load()) {
             currentIsSgcON = isSgcON.load();
             if (!currentIsSgcON) {
-                for (auto &cG: compensationGains) {
-                    cG.setGainLinear(FloatType(1));
+                for (size_t lr = 0; lr < 5; ++lr) {
+                    compensationGains[lr].setGainLinear(FloatType(1));
+                    linearStage.setGroupGain(lr, FloatType(1));
                 }
             } else {
                 toUpdateSgc.store(true);
@@ -164,40 +173,64 @@ namespace zlDSP {
             updateSolo();
         }
         currentIsEffectON = isEffectON.load();
+        analyzerHub.updateSignals();
+        // the side chain is only needed by dynamic bands, the side solo and the side spectrum
+        const auto needSide = useSide || (currentUseSolo && currentSoloSide) ||
+                              analyzerHub.getIsSignalON(zlFFT::sideSignal);
 
-        juce::AudioBuffer<FloatType> mainBuffer{buffer.getArrayOfWritePointers() + 0, 2, buffer.getNumSamples()};
-        juce::AudioBuffer<FloatType> sideBuffer{buffer.getArrayOfWritePointers() + 2, 2, buffer.getNumSamples()};
+        const auto numChannels = isMono ? 1 : 2;
+        juce::AudioBuffer<FloatType> mainBuffer{
+            buffer.getArrayOfWritePointers() + 0, numChannels, buffer.getNumSamples()
+        };
+        juce::AudioBuffer<FloatType> sideBuffer{
+            buffer.getArrayOfWritePointers() + numChannels, numChannels, buffer.getNumSamples()
+        };
+        // once the input has been silent for longer than the tail, the output is silent as well
+        if (updateIdle(mainBuffer, sideBuffer)) {
+            mainBuffer.clear();
+            return;
+        }
         // if no side chain, copy the main buffer into the side buffer
-        if (!sideChain.load()) {
+        if (!sideChain.load() && needSide) {
             sideBuffer.makeCopyOf(mainBuffer, true);
         }
         // process lookahead
         delay.process(mainBuffer);
+        // sub blocks are only needed while something changes within the block
+        const auto isWholeBlock = !getIsModulating() && buffer.getNumSamples() > 0;
         if (isZeroLatency.load()) {
             int startSample = 0;
-            const int samplePerBuffer = static_cast<int>(subBuffer.getSubSpec().maximumBlockSize);
+            const int samplePerBuffer = isWholeBlock
+                                            ? buffer.getNumSamples()
+                                            : static_cast<int>(subBuffer.getSubSpec().maximumBlockSize);
             while (startSample < buffer.getNumSamples()) {
                 const int actualNumSample = std::min(samplePerBuffer, buffer.getNumSamples() - startSample);
                 auto subMainBuffer = juce::AudioBuffer<FloatType>(mainBuffer.getArrayOfWritePointers(),
-                                                                  2, startSample, actualNumSample);
+                                                                  numChannels, startSample, actualNumSample);
                 auto subSideBuffer = juce::AudioBuffer<FloatType>(sideBuffer.getArrayOfWritePointers(),
-                                                                  2, startSample, actualNumSample);
+                                                                  numChannels, startSample, actualNumSample);
                 processSubBuffer(subMainBuffer, subSideBuffer);
                 startSample += samplePerBuffer;
             }
         } else {
             auto block = juce::dsp::AudioBlock<FloatType>(buffer);
-            // ---------------- start sub buffer
-            subBuffer.pushBlock(block);
-            while (subBuffer.isSubReady()) {
-                subBuffer.popSubBuffer();
+            const auto processPoppedSubBuffer = [&]() {
                 // create main sub buffer and side sub buffer
-                auto subMainBuffer = juce::AudioBuffer<FloatType>(subBuffer.subBuffer.getArrayOfWritePointers() + 0,
-                                                                  2, subBuffer.subBuffer.getNumSamples());
-                auto subSideBuffer = juce::AudioBuffer<FloatType>(subBuffer.subBuffer.getArrayOfWritePointers() + 2,
-                                                                  2, subBuffer.subBuffer.getNumSamples());
+                auto subMainBuffer = subBuffer.getSubBufferChannels(0, numChannels);
+                auto subSideBuffer = subBuffer.getSubBufferChannels(numChannels, numChannels);
                 processSubBuffer(subMainBuffer, subSideBuffer);
                 subBuffer.pushSubBuffer();
+            };
+            // ---------------- start sub buffer
+            subBuffer.pushBlock(block);
+            if (isWholeBlock) {
+                subBuffer.popWholeSubBuffer();
+                processPoppedSubBuffer();
+            } else {
+                while (subBuffer.isSubReady()) {
+                    subBuffer.popSubBuffer();
+                    processPoppedSubBuffer();
+                }
             }
             subBuffer.popBlock(block);
             // ---------------- end sub buffer
@@ -208,8 +241,7 @@ namespace zlDSP {
     template<typename FloatType>
     void Controller<FloatType>::processSubBuffer(juce::AudioBuffer<FloatType> &subMainBuffer,
                                                  juce::AudioBuffer<FloatType> &subSideBuffer) {
-        fftAnalyzer.pushPreFFTBuffer(subMainBuffer);
-        matchAnalyzer.process(subMainBuffer, subSideBuffer);
+        analyzerHub.pushPreBuffer(subMainBuffer);
 
         if (currentIsEffectON) {
             if (currentUseSolo) {
@@ -222,12 +254,141 @@ namespace zlDSP {
             processSubBufferOnOff<true>(subMainBuffer, subSideBuffer);
         }
 
-        fftAnalyzer.pushSideFFTBuffer(subSideBuffer);
-        fftAnalyzer.pushPostFFTBuffer(subMainBuffer);
+        analyzerHub.pushSideBuffer(subSideBuffer);
+        analyzerHub.pushPostBuffer(subMainBuffer);
+        analyzerHub.process();
         fftAnalyzer.process();
-        conflictAnalyzer.pushMainBuffer(subMainBuffer);
-        conflictAnalyzer.pushRefBuffer(subSideBuffer);
-        conflictAnalyzer.process();
+    }
+
+    template<typename FloatType>
+    bool Controller<FloatType>::updateIdle(juce::AudioBuffer<FloatType> &mainBuffer,
+                                           juce::AudioBuffer<FloatType> &sideBuffer) {
+        const auto tail = updateTailSamples();
+        const auto numSamples = mainBuffer.getNumSamples();
+        const auto floor = silenceFloor.load();
+        const auto isSilent = mainBuffer.getMagnitude(0, numSamples) <= floor &&
+                              (!sideChain.load() || sideBuffer.getMagnitude(0, numSamples) <= floor);
+        if (!isSilent) {
+            silentSamples = 0;
+            isIdle = false;
+            return false;
+        }
+        // the current block is silent, so it is enough that the previous ones cover the tail
+        if (!isIdle && silentSamples >= tail) {
+            isIdle = true;
+            clearTails();
+        }
+        silentSamples = std::min(silentSamples + numSamples, std::numeric_limits<int>::max() / 2);
+        return isIdle;
+    }
+
+    template<typename FloatType>
+    void Controller<FloatType>::clearTails() {
+        // idle blocks are cleared without being processed, so the states restart from silence as well
+        // otherwise the sub buffer & the lookahead would replay the last samples before idle once the signal returns
+        for (auto &f: filters) {
+            f.clearStates();
+        }
+        soloFilter.clearStates();
+        delay.reset();
+        subBuffer.clear();
+        prototypeStage.reset();
+        mixedStage.reset();
+        linearStage.reset();
+    }
+
+    template<typename FloatType>
+    bool Controller<FloatType>::getIsModulating() {
+        // dynamic bands update their gains once per sub block
+        if (useSide) return true;
+        // parameter changes ramp over the first sub block
+        if (currentFilterStructure == filterStructure::linear) return false;
+        for (size_t i = 0; i < bandNUM; ++i) {
+            if (isActive[i].load() && filters[i].getMainFilter().getIsUpdatePending()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template<typename FloatType>
+    int Controller<FloatType>::updateTailSamples() {
+        // bands & groups are in series, so their tails add up
+        size_t bandTail = 0;
+        for (size_t i = 0; i < bandNUM; ++i) {
+            if (isActive[i].load()) {
+                bandTail += filters[i].getMainFilter().getTailSamples();
+            }
+        }
+        int tail = static_cast<int>(std::min(bandTail, static_cast<size_t>(std::numeric_limits<int>::max() / 4)));
+        switch (currentFilterStructure) {
+            case filterStructure::minimum:
+            case filterStructure::svf:
+            case filterStructure::parallel: {
+                break;
+            }
+            case filterStructure::matched: {
+                tail += prototypeStage.getTailSamples();
+                break;
+            }
+            case filterStructure::mixed: {
+                tail += mixedStage.getTailSamples();
+                break;
+            }
+            case filterStructure::linear: {
+                tail = linearStage.getTailSamples();
+                break;
+            }
+        }
+        tail += getDynamicTailSamples();
+        tail += delay.getDelaySamples();
+        if (!isZeroLatency.load()) {
+            tail += static_cast<int>(subBuffer.getLatencySamples());
+        }
+        tail = std::min(tail, std::numeric_limits<int>::max() / 4);
+        // the host gets a power of two which covers the tail, so that it is only notified when the tail grows
+        // or shrinks a lot, e.g. not on every automated gain change
+        const auto reportedTail = tailSamples.load();
+        if (tail > reportedTail || tail < reportedTail / 4) {
+            tailSamples.store(juce::nextPowerOfTwo(tail));
+            toNotifyTail.store(true);
+            // posting the message may lock or allocate, which is accepted as it only happens when the tail changes
+            const zlChore::RTAudit::ScopedOneShot oneShot("tail notification");
+            triggerAsyncUpdate();
+        }
+        return tail;
+    }
+
+    template<typename FloatType>
+    int Controller<FloatType>::getDynamicTailSamples() {
+        // the dynamic gains keep moving after the input becomes silent, until the RMS windows are flushed
+        // and the gains are released, trackers hold one value per sub block
+        const auto subSize = static_cast<FloatType>(subBuffer.getSubSpec().maximumBlockSize);
+        const auto samplesPerMs = static_cast<FloatType>(sampleRate.load() / 1000.0);
+        FloatType dynamicTail = 0;
+        for (size_t idx = 0; idx < dynamicONIndices.size(); ++idx) {
+            const auto i = dynamicONIndices[idx];
+            if (!isActive[i].load()) continue;
+            auto &compressor = filters[i].getCompressor();
+            const auto rmsTail = static_cast<FloatType>(compressor.getTracker().getMomentarySize()) * subSize;
+            const auto detectorTail = (compressor.getDetector().getAttack() +
+                                       compressor.getDetector().getRelease()) * samplesPerMs;
+            dynamicTail = std::max(dynamicTail, rmsTail + detectorTail);
+        }
+        if (dynamicTail > FloatType(0)) {
+            // relative bands follow the loudness of their groups
+            for (size_t lr = 0; lr < 5; ++lr) {
+                if (useTrackers[lr]) {
+                    dynamicTail += static_cast<FloatType>(trackers[lr].getMomentarySize()) * subSize;
+                    break;
+                }
+            }
+        }
+        // the auto-gain ramps over one second
+        if (autoGain.getIsON()) {
+            dynamicTail += samplesPerMs * FloatType(1000);
+        }
+        return static_cast<int>(std::min(dynamicTail, static_cast<FloatType>(std::numeric_limits<int>::max() / 4)));
     }
 
     template<typename FloatType>
@@ -238,9 +399,23 @@ namespace zlDSP {
             processLinear<isBypassed>(subMainBuffer);
         } else {
             autoGain.processPre(subMainBuffer);
-            processDynamic<isBypassed>(subMainBuffer, subSideBuffer);
-            if (currentFilterStructure == filterStructure::parallel) {
-                processParallelPost<isBypassed>(subMainBuffer, subSideBuffer);
+            if (isMono && !collapseMono) {
+                // expand the mono signal into identical stereo channels and keep the left one
+                const auto numSamples = subMainBuffer.getNumSamples();
+                auto expandedMain = juce::AudioBuffer<FloatType>(monoExpandBuffer.getArrayOfWritePointers() + 0,
+                                                                 2, numSamples);
+                auto expandedSide = juce::AudioBuffer<FloatType>(monoExpandBuffer.getArrayOfWritePointers() + 2,
+                                                                 2, numSamples);
+                for (int channel = 0; channel < 2; ++channel) {
+                    expandedMain.copyFrom(channel, 0, subMainBuffer, 0, 0, numSamples);
+                    if (useSide) {
+                        expandedSide.copyFrom(channel, 0, subSideBuffer, 0, 0, numSamples);
+                    }
+                }
+                processDynamicAndParallel<isBypassed>(expandedMain, expandedSide);
+                subMainBuffer.copyFrom(0, 0, expandedMain, 0, 0, numSamples);
+            } else {
+                processDynamicAndParallel<isBypassed>(subMainBuffer, subSideBuffer);
             }
             autoGain.template processPost<isBypassed>(subMainBuffer);
             if (currentFilterStructure == filterStructure::matched) {
@@ -252,6 +427,16 @@ namespace zlDSP {
         outputGain.template process<isBypassed>(subMainBuffer);
     }
 
+    template<typename FloatType>
+    template<bool isBypassed>
+    void Controller<FloatType>::processDynamicAndParallel(juce::AudioBuffer<FloatType> &subMainBuffer,
+                                                          juce::AudioBuffer<FloatType> &subSideBuffer) {
+        processDynamic<isBypassed>(subMainBuffer, subSideBuffer);
+        if (currentFilterStructure == filterStructure::parallel) {
+            processParallelPost<isBypassed>(subMainBuffer, subSideBuffer);
+        }
+    }
+
     template<typename FloatType>
     void Controller<FloatType>::processSolo(juce::AudioBuffer<FloatType> &subMainBuffer,
                                             juce::AudioBuffer<FloatType> &subSideBuffer) {
@@ -259,6 +444,23 @@ namespace zlDSP {
             subMainBuffer.makeCopyOf(subSideBuffer, true);
         }
         soloFilter.processPre(subMainBuffer);
+        if (isMono) {
+            // the mono signal is the left & mid channel, the right channel is dropped and the side channel is silent
+            switch (currentFilterLRs[currentSoloIdx]) {
+                case lrType::stereo:
+                case lrType::left:
+                case lrType::mid: {
+                    soloFilter.process(subMainBuffer);
+                    break;
+                }
+                case lrType::right:
+                case lrType::side: {
+                    subMainBuffer.clear();
+                    break;
+                }
+            }
+            return;
+        }
         switch (currentFilterLRs[currentSoloIdx]) {
             case lrType::stereo: {
                 soloFilter.process(subMainBuffer);
@@ -314,27 +516,35 @@ namespace zlDSP {
                 }
             }
         }
-        // stereo filters process
-        processDynamicLRMS<isBypassed>(0, subMainBuffer, subSideBuffer);
-        // LR filters process
-        if (useLR) {
-            lrMainSplitter.split(subMainBuffer);
-            lrSideSplitter.split(subSideBuffer);
-            processDynamicLRMS<isBypassed>(1, lrMainSplitter.getLBuffer(),
-                                           lrSideSplitter.getLBuffer());
-            processDynamicLRMS<isBypassed>(2, lrMainSplitter.getRBuffer(),
-                                           lrSideSplitter.getRBuffer());
-            lrMainSplitter.combine(subMainBuffer);
-        }
-        // MS filters process
-        if (useMS) {
-            msMainSplitter.split(subMainBuffer);
-            msSideSplitter.split(subSideBuffer);
-            processDynamicLRMS<isBypassed>(3, msMainSplitter.getMBuffer(),
-                                           msSideSplitter.getMBuffer());
-            processDynamicLRMS<isBypassed>(4, msMainSplitter.getSBuffer(),
-                                           msSideSplitter.getSBuffer());
-            msMainSplitter.combine(subMainBuffer);
+        if (collapseMono) {
+            processDynamicMono<isBypassed>(subMainBuffer, subSideBuffer);
+        } else {
+            // stereo filters process
+            processDynamicLRMS<isBypassed>(0, subMainBuffer, subSideBuffer);
+            // LR filters process
+            if (useLR) {
+                lrMainSplitter.split(subMainBuffer);
+                if (useLRSide) {
+                    lrSideSplitter.split(subSideBuffer);
+                }
+                processDynamicLRMS<isBypassed>(1, lrMainSplitter.getLBuffer(),
+                                               lrSideSplitter.getLBuffer());
+                processDynamicLRMS<isBypassed>(2, lrMainSplitter.getRBuffer(),
+                                               lrSideSplitter.getRBuffer());
+                lrMainSplitter.combine(subMainBuffer);
+            }
+            // MS filters process
+            if (useMS) {
+                msMainSplitter.split(subMainBuffer);
+                if (useMSSide) {
+                    msSideSplitter.split(subSideBuffer);
+                }
+                processDynamicLRMS<isBypassed>(3, msMainSplitter.getMBuffer(),
+                                               msSideSplitter.getMBuffer());
+                processDynamicLRMS<isBypassed>(4, msMainSplitter.getSBuffer(),
+                                               msSideSplitter.getSBuffer());
+                msMainSplitter.combine(subMainBuffer);
+            }
         }
         // set main filter gain & Q and update histograms
         if (!isBypassed) {
@@ -357,6 +567,32 @@ namespace zlDSP {
         }
     }
 
+    template<typename FloatType>
+    template<bool isBypassed>
+    void Controller<FloatType>::processDynamicMono(juce::AudioBuffer<FloatType> &subMainBuffer,
+                                                   juce::AudioBuffer<FloatType> &subSideBuffer) {
+        // the mono signal is the left & mid channel of a stereo signal with identical channels
+        // the right channel is dropped on output and the side channel is silent, so those groups are skipped
+        if (useSideGroups[0]) {
+            // a stereo side chain carries the signal twice, scale it so that the loudness stays the same
+            const auto numSamples = subSideBuffer.getNumSamples();
+            auto stereoSideBuffer = juce::AudioBuffer<FloatType>(monoSideBuffer.getArrayOfWritePointers(),
+                                                                 1, numSamples);
+            juce::FloatVectorOperations::multiply(stereoSideBuffer.getWritePointer(0),
+                                                  subSideBuffer.getReadPointer(0),
+                                                  std::numbers::sqrt2_v<FloatType>, numSamples);
+            processDynamicLRMS<isBypassed>(0, subMainBuffer, stereoSideBuffer);
+        } else {
+            processDynamicLRMS<isBypassed>(0, subMainBuffer, subSideBuffer);
+        }
+        if (useLR) {
+            processDynamicLRMS<isBypassed>(1, subMainBuffer, subSideBuffer);
+        }
+        if (useMS) {
+            processDynamicLRMS<isBypassed>(3, subMainBuffer, subSideBuffer);
+        }
+    }
+
     template<typename FloatType>
     template<bool isBypassed>
     void Controller<FloatType>::processDynamicLRMS(const size_t lrIdx,
@@ -372,6 +608,8 @@ namespace zlDSP {
                 baseLine = tracker.minusInfinityDB * FloatType(0.5);
             }
         }
+        // run the side chains first and design the dynamic second order peaks of this group in one batch
+        dynamicBatch.clear();
         for (size_t idx = 0; idx < indices.size(); ++idx) {
             const auto i = indices[idx];
             if (dynRelatives[i].load()) {
@@ -379,17 +617,57 @@ namespace zlDSP {
             } else {
                 filters[i].getCompressor().setBaseLine(0);
             }
+            filters[i].pushToBatch(subMainBuffer, subSideBuffer, dynamicBatch);
+        }
+        if (dynamicBatch.getNum() > 0) {
+            dynamicBatch.design();
+            for (size_t idx = 0; idx < indices.size(); ++idx) {
+                filters[indices[idx]].pullFromBatch(dynamicBatch);
+            }
+        }
+        for (size_t idx = 0; idx < indices.size(); ++idx) {
+            const auto i = indices[idx];
             if (currentIsBypass[i] || isBypassed) {
-                filters[i].template process<true>(subMainBuffer, subSideBuffer);
+                processDynamicFilter<true>(lrIdx, i, subMainBuffer, subSideBuffer);
             } else {
-                filters[i].template process<false>(subMainBuffer, subSideBuffer);
+                processDynamicFilter<false>(lrIdx, i, subMainBuffer, subSideBuffer);
             }
         }
+        staticCascade.process(subMainBuffer);
+        parallelBanks[lrIdx].process(subMainBuffer);
         if (currentIsSgcON && currentFilterStructure != filterStructure::parallel) {
             compensationGains[lrIdx].template process<isBypassed>(subMainBuffer);
         }
     }
 
+    template<typename FloatType>
+    template<bool isBypassed>
+    void Controller<FloatType>::processDynamicFilter(const size_t lrIdx, const size_t i,
+                                                     juce::AudioBuffer<FloatType> &subMainBuffer,
+                                                     juce::AudioBuffer<FloatType> &subSideBuffer) {
+        if (currentFilterStructure == filterStructure::parallel) {
+            // parallel filters are collected into the bank, which sums them up from a single read of the input
+            auto &bank{parallelBanks[lrIdx]};
+            if (bank.getFreeNum() < FilterSize) {
+                bank.process(subMainBuffer);
+            }
+            if (filters[i].template pushToParallelBank<isBypassed>(subMainBuffer, subSideBuffer, bank)) {
+                return;
+            }
+        } else {
+            // static filters are collected into the cascade, which processes them in a single pass
+            // the cascade is flushed before any other filter so that the processing order stays the same
+            if (staticCascade.getFreeNum() < FilterSize) {
+                staticCascade.process(subMainBuffer);
+            }
+            if (filters[i].template pushToCascade<isBypassed>(subMainBuffer, staticCascade)) {
+                return;
+            }
+            staticCascade.process(subMainBuffer);
+        }
+        filters[i].template process<isBypassed>(subMainBuffer, subSideBuffer);
+    }
+
     template<typename FloatType>
     template<bool isBypassed>
     void Controller<FloatType>::processParallelPost(juce::AudioBuffer<FloatType> &subMainBuffer,
@@ -437,10 +715,14 @@ namespace zlDSP {
     void Controller<FloatType>::processParallelPostLRMS(const size_t lrIdx, const bool shouldParallel,
                                                         juce::AudioBuffer<FloatType> &subMainBuffer,
                                                         juce::AudioBuffer<FloatType> &subSideBuffer) {
+        if (shouldParallel) {
+            parallelBanks[lrIdx].processPost(subMainBuffer);
+            return;
+        }
         const auto &indices{filterLRIndices[lrIdx]};
         for (size_t idx = 0; idx < indices.size(); ++idx) {
             const auto i = indices[idx];
-            if (filters[i].getMainFilter().getShouldBeParallel() == shouldParallel) {
+            if (!filters[i].getMainFilter().getShouldBeParallel()) {
                 if (currentIsBypass[i] || isBypassed) {
                     filters[i].template processParallelPost<true>(subMainBuffer, subSideBuffer);
                 } else {
@@ -453,66 +735,20 @@ namespace zlDSP {
     template<typename FloatType>
     template<bool isBypassed>
     void Controller<FloatType>::processPrototypeCorrection(juce::AudioBuffer<FloatType> &subMainBuffer) {
-        prototypeCorrections[0].template process<isBypassed>(subMainBuffer);
-        if (useLR) {
-            lrMainSplitter.split(subMainBuffer);
-            prototypeCorrections[1].template process<isBypassed>(lrMainSplitter.getLBuffer());
-            prototypeCorrections[2].template process<isBypassed>(lrMainSplitter.getRBuffer());
-            lrMainSplitter.combine(subMainBuffer);
-        }
-        if (useMS) {
-            msMainSplitter.split(subMainBuffer);
-            prototypeCorrections[3].template process<isBypassed>(msMainSplitter.getMBuffer());
-            prototypeCorrections[4].template process<isBypassed>(msMainSplitter.getSBuffer());
-            msMainSplitter.combine(subMainBuffer);
-        }
+        prototypeStage.template process<isBypassed>(subMainBuffer);
     }
 
     template<typename FloatType>
     template<bool isBypassed>
     void Controller<FloatType>::processMixedCorrection(juce::AudioBuffer<FloatType> &subMainBuffer) {
-        mixedCorrections[0].template process<isBypassed>(subMainBuffer);
-        if (useLR) {
-            lrMainSplitter.split(subMainBuffer);
-            mixedCorrections[1].template process<isBypassed>(lrMainSplitter.getLBuffer());
-            mixedCorrections[2].template process<isBypassed>(lrMainSplitter.getRBuffer());
-            lrMainSplitter.combine(subMainBuffer);
-        }
-        if (useMS) {
-            msMainSplitter.split(subMainBuffer);
-            mixedCorrections[3].template process<isBypassed>(msMainSplitter.getMBuffer());
-            mixedCorrections[4].template process<isBypassed>(msMainSplitter.getSBuffer());
-            msMainSplitter.combine(subMainBuffer);
-        }
+        mixedStage.template process<isBypassed>(subMainBuffer);
     }
 
     template<typename FloatType>
     template<bool isBypassed>
     void Controller<FloatType>::processLinear(juce::AudioBuffer<FloatType> &subMainBuffer) {
-        linearFilters[0].template process<isBypassed>(subMainBuffer);
-        if (currentIsSgcON) {
-            compensationGains[0].template process<isBypassed>(subMainBuffer);
-        }
-        if (useLR) {
-            lrMainSplitter.split(subMainBuffer);
-            linearFilters[1].template process<isBypassed>(lrMainSplitter.getLBuffer());
-            linearFilters[2].template process<isBypassed>(lrMainSplitter.getRBuffer());
-            if (currentIsSgcON) {
-                compensationGains[1].template process<isBypassed>(lrMainSplitter.getLBuffer());
-                compensationGains[2].template process<isBypassed>(lrMainSplitter.getRBuffer());
-            }
-            lrMainSplitter.combine(subMainBuffer);
-        }
-        if (useMS) {
-            msMainSplitter.split(subMainBuffer);
-            linearFilters[3].template process<isBypassed>(msMainSplitter.getMBuffer());
-            linearFilters[4].template process<isBypassed>(msMainSplitter.getSBuffer());
-            if (currentIsSgcON) {
-                compensationGains[3].template process<isBypassed>(msMainSplitter.getMBuffer());
-                compensationGains[4].template process<isBypassed>(msMainSplitter.getSBuffer());
-            }
-            msMainSplitter.combine(subMainBuffer);
-        }
+        // static gain compensations are applied as group gains inside the linear stage
+        linearStage.template process<isBypassed>(subMainBuffer);
     }
 
     template<typename FloatType>
@@ -546,6 +782,10 @@ namespace zlDSP {
         }
         currentLatency += latency.load();
         processorRef.setLatencySamples(currentLatency);
+        if (toNotifyTail.exchange(false)) {
+            // hosts query the tail length together with the latency
+            processorRef.updateHostDisplay(juce::AudioProcessor::ChangeDetails().withLatencyChanged(true));
+        }
     }
 
     template<typename FloatType>
@@ -606,7 +846,7 @@ namespace zlDSP {
     template<typename FloatType>
     void Controller<FloatType>::setRelative(const size_t idx, const bool isRelative) {
         dynRelatives[idx].store(isRelative);
-        updateTrackersON();
+        toUpdateSideChain.store(true);
     }
 
     template<typename FloatType>
@@ -657,6 +897,13 @@ namespace zlDSP {
                 }
             }
         }
+        // the mono signal cannot be processed as a single channel if the output depends on the right channel,
+        // i.e. L/R groups are followed by M/S groups, or parallel L/R/M/S groups are summed up
+        collapseMono = isMono && !(useLR && useMS) &&
+                       !(currentFilterStructure == filterStructure::parallel && (useLR || useMS));
+        prototypeStage.setGroups(useLR, useMS);
+        mixedStage.setGroups(useLR, useMS);
+        linearStage.setGroups(useLR, useMS);
         int newLatency = 0;
         switch (currentFilterStructure) {
             case filterStructure::minimum:
@@ -666,49 +913,44 @@ namespace zlDSP {
                 break;
             }
             case filterStructure::matched: {
-                const auto singleLatency = prototypeCorrections[0].getLatency();
-                newLatency = singleLatency
-                             + static_cast<int>(useLR) * singleLatency
-                             + static_cast<int>(useMS) * singleLatency;
+                newLatency = prototypeStage.getLatency();
                 break;
             }
             case filterStructure::mixed: {
-                const auto singleLatency = mixedCorrections[0].getLatency();
-                newLatency = singleLatency
-                             + static_cast<int>(useLR) * singleLatency
-                             + static_cast<int>(useMS) * singleLatency;
+                newLatency = mixedStage.getLatency();
                 break;
             }
             case filterStructure::linear: {
-                const auto singleLatency = linearFilters[0].getLatency();
-                newLatency = singleLatency
-                             + static_cast<int>(useLR) * singleLatency
-                             + static_cast<int>(useMS) * singleLatency;
+                newLatency = linearStage.getLatency();
                 break;
             }
         }
         if (newLatency != latency.load()) {
             const auto delayInSeconds = static_cast<FloatType>(newLatency) / static_cast<FloatType>(sampleRate.load());
-            fftAnalyzer.getPreDelay().setDelaySeconds(delayInSeconds);
-            fftAnalyzer.getSideDelay().setDelaySeconds(delayInSeconds);
-            conflictAnalyzer.getSideDelay().setDelaySeconds(delayInSeconds);
+            analyzerHub.getPreDelay().setDelaySeconds(delayInSeconds);
+            analyzerHub.getSideDelay().setDelaySeconds(delayInSeconds);
             latency.store(newLatency);
             triggerAsyncUpdate();
         }
     }
 
     template<typename FloatType>
-    void Controller<FloatType>::updateTrackersON() {
+    void Controller<FloatType>::updateSideChain() {
+        // only dynamic bands read the side chain, and only relative ones read the trackers
+        std::fill(useSideGroups.begin(), useSideGroups.end(), false);
         std::fill(useTrackers.begin(), useTrackers.end(), false);
         for (size_t idx = 0; idx < 5; ++idx) {
             const auto &indices{filterLRIndices[idx]};
             for (size_t i = 0; i < indices.size(); ++i) {
-                if (dynRelatives[indices[i]].load()) {
-                    useTrackers[idx] = true;
-                    break;
+                if (filters[indices[i]].getDynamicON()) {
+                    useSideGroups[idx] = true;
+                    useTrackers[idx] = useTrackers[idx] || dynRelatives[indices[i]].load();
                 }
             }
         }
+        useLRSide = useSideGroups[1] || useSideGroups[2];
+        useMSSide = useSideGroups[3] || useSideGroups[4];
+        useSide = useSideGroups[0] || useLRSide || useMSSide;
     }
 
     template<typename FloatType>
@@ -765,9 +1007,7 @@ namespace zlDSP {
                 for (auto &f: mainIdeals) {
                     f.setToUpdate();
                 }
-                for (auto &c: prototypeCorrections) {
-                    c.reset();
-                }
+                prototypeStage.reset();
                 break;
             }
             case filterStructure::mixed: {
@@ -780,18 +1020,14 @@ namespace zlDSP {
                 for (auto &f: mainIdeals) {
                     f.setToUpdate();
                 }
-                for (auto &c: mixedCorrections) {
-                    c.reset();
-                }
+                mixedStage.reset();
                 break;
             }
             case filterStructure::linear: {
                 for (auto &f: mainIdeals) {
                     f.setToUpdate();
                 }
-                for (auto &c: linearFilters) {
-                    c.reset();
-                }
+                linearStage.reset();
                 for (size_t idx = 0; idx < bandNUM; ++idx) {
                     const auto bGain = bFilters[idx].getGain();
                     const auto bQ = bFilters[idx].getQ();
@@ -823,23 +1059,18 @@ namespace zlDSP {
                 }
             }
             compensationGains[lr].setGainLinear(currentSgc);
+            linearStage.setGroupGain(lr, currentSgc);
         }
     }
 
     template<typename FloatType>
     void Controller<FloatType>::updateCorrections() {
         if (currentFilterStructure == filterStructure::matched) {
-            for (auto &c: prototypeCorrections) {
-                c.setToUpdate();
-            }
+            prototypeStage.setToUpdate();
         } else if (currentFilterStructure == filterStructure::mixed) {
-            for (auto &c: mixedCorrections) {
-                c.setToUpdate();
-            }
+            mixedStage.setToUpdate();
         } else if (currentFilterStructure == filterStructure::linear) {
-            for (auto &c: linearFilters) {
-                c.setToUpdate();
-            }
+            linearStage.setToUpdate();
         }
     }
 
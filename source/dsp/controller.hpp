@@ -24,12 +24,14 @@
 #include "phase/phase.hpp"
 #include "container/container.hpp"
 #include "eq_match/eq_match.hpp"
+#include "chore/rt_audit.hpp"
 
 namespace zlDSP {
     template<typename FloatType>
     class Controller final : public juce::AsyncUpdater {
     public:
         static constexpr size_t FilterSize = 16;
+        static constexpr size_t SideFilterSize = zlFilter::DynamicIIR<FloatType, FilterSize>::SideFilterSize;
 
         explicit Controller(juce::AudioProcessor &processor, size_t fftOrder = 12);
 
@@ -83,6 +85,21 @@ namespace zlDSP {
 
         void setEffectON(const bool x) { isEffectON.store(x); }
 
+        /**
+         * set the level below which the input is considered silent, -240 dB (digital silence) by default
+         * @param x level in dB
+         */
+        void setSilenceFloor(const FloatType x) {
+            silenceFloor.store(juce::Decibels::decibelsToGain(x, FloatType(-240)));
+        }
+
+        /**
+         * get the number of samples the output takes to decay after the input becomes silent
+         * including the lookahead, the latency and the release of dynamic bands
+         * it is rounded up to a power of two, and the host is notified when it changes
+         */
+        int getTailSamples() const { return tailSamples.load(); }
+
         zlFFT::PrePostFFTAnalyzer<FloatType> &getAnalyzer() { return fftAnalyzer; }
 
         zlFFT::ConflictAnalyzer<FloatType> &getConflictAnalyzer() { return conflictAnalyzer; }
@@ -164,6 +181,9 @@ namespace zlDSP {
                         zlFilter::DynamicIIR<FloatType, FilterSize>{std::get<Is>(bFilters), std::get<Is>(tFilters)}...
                     };
                 }(std::make_index_sequence<std::tuple_size_v<decltype(bFilters)> >());
+        zlFilter::IIRCascade<FloatType, FilterSize * 4> staticCascade;
+        zlFilter::BatchDesign<bandNUM> dynamicBatch;
+        std::array<zlFilter::IIRParallelBank<FloatType, bandNUM, FilterSize * 4>, 5> parallelBanks;
 
         std::array<std::atomic<lrType::lrTypes>, bandNUM> filterLRs;
         std::array<lrType::lrTypes, bandNUM> currentFilterLRs{};
@@ -191,6 +211,8 @@ namespace zlDSP {
         std::array<zlFilter::IIRIdle<FloatType, FilterSize>, bandNUM> mainIIRs;
         std::array<zlFilter::Ideal<FloatType, FilterSize>, bandNUM> mainIdeals;
 
+        zlFilter::CorrectionWorker correctionWorker;
+
         std::vector<std::complex<FloatType> > prototypeW1, prototypeW2;
         std::array<zlFilter::PrototypeCorrection<FloatType, bandNUM, FilterSize>, 5> prototypeCorrections =
                 [&]<size_t... Is>(std::index_sequence<Is...>) {
@@ -201,6 +223,8 @@ namespace zlDSP {
                         }...
                     };
                 }(std::make_index_sequence<std::tuple_size_v<decltype(filterLRIndices)> >());
+        zlFilter::StereoCorrection<FloatType, zlFilter::PrototypeCorrection<FloatType, bandNUM, FilterSize> >
+        prototypeStage{prototypeCorrections, correctionWorker};
 
         std::vector<std::complex<FloatType> > mixedW1, mixedW2;
         std::array<zlFilter::MixedCorrection<FloatType, bandNUM, FilterSize>, 5> mixedCorrections =
@@ -211,6 +235,8 @@ namespace zlDSP {
                         }...
                     };
                 }(std::make_index_sequence<std::tuple_size_v<decltype(filterLRIndices)> >());
+        zlFilter::StereoCorrection<FloatType, zlFilter::MixedCorrection<FloatType, bandNUM, FilterSize> >
+        mixedStage{mixedCorrections, correctionWorker};
 
         std::vector<std::complex<FloatType> > linearW1;
         std::array<zlFilter::FIR<FloatType, bandNUM, FilterSize>, 5> linearFilters =
@@ -221,7 +247,8 @@ namespace zlDSP {
                         }...
                     };
                 }(std::make_index_sequence<std::tuple_size_v<decltype(filterLRIndices)> >());
-
+        zlFilter::StereoCorrection<FloatType, zlFilter::FIR<FloatType, bandNUM, FilterSize> >
+        linearStage{linearFilters, correctionWorker};
 
         std::atomic<int> latency{0};
 
@@ -231,6 +258,10 @@ namespace zlDSP {
         std::array<std::atomic<bool>, bandNUM> dynRelatives;
         std::array<zlCompressor::RMSTracker<FloatType>, 5> trackers;
         std::array<bool, 5> useTrackers{};
+        // which groups consume the side chain, i.e. contain a dynamic band
+        std::array<bool, 5> useSideGroups{};
+        bool useSide{false}, useLRSide{false}, useMSSide{false};
+        std::atomic<bool> toUpdateSideChain{true};
 
         std::atomic<bool> sideChain;
 
@@ -246,6 +277,12 @@ namespace zlDSP {
         std::array<std::atomic<bool>, bandNUM> isHistON{};
         std::array<std::atomic<FloatType>, bandNUM> currentThreshold{};
 
+        std::atomic<FloatType> silenceFloor{0};
+        std::atomic<int> tailSamples{0};
+        std::atomic<bool> toNotifyTail{false};
+        int silentSamples{0};
+        bool isIdle{false};
+
         static inline double subBufferLength = 0.001;
         zlAudioBuffer::FixedAudioBuffer<FloatType> subBuffer;
 
@@ -264,6 +301,9 @@ namespace zlDSP {
 
         zlEqMatch::EqMatchAnalyzer<FloatType> matchAnalyzer;
 
+        // declared after analyzers so that the hub thread stops before they are destroyed
+        zlFFT::SpectrumHub<FloatType> analyzerHub;
+
         std::atomic<double> sampleRate{48000};
 
         std::atomic<bool> isZeroLatency{false};
@@ -273,6 +313,13 @@ namespace zlDSP {
         std::atomic<filterStructure::FilterStructure> mFilterStructure{filterStructure::minimum};
         filterStructure::FilterStructure currentFilterStructure{filterStructure::minimum};
 
+        // whether the engine runs a single main channel and a single side channel, set in prepare()
+        bool isMono{false};
+        // whether the mono signal can be processed as a single channel with the current routing
+        // otherwise it is expanded into identical stereo channels for the dynamic filters
+        bool collapseMono{false};
+        juce::AudioBuffer<FloatType> monoExpandBuffer, monoSideBuffer;
+
         void processSubBuffer(juce::AudioBuffer<FloatType> &subMainBuffer,
                               juce::AudioBuffer<FloatType> &subSideBuffer);
 
@@ -283,10 +330,18 @@ namespace zlDSP {
         void processSolo(juce::AudioBuffer<FloatType> &subMainBuffer,
                          juce::AudioBuffer<FloatType> &subSideBuffer);
 
+        template<bool isBypassed = false>
+        void processDynamicAndParallel(juce::AudioBuffer<FloatType> &subMainBuffer,
+                                       juce::AudioBuffer<FloatType> &subSideBuffer);
+
         template<bool isBypassed = false>
         void processDynamic(juce::AudioBuffer<FloatType> &subMainBuffer,
                             juce::AudioBuffer<FloatType> &subSideBuffer);
 
+        template<bool isBypassed = false>
+        void processDynamicMono(juce::AudioBuffer<FloatType> &subMainBuffer,
+                                juce::AudioBuffer<FloatType> &subSideBuffer);
+
         template<bool isBypassed = false>
         void processDynamicLRMS(size_t lrIdx,
                                 juce::AudioBuffer<FloatType> &subMainBuffer,
@@ -296,6 +351,11 @@ namespace zlDSP {
         void processParallelPost(juce::AudioBuffer<FloatType> &subMainBuffer,
                                  juce::AudioBuffer<FloatType> &subSideBuffer);
 
+        template<bool isBypassed = false>
+        void processDynamicFilter(size_t lrIdx, size_t i,
+                                  juce::AudioBuffer<FloatType> &subMainBuffer,
+                                  juce::AudioBuffer<FloatType> &subSideBuffer);
+
         template<bool isBypassed = false>
         void processParallelPostLRMS(size_t lrIdx,
                                      bool shouldParallel,
@@ -311,11 +371,21 @@ namespace zlDSP {
         template<bool isBypassed = false>
         void processLinear(juce::AudioBuffer<FloatType> &subMainBuffer);
 
+        bool updateIdle(juce::AudioBuffer<FloatType> &mainBuffer, juce::AudioBuffer<FloatType> &sideBuffer);
+
+        void clearTails();
+
+        int updateTailSamples();
+
+        int getDynamicTailSamples();
+
+        bool getIsModulating();
+
         void updateLRs();
 
         void updateDynamicONs();
 
-        void updateTrackersON();
+        void updateSideChain();
 
         void updateSgcValues();
 
@@ -10,4 +10,6 @@
 #ifndef ZL_CONVOLUTION_HPP
 #define ZL_CONVOLUTION_HPP
 
+#include "uniform_partition_conv.hpp"
+
 #endif //ZL_CONVOLUTION_HPP
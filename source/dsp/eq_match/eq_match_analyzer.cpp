@@ -11,8 +11,8 @@
 
 namespace zlEqMatch {
     template<typename FloatType>
-    EqMatchAnalyzer<FloatType>::EqMatchAnalyzer(const size_t fftOrder)
-        : Thread("eq_match_analyzer"), fftAnalyzer(fftOrder) {
+    EqMatchAnalyzer<FloatType>::EqMatchAnalyzer(zlFFT::SpectrumHub<FloatType> &hub, const size_t fftOrder)
+        : hubRef(hub), fftAnalyzer(fftOrder) {
         std::fill(mainDBs.begin(), mainDBs.end(), 0.f);
         std::fill(targetDBs.begin(), targetDBs.end(), 0.f);
         std::fill(diffs.begin(), diffs.end(), 0.f);
@@ -26,11 +26,17 @@ namespace zlEqMatch {
     }
 
     template<typename FloatType>
-    void EqMatchAnalyzer<FloatType>::process(juce::AudioBuffer<FloatType> &bBuffer,
-                                             juce::AudioBuffer<FloatType> &tBuffer) {
-        if (isON.load()) {
-            fftAnalyzer.process({bBuffer, tBuffer});
-        }
+    void EqMatchAnalyzer<FloatType>::consumeSpectra(
+        const std::array<const zlFFT::Spectrum *, zlFFT::spectrumSignalNUM> &spectra) {
+        const auto *mainSpectrum = spectra[zlFFT::preSignal];
+        const auto *targetSpectrum = spectra[zlFFT::sideSignal];
+        fftAnalyzer.run({
+                            mainSpectrum == nullptr ? nullptr : mainSpectrum->dBs.data(),
+                            targetSpectrum == nullptr ? nullptr : targetSpectrum->dBs.data()
+                        }, {
+                            mainSpectrum == nullptr ? 0.f : mainSpectrum->ms,
+                            targetSpectrum == nullptr ? 0.f : targetSpectrum->ms
+                        });
     }
 
     template<typename FloatType>
@@ -40,17 +46,12 @@ namespace zlEqMatch {
                 fftAnalyzer.setON(0, true);
                 fftAnalyzer.setON(1, true);
                 isON.store(true);
-                if (!isThreadRunning()) {
-                    startThread(Priority::low);
-                }
             } else {
                 isON.store(false);
                 fftAnalyzer.setON(0, false);
                 fftAnalyzer.setON(1, false);
-                if (isThreadRunning()) {
-                    stopThread(-1);
-                }
             }
+            hubRef.updateThread();
         }
     }
 
@@ -59,19 +60,9 @@ namespace zlEqMatch {
         fftAnalyzer.reset();
     }
 
-    template<typename FloatType>
-    void EqMatchAnalyzer<FloatType>::run() {
-        juce::ScopedNoDenormals noDenormals;
-        while (!threadShouldExit()) {
-            fftAnalyzer.run();
-            const auto flag = wait(-1);
-            juce::ignoreUnused(flag);
-        }
-    }
-
     template<typename FloatType>
     void EqMatchAnalyzer<FloatType>::checkRun() {
-        notify();
+        hubRef.trigger();
     }
 
     template<typename FloatType>
@@ -14,7 +14,7 @@
 
 namespace zlEqMatch {
     template<typename FloatType>
-    class EqMatchAnalyzer final : private juce::Thread {
+    class EqMatchAnalyzer final : public zlFFT::SpectrumConsumer {
     public:
         enum MatchMode {
             matchSide,
@@ -25,11 +25,25 @@ namespace zlEqMatch {
         static constexpr size_t pointNum = 251, smoothSize = 11;
         static constexpr float avgDB = -36.f;
 
-        explicit EqMatchAnalyzer(size_t fftOrder = 12);
+        explicit EqMatchAnalyzer(zlFFT::SpectrumHub<FloatType> &hub, size_t fftOrder = 12);
 
-        void prepare(const juce::dsp::ProcessSpec &spec);
+        void prepare(const juce::dsp::ProcessSpec &spec) override;
 
-        void process(juce::AudioBuffer<FloatType> &bBuffer, juce::AudioBuffer<FloatType> &tBuffer);
+        size_t getFFTSize() const override { return fftAnalyzer.getFFTSize(); }
+
+        size_t getBinSize() const override { return fftAnalyzer.getBinSize(); }
+
+        bool isSpectrumON() const override { return isON.load(); }
+
+        bool isSignalON(const size_t signal) const override {
+            return signal == zlFFT::preSignal || signal == zlFFT::sideSignal;
+        }
+
+        bool isReadyForSpectra(const int numNewSamples) override {
+            return fftAnalyzer.getReadyForNextFFT(numNewSamples);
+        }
+
+        void consumeSpectra(const std::array<const zlFFT::Spectrum *, zlFFT::spectrumSignalNUM> &spectra) override;
 
         zlFFT::AverageFFTAnalyzer<FloatType, 2, pointNum> &getAverageFFT() { return fftAnalyzer; }
 
@@ -79,6 +93,7 @@ namespace zlEqMatch {
         }
 
     private:
+        zlFFT::SpectrumHub<FloatType> &hubRef;
         zlFFT::AverageFFTAnalyzer<FloatType, 2, pointNum> fftAnalyzer;
         std::array<float, pointNum> mainDBs{}, targetDBs{}, diffs{};
         std::array<std::atomic<float>, pointNum> atomicTargetDBs{}, atomicDiffs{};
@@ -95,8 +110,6 @@ namespace zlEqMatch {
         float rescale = 1.f;
         std::array<float, pointNum + smoothSize - 1> originalDiffs{};
 
-        void run() override;
-
         void updateSmooth() {
             if (toUpdateSmooth.exchange(false)) {
                 smoothKernel[smoothSize / 2] = 1.0;
@@ -9,6 +9,9 @@
 
 #ifndef ZLEQMATCH_EQ_MATCH_OPTIMIZER_HPP
 #define ZLEQMATCH_EQ_MATCH_OPTIMIZER_HPP
+
+#include <limits>
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wswitch-enum"
 #pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
@@ -28,19 +31,23 @@ namespace zlEqMatch {
         static constexpr double minQLog = -2.3025850929940455, maxQLog = 2.302585092994046;
         static constexpr std::array<double, 3> lowerBound{minFreqLog, minGain * gainScale, minQLog};
         static constexpr std::array<double, 3> upperBound{maxFreqLog, maxGain * gainScale, maxQLog};
-        static constexpr std::array algos1{
-            nlopt::algorithm::LD_MMA, nlopt::algorithm::LD_SLSQP, nlopt::algorithm::LD_VAR2
-        };
         static constexpr std::array algos2{
-            nlopt::algorithm::GN_CRS2_LM, nlopt::algorithm::GN_CRS2_LM, nlopt::algorithm::LD_SLSQP
+            nlopt::algorithm::GN_CRS2_LM, nlopt::algorithm::GN_CRS2_LM
         };
+        static constexpr int maxGlobalEval = 2000;
+        static constexpr size_t maxLMIter = 100;
+        static constexpr double initLambda = 1e-3, maxLambda = 1e10, lmTol = 1e-6;
         static constexpr std::array<zlFilter::FilterType, 3> filterTypes{
             zlFilter::FilterType::lowShelf, zlFilter::FilterType::peak, zlFilter::FilterType::highShelf
         };
         static constexpr size_t maximumOrder = 6;
+        static constexpr size_t maximumOrderNum = 3;
+        // each stochastic pass of each filter type and order is a candidate of its own
+        static constexpr size_t maximumCandidateNum = algos2.size() * filterTypes.size() * maximumOrderNum;
         static constexpr std::array<double, 3> initSol{6.214608098422191, 0.0, -0.3465735902799726};
 
-        EqMatchOptimizer() {
+        EqMatchOptimizer()
+            : workers(std::clamp(juce::SystemStats::getNumCpus(), 1, static_cast<int>(maximumCandidateNum))) {
             mFilter.prepare(48000.0);
         }
 
@@ -49,6 +56,10 @@ namespace zlEqMatch {
         void setDiffs(const double *diffs, const size_t diffsSize) {
             mFilter.prepare(48000.0);
             mFilter.prepareDBSize(diffsSize);
+            for (auto &candidate: candidates) {
+                candidate.filter.prepare(48000.0);
+                candidate.filter.prepareDBSize(diffsSize);
+            }
             const auto deltaLog = (diffMaxFreqLog - diffMinFreqLog) / (static_cast<double>(diffsSize) - 1.0);
             auto currentLog = diffMinFreqLog;
             mWs.resize(diffsSize);
@@ -66,30 +77,32 @@ namespace zlEqMatch {
             shouldExit.store(false);
             endIdx = std::min(endIdx, mDiffs.size() - 1);
             startIdx = std::min(startIdx, endIdx);
-            std::vector<nlopt::algorithm> mAlgos;
-            mAlgos.resize(algos1.size());
-            std::copy(algos1.begin(), algos1.end(), mAlgos.begin());
             for (size_t i = 0; i < FilterNum; i++) {
-                std::array<double, filterTypes.size()> mse{};
-                std::array<std::vector<double>, filterTypes.size()> sols{};
-                for (size_t j = 0; j < filterTypes.size(); j++) {
-                    mFilter.setFilterType(filterTypes[j]);
-                    sols[j].resize(initSol.size());
-                    std::copy(initSol.begin(), initSol.end(), sols[j].begin());
-                    mse[j] = improveSolution(sols[j], mAlgos, startIdx, endIdx);
-                }
-                const auto idx = static_cast<size_t>(std::min_element(mse.begin(), mse.end()) - mse.begin());
-                mseS[idx] = mse[idx];
+                // fit all filter types concurrently
+                runCandidates(filterTypes.size(), [&](const size_t j) {
+                    auto &candidate = candidates[j];
+                    candidate.filter.setFilterType(filterTypes[j]);
+                    candidate.filter.setOrder(2);
+                    candidate.sol.resize(initSol.size());
+                    std::copy(initSol.begin(), initSol.end(), candidate.sol.begin());
+                    candidate.mse = improveSolutionLM(candidate.filter, candidate.sol, startIdx, endIdx);
+                });
+                if (shouldExit.load()) { return; }
+                const auto idx = getMinCandidate(0, filterTypes.size());
+                const auto &sol = candidates[idx].sol;
+                mseS[i] = candidates[idx].mse;
                 filters[i].setFilterType(filterTypes[idx]);
-                filters[i].setFreq(std::exp(sols[idx][0]));
-                filters[i].setGain(sols[idx][1] / gainScale);
-                filters[i].setQ(std::exp(sols[idx][2]));
+                filters[i].setOrder(2);
+                filters[i].setFreq(std::exp(sol[0]));
+                filters[i].setGain(sol[1] / gainScale);
+                filters[i].setQ(std::exp(sol[2]));
                 updateDiff(filters[i]);
                 // if mse is already small enough, exit
                 if (mseS[i] < eps) {
                     for (size_t j = i + 1; j < filters.size(); j++) {
                         mseS[j] = mseS[i];
                         filters[j].setFilterType(zlFilter::FilterType::peak);
+                        filters[j].setOrder(2);
                         filters[j].setFreq(500.);
                         filters[j].setGain(0.);
                         filters[j].setQ(0.707);
@@ -107,36 +120,37 @@ namespace zlEqMatch {
             shouldExit.store(false);
             endIdx = std::min(endIdx, mDiffs.size());
             startIdx = std::min(startIdx, endIdx);
-            std::vector<nlopt::algorithm> mAlgos1, mAlgos2;
-            mAlgos1.resize(algos1.size());
-            std::copy(algos1.begin(), algos1.end(), mAlgos1.begin());
-            mAlgos2.resize(algos2.size());
-            std::copy(algos2.begin(), algos2.end(), mAlgos2.begin());
+            if (orders.size() > maximumOrderNum) {
+                orders.resize(maximumOrderNum);
+            }
             // fit filter one by one
             for (size_t i = 0; i < FilterNum; i++) {
+                constexpr size_t orderStride = filterTypes.size() * algos2.size();
+                // fit all orders, filter types and stochastic passes concurrently
+                // candidate (order k, filter type j, pass p) is stored at k * orderStride + j * algos2.size() + p
+                runCandidates(orders.size() * orderStride, [&](const size_t c) {
+                    auto &candidate = candidates[c];
+                    candidate.filter.setOrder(orders[c / orderStride]);
+                    candidate.filter.setFilterType(filterTypes[c % orderStride / algos2.size()]);
+                    candidate.sol.resize(initSol.size());
+                    std::copy(initSol.begin(), initSol.end(), candidate.sol.begin());
+                    // seed the stochastic search with the band and the candidate index
+                    nlopt::srand(static_cast<unsigned long>(i * maximumCandidateNum + c + 1));
+                    candidate.mse = improveSolution(candidate.filter, candidate.sol, algos2[c % algos2.size()],
+                                                    startIdx, endIdx);
+                    if (shouldExit.load()) { return; }
+                    candidate.mse = improveSolutionLM(candidate.filter, candidate.sol, startIdx, endIdx);
+                });
+                if (shouldExit.load()) { return; }
                 std::vector<double> mseByOrders{};
                 std::vector<zlFilter::FilterType> filterTypeByOrders{};
                 std::vector<std::vector<double> > solsByOrders{};
-                // for all orders
-                for (const size_t order: orders) {
-                    mFilter.setOrder(order);
-                    std::array<double, filterTypes.size()> mse{};
-                    std::array<std::vector<double>, filterTypes.size()> sols{};
-                    // for all filter types
-                    for (size_t j = 0; j < filterTypes.size(); j++) {
-                        mFilter.setFilterType(filterTypes[j]);
-                        sols[j].resize(initSol.size());
-                        std::copy(initSol.begin(), initSol.end(), sols[j].begin());
-                        mse[j] = improveSolution(sols[j], mAlgos2, startIdx, endIdx);
-                        if (shouldExit.load()) { return; }
-                        mse[j] = improveSolution(sols[j], mAlgos1, startIdx, endIdx);
-                        if (shouldExit.load()) { return; }
-                    }
-                    // choose the filter type with the min mse
-                    const auto idx = static_cast<size_t>(std::min_element(mse.begin(), mse.end()) - mse.begin());
-                    mseByOrders.push_back(mse[idx]);
-                    filterTypeByOrders.push_back(filterTypes[idx]);
-                    solsByOrders.push_back(sols[idx]);
+                for (size_t k = 0; k < orders.size(); ++k) {
+                    // choose the filter type and the pass with the min mse
+                    const auto idx = getMinCandidate(k * orderStride, orderStride);
+                    mseByOrders.push_back(candidates[idx].mse);
+                    filterTypeByOrders.push_back(filterTypes[idx % orderStride / algos2.size()]);
+                    solsByOrders.push_back(candidates[idx].sol);
                 }
                 // choose the order with the min mse
                 const auto idx = static_cast<size_t>(
@@ -179,12 +193,53 @@ namespace zlEqMatch {
         }
 
     private:
+        struct Candidate {
+            zlFilter::Ideal<double, maximumOrder> filter;
+            std::vector<double> sol;
+            double mse{0.0};
+        };
+
         std::array<zlFilter::Empty<double>, FilterNum> filters;
         std::array<double, FilterNum> mseS{};
         zlFilter::Ideal<double, maximumOrder> mFilter;
+        std::array<Candidate, maximumCandidateNum> candidates;
         std::vector<double> mDiffs;
         std::vector<double> mWs;
         std::atomic<bool> shouldExit{false};
+        // declared after candidates so that jobs stop before candidates are destroyed
+        juce::ThreadPool workers;
+
+        /**
+         * run fitFunc(0), ..., fitFunc(num - 1) on the workers and wait for all of them
+         * each job writes to its own candidate only, so the results do not depend on the scheduling
+         */
+        template<typename FitFunc>
+        void runCandidates(const size_t num, FitFunc &&fitFunc) {
+            std::atomic<size_t> remaining{num};
+            juce::WaitableEvent finished;
+            for (size_t c = 0; c < num; ++c) {
+                workers.addJob([&, c] {
+                    fitFunc(c);
+                    if (remaining.fetch_sub(1) == 1) {
+                        finished.signal();
+                    }
+                });
+            }
+            finished.wait(-1);
+        }
+
+        /**
+         * @return the index of the candidate with the min mse within [startIdx, startIdx + num)
+         */
+        size_t getMinCandidate(const size_t startIdx, const size_t num) const {
+            size_t idx = startIdx;
+            for (size_t j = startIdx + 1; j < startIdx + num; ++j) {
+                if (candidates[j].mse < candidates[idx].mse) {
+                    idx = j;
+                }
+            }
+            return idx;
+        }
         struct optFData {
             size_t startIdx;
             size_t endIdx;
@@ -195,25 +250,16 @@ namespace zlEqMatch {
 
         static double func(const std::vector<double> &x, std::vector<double> &grad, void *f_data) {
             auto *data = static_cast<optFData *>(f_data);
-            const auto mse = calculateMSE(x[0], x[1], x[2],
-                                          data->filter, data->diffs, data->ws, data->startIdx, data->endIdx);
-            if (!grad.empty()) {
-                const auto mse0l = calculateMSE(x[0] - eps, x[1], x[2],
-                                                data->filter, data->diffs, data->ws, data->startIdx, data->endIdx);
-                const auto mse0r = calculateMSE(x[0] + eps, x[1], x[2],
-                                                data->filter, data->diffs, data->ws, data->startIdx, data->endIdx);
-                grad[0] = (mse0r - mse0l) / (2 * eps);
-                const auto mse1l = calculateMSE(x[0], x[1] - eps, x[2],
-                                                data->filter, data->diffs, data->ws, data->startIdx, data->endIdx);
-                const auto mse1r = calculateMSE(x[0], x[1] + eps, x[2],
-                                                data->filter, data->diffs, data->ws, data->startIdx, data->endIdx);
-                grad[1] = (mse1r - mse1l) / (2 * eps);
-                const auto mse2l = calculateMSE(x[0], x[1], x[2] - eps,
-                                                data->filter, data->diffs, data->ws, data->startIdx, data->endIdx);
-                const auto mse2r = calculateMSE(x[0], x[1], x[2] + eps,
-                                                data->filter, data->diffs, data->ws, data->startIdx, data->endIdx);
-                grad[2] = (mse2r - mse2l) / (2 * eps);
+            if (grad.empty()) {
+                return calculateMSE(x[0], x[1], x[2],
+                                    data->filter, data->diffs, data->ws, data->startIdx, data->endIdx);
             }
+            std::array<double, 3> g{};
+            std::array<std::array<double, 3>, 3> h{};
+            const auto mse = calculateMSEAndGrads(x[0], x[1], x[2],
+                                                  data->filter, data->diffs, data->ws, data->startIdx, data->endIdx,
+                                                  g, h);
+            std::copy(g.begin(), g.end(), grad.begin());
             return mse;
         }
 
@@ -234,37 +280,149 @@ namespace zlEqMatch {
             return mse / static_cast<double>(dB.size());
         }
 
-        double improveSolution(std::vector<double> &sol,
-                               const std::vector<nlopt::algorithm> &algos,
+        /**
+         * calculate the mse, its gradient and the Gauss-Newton approximation of its hessian
+         * with the analytic derivatives of the filter
+         */
+        static double calculateMSEAndGrads(const double freqLog, const double gain, const double qLog,
+                                           zlFilter::Ideal<double, maximumOrder> *filter,
+                                           const std::vector<double> *diffs, const std::vector<double> *ws,
+                                           const size_t startIdx, const size_t endIdx,
+                                           std::array<double, 3> &grad,
+                                           std::array<std::array<double, 3>, 3> &hessian) {
+            filter->setFreq(std::exp(freqLog));
+            filter->setGain(gain / gainScale);
+            filter->setQ(std::exp(qLog));
+            filter->updateMagnitudeAndGrads(*ws);
+            const auto &dB = filter->getDBs();
+            const auto &dBGrads = filter->getDBGrads();
+            // the gain parameter is scaled by gainScale
+            constexpr std::array<double, 3> paraScales{1.0, 1.0 / gainScale, 1.0};
+            double mse = 0.0;
+            grad = {};
+            hessian = {};
+            for (size_t i = startIdx; i < endIdx; ++i) {
+                const auto t = dB[i] - diffs->at(i);
+                mse += t * t;
+                const std::array<double, 3> jacobian{
+                    dBGrads[0][i] * paraScales[0], dBGrads[1][i] * paraScales[1], dBGrads[2][i] * paraScales[2]
+                };
+                for (size_t j = 0; j < 3; ++j) {
+                    grad[j] += t * jacobian[j];
+                    for (size_t k = 0; k < 3; ++k) {
+                        hessian[j][k] += jacobian[j] * jacobian[k];
+                    }
+                }
+            }
+            const auto scale = 2.0 / static_cast<double>(dB.size());
+            for (size_t j = 0; j < 3; ++j) {
+                grad[j] *= scale;
+                for (size_t k = 0; k < 3; ++k) {
+                    hessian[j][k] *= scale;
+                }
+            }
+            return mse / static_cast<double>(dB.size());
+        }
+
+        /**
+         * solve the 3x3 linear system (hessian + lambda * diag(hessian)) * step = -grad
+         * @return false if the system is singular
+         */
+        static bool solveLMStep(const std::array<double, 3> &grad,
+                                const std::array<std::array<double, 3>, 3> &hessian,
+                                const double lambda, std::array<double, 3> &step) {
+            auto a = hessian;
+            for (size_t j = 0; j < 3; ++j) {
+                a[j][j] += lambda * std::max(hessian[j][j], 1e-9);
+            }
+            const auto det = a[0][0] * (a[1][1] * a[2][2] - a[1][2] * a[2][1])
+                             - a[0][1] * (a[1][0] * a[2][2] - a[1][2] * a[2][0])
+                             + a[0][2] * (a[1][0] * a[2][1] - a[1][1] * a[2][0]);
+            if (!std::isfinite(det) || std::abs(det) < 1e-300) { return false; }
+            // Cramer's rule
+            for (size_t j = 0; j < 3; ++j) {
+                auto b = a;
+                for (size_t k = 0; k < 3; ++k) {
+                    b[k][j] = -grad[k];
+                }
+                step[j] = (b[0][0] * (b[1][1] * b[2][2] - b[1][2] * b[2][1])
+                           - b[0][1] * (b[1][0] * b[2][2] - b[1][2] * b[2][0])
+                           + b[0][2] * (b[1][0] * b[2][1] - b[1][1] * b[2][0])) / det;
+            }
+            return true;
+        }
+
+        /**
+         * improve the solution with a bounded Levenberg-Marquardt solver
+         * @return the mse of the improved solution
+         */
+        double improveSolutionLM(zlFilter::Ideal<double, maximumOrder> &filter, std::vector<double> &sol,
+                                 const size_t startIdx, const size_t endIdx) {
+            std::array<double, 3> x{};
+            for (size_t j = 0; j < 3; ++j) {
+                x[j] = std::clamp(sol[j], lowerBound[j], upperBound[j]);
+            }
+            std::array<double, 3> grad{};
+            std::array<std::array<double, 3>, 3> hessian{};
+            auto mse = calculateMSEAndGrads(x[0], x[1], x[2], &filter, &mDiffs, &mWs,
+                                            startIdx, endIdx, grad, hessian);
+            auto lambda = initLambda;
+            for (size_t iter = 0; iter < maxLMIter && mse > eps && lambda < maxLambda; ++iter) {
+                if (shouldExit.load()) { break; }
+                std::array<double, 3> step{};
+                if (!solveLMStep(grad, hessian, lambda, step)) {
+                    lambda *= 10;
+                    continue;
+                }
+                // project the step onto the bounds
+                std::array<double, 3> newX{};
+                for (size_t j = 0; j < 3; ++j) {
+                    newX[j] = std::clamp(x[j] + step[j], lowerBound[j], upperBound[j]);
+                }
+                const auto newMSE = calculateMSE(newX[0], newX[1], newX[2], &filter, &mDiffs, &mWs,
+                                                 startIdx, endIdx);
+                if (newMSE < mse) {
+                    const auto improvement = mse - newMSE;
+                    x = newX;
+                    mse = calculateMSEAndGrads(x[0], x[1], x[2], &filter, &mDiffs, &mWs,
+                                               startIdx, endIdx, grad, hessian);
+                    lambda = std::max(lambda * .3, 1e-9);
+                    if (improvement < lmTol * std::max(mse, 1.0)) { break; }
+                } else {
+                    lambda *= 4;
+                }
+            }
+            std::copy(x.begin(), x.end(), sol.begin());
+            return mse;
+        }
+
+        double improveSolution(zlFilter::Ideal<double, maximumOrder> &filter, std::vector<double> &sol,
+                               const nlopt::algorithm algo,
                                const size_t startIdx, const size_t endIdx) {
-            optFData optData{startIdx, endIdx, &mFilter, &mDiffs, &mWs};
-            double bestMSE = 1e6;
-            std::vector<double> bestSol = sol;
+            // an aborted candidate must never win the selection
+            if (shouldExit.load()) { return std::numeric_limits<double>::infinity(); }
+            optFData optData{startIdx, endIdx, &filter, &mDiffs, &mWs};
             const std::vector<double> mLowerBound{minFreqLog, minGainScale, minQLog};
             const std::vector<double> mUpperBound{maxFreqLog, maxGainScale, maxQLog};
-            for (const auto &algo: algos) {
-                if (shouldExit.load()) { return 0.f; }
-                auto opt = nlopt::opt(algo, 3);
-                opt.set_min_objective(func, &optData);
-                opt.set_lower_bounds(mLowerBound);
-                opt.set_upper_bounds(mUpperBound);
-                opt.set_stopval(eps);
-                opt.set_xtol_abs(1e-3);
-                opt.set_population(80);
-                opt.set_maxtime(1);
-                try {
-                    std::vector<double> currentSol = sol;
-                    double currentMSE = 0.0;
-                    const auto res = opt.optimize(currentSol, currentMSE);
-                    if (res >= 0 && currentMSE < bestMSE) {
-                        bestSol = currentSol;
-                        bestMSE = currentMSE;
-                    }
-                } catch (...) {
+            auto opt = nlopt::opt(algo, 3);
+            opt.set_min_objective(func, &optData);
+            opt.set_lower_bounds(mLowerBound);
+            opt.set_upper_bounds(mUpperBound);
+            opt.set_stopval(eps);
+            opt.set_xtol_abs(1e-3);
+            opt.set_population(80);
+            opt.set_maxeval(maxGlobalEval);
+            try {
+                std::vector<double> currentSol = sol;
+                double currentMSE = 0.0;
+                const auto res = opt.optimize(currentSol, currentMSE);
+                if (res >= 0) {
+                    sol = currentSol;
+                    return currentMSE;
                 }
+            } catch (...) {
             }
-            sol = bestSol;
-            return bestMSE;
+            return 1e6;
         }
 
         void updateDiff(const zlFilter::Empty<double> &eFilter) {
@@ -15,16 +15,13 @@
 
 namespace zlFFT {
     /**
-         * a fft analyzer which make sure that multiple FFTs are synchronized in time
+         * a fft analyzer which averages multiple spectra (computed by the spectrum hub) weighted by loudness
          * @tparam FloatType the float type of input audio buffers
          * @tparam FFTNum the number of FFTs
          * @tparam PointNum the number of output points
          */
     template<typename FloatType, size_t FFTNum, size_t PointNum>
     class AverageFFTAnalyzer final {
-    private:
-        juce::SpinLock spinLock;
-
     public:
         static constexpr float minFreq = 10.f, maxFreq = 22000.f, minDB = -72.f;
         static constexpr float minFreqLog2 = 3.321928094887362f;
@@ -94,7 +91,6 @@ namespace zlFFT {
         }
 
         void prepare(const juce::dsp::ProcessSpec &spec) {
-            juce::GenericScopedLock lock(spinLock);
             sampleRate.store(static_cast<float>(spec.sampleRate));
             if (spec.sampleRate <= 50000) {
                 setOrder(static_cast<int>(defaultFFTOrder));
@@ -118,12 +114,8 @@ namespace zlFFT {
         }
 
         void setOrder(int fftOrder) {
-            fft = std::make_unique<juce::dsp::FFT>(fftOrder);
-            window = std::make_unique<
-                juce::dsp::WindowingFunction<float> >(static_cast<size_t>(fft->getSize()),
-                                                      juce::dsp::WindowingFunction<float>::hann,
-                                                      true);
-            fftSize.store(static_cast<size_t>(fft->getSize()));
+            const auto tempSize = static_cast<size_t>(1) << static_cast<size_t>(fftOrder);
+            fftSize.store(tempSize);
 
             const float deltaT = sampleRate.load() / static_cast<float>(fftSize.load());
 
@@ -134,97 +126,20 @@ namespace zlFFT {
             for (size_t i = 0; i < FFTNum; ++i) {
                 std::fill(smoothedDBs[i].begin(), smoothedDBs[i].end(), minDB * 2.f);
             }
-
-            const auto tempSize = fft->getSize();
-            fftBuffer.resize(static_cast<size_t>(tempSize * 2));
-            abstractFIFO.setTotalSize(tempSize);
-            for (size_t i = 0; i < FFTNum; ++i) {
-                sampleFIFOs[i].resize(static_cast<size_t>(tempSize));
-                circularBuffers[i].resize(static_cast<size_t>(tempSize));
-            }
-            readyNum.store(tempSize / 2);
-        }
-
-        /**
-         * put input samples into FIFOs
-         * @param buffers
-         */
-        void process(std::array<std::reference_wrapper<juce::AudioBuffer<FloatType> >, FFTNum> buffers) {
-            int freeSpace = abstractFIFO.getFreeSpace();
-            for (size_t i = 0; i < FFTNum; ++i) {
-                if (!isON[i].load()) { continue; }
-                freeSpace = std::min(freeSpace, buffers[i].get().getNumSamples());
-            }
-            if (freeSpace == 0) { return; }
-            const auto scope = abstractFIFO.write(freeSpace);
-            for (size_t i = 0; i < FFTNum; ++i) {
-                if (!isON[i].load()) { continue; }
-                int j = 0;
-                const auto &buffer{buffers[i]};
-                const FloatType avgScale = FloatType(1) / static_cast<FloatType>(buffer.get().getNumChannels());
-                int shift = 0;
-                for (; j < scope.blockSize1; ++j) {
-                    FloatType sample{0};
-                    for (int channel = 0; channel < buffer.get().getNumChannels(); ++channel) {
-                        sample += buffer.get().getSample(channel, j);
-                    }
-                    sample *= avgScale;
-                    sampleFIFOs[i][static_cast<size_t>(shift + scope.startIndex1)] = static_cast<float>(sample);
-                    shift += 1;
-                }
-                shift = 0;
-                for (; j < scope.blockSize1 + scope.blockSize2; ++j) {
-                    FloatType sample{0};
-                    for (int channel = 0; channel < buffer.get().getNumChannels(); ++channel) {
-                        sample += buffer.get().getSample(channel, j);
-                    }
-                    sample *= avgScale;
-                    sampleFIFOs[i][static_cast<size_t>(shift + scope.startIndex2)] = static_cast<float>(sample);
-                    shift += 1;
-                }
-            }
+            readyNum.store(static_cast<int>(tempSize / 2));
+            pendingNum = 0;
         }
 
         /**
-         * run the forward FFT
+         * average the spectra and interpolate them to output points
+         * @param dBs magnitudes in dB from DC, at least binSize of them, nullptr if the spectrum is not available
+         * @param mss mean squares of the frames
          */
-        void run() {
-            juce::GenericScopedLock lock(spinLock);
+        void run(const std::array<const float *, FFTNum> &dBs, const std::array<float, FFTNum> &mss) {
             if (!isPrepared.load()) {
                 return;
             }
-            if (!getReadyForNextFFT()) {
-                return;
-            }
-            std::vector<size_t> isONVector{};
-            for (size_t i = 0; i < FFTNum; ++i) {
-                if (isON[i].load()) isONVector.push_back(i);
-            }
-            // collect data from FIFO
             juce::ScopedNoDenormals noDenormals; {
-                const int numReady = abstractFIFO.getNumReady();
-                const auto scope = abstractFIFO.read(numReady);
-                const size_t numReplace = circularBuffers[0].size() - static_cast<size_t>(numReady);
-                for (const auto &i: isONVector) {
-                    if (!isON[i].load()) { continue; }
-                    auto &circularBuffer{circularBuffers[i]};
-                    auto &sampleFIFO{sampleFIFOs[i]};
-                    size_t j = 0;
-                    for (; j < numReplace; ++j) {
-                        circularBuffer[j] = circularBuffer[j + static_cast<size_t>(numReady)];
-                    }
-                    int shift = 0;
-                    for (; j < numReplace + static_cast<size_t>(scope.blockSize1); ++j) {
-                        circularBuffer[j] = sampleFIFO[static_cast<size_t>(shift + scope.startIndex1)];
-                        shift += 1;
-                    }
-                    shift = 0;
-                    for (; j < numReplace + static_cast<size_t>(scope.blockSize1 + scope.blockSize2); ++j) {
-                        circularBuffer[j] = sampleFIFO[static_cast<size_t>(shift + scope.startIndex2)];
-                        shift += 1;
-                    }
-                }
-            } {
                 // reset if required
                 if (toReset.exchange(false)) {
                     for (size_t i = 0; i < FFTNum; ++i) {
@@ -232,28 +147,21 @@ namespace zlFFT {
                         currentNum[i] = 0.01f;
                     }
                 }
-                // calculate FFT and average results
-                for (const auto &i: isONVector) {
+                // average results
+                for (size_t i = 0; i < FFTNum; ++i) {
+                    if (!isON[i].load() || dBs[i] == nullptr) { continue; }
                     // calculate RMS of current buffer
-                    const float ms = std::inner_product(circularBuffers[i].begin(), circularBuffers[i].end(),
-                                                        circularBuffers[i].begin(), 0.f)
-                                     / static_cast<float>(circularBuffers[i].size());
-                    const float rms = juce::Decibels::gainToDecibels(ms, -160.f) * 0.5f;
+                    const float rms = juce::Decibels::gainToDecibels(mss[i], -160.f) * 0.5f;
                     if (rms < -80.f) { continue; }
                     // calculate loudness weighting
                     const auto weight = calculateWeight(rms);
                     currentNum[i] += weight;
                     const auto newWeight = weight / currentNum[i];
                     const auto oldWeight = 1.f - newWeight;
-                    // perform FFT
-                    std::copy(circularBuffers[i].begin(), circularBuffers[i].end(), fftBuffer.begin());
-                    window->multiplyWithWindowingTable(fftBuffer.data(), fftSize.load());
-                    fft->performFrequencyOnlyForwardTransform(fftBuffer.data());
                     auto &smoothedDB{smoothedDBs[i]};
-                    const auto ampScale = 2.f / static_cast<float>(fftBuffer.size());
                     // calculate rms weighted average dBs
                     for (size_t j = 0; j < smoothedDB.size(); ++j) {
-                        const auto currentDB = juce::Decibels::gainToDecibels(ampScale * fftBuffer[j], -120.f);
+                        const auto currentDB = std::max(dBs[i][j], -120.f);
                         smoothedDB[j] = smoothedDB[j] * oldWeight + currentDB * newWeight;
                     }
                     // calculate seq-akima input dBs
@@ -271,7 +179,8 @@ namespace zlFFT {
             } {
                 const float tiltShiftDelta = tiltShiftTotal / static_cast<float>(PointNum - 1);
                 // apply tilt
-                for (const auto &i: isONVector) {
+                for (size_t i = 0; i < FFTNum; ++i) {
+                    if (!isON[i].load() || dBs[i] == nullptr) { continue; }
                     if (readyFlags[i].load() == false) {
                         float tiltShift = -tiltShiftTotal * .5f;
                         for (size_t idx = 0; idx < PointNum; ++idx) {
@@ -289,19 +198,21 @@ namespace zlFFT {
             for (auto &p: paths) {
                 p.get().clear();
             }
-            std::vector<size_t> isONVector{};
+            std::array<bool, FFTNum> isONs{};
             for (size_t i = 0; i < FFTNum; ++i) {
-                if (isON[i].load()) isONVector.push_back(i);
+                isONs[i] = isON[i].load();
             }
 
-            for (const auto &i: isONVector) {
+            for (size_t i = 0; i < FFTNum; ++i) {
+                if (!isONs[i]) { continue; }
                 if (readyFlags[i].load() == true) {
                     readyDBs[i] = interplotDBs[i];
                 }
                 readyFlags[i].store(false);
             }
             const float width = bound.getWidth(), height = bound.getHeight(), boundY = bound.getY();
-            for (const auto &i: isONVector) {
+            for (size_t i = 0; i < FFTNum; ++i) {
+                if (!isONs[i]) { continue; }
                 const auto &path{paths[i]};
                 path.get().startNewSubPath(bound.getX(), bound.getBottom() + 10.f);
                 for (size_t idx = 0; idx < PointNum; ++idx) {
@@ -329,8 +240,19 @@ namespace zlFFT {
             return readyDBs[i];
         }
 
-        bool getReadyForNextFFT() const {
-            return abstractFIFO.getNumReady() >= readyNum.load();
+        inline size_t getBinSize() const { return binSize; }
+
+        /**
+         * whether enough new samples (half of the FFT size) have arrived for the next average
+         * @param numNewSamples the number of samples arrived since the last call
+         */
+        bool getReadyForNextFFT(const int numNewSamples) {
+            pendingNum += numNewSamples;
+            if (pendingNum >= readyNum.load()) {
+                pendingNum = 0;
+                return true;
+            }
+            return false;
         }
 
         void setWeight(const float x) {
@@ -341,12 +263,6 @@ namespace zlFFT {
         size_t defaultFFTOrder = 12;
         size_t binSize = (1 << (defaultFFTOrder - 1)) + 1;
 
-        std::array<std::vector<float>, FFTNum> sampleFIFOs;
-        std::array<std::vector<float>, FFTNum> circularBuffers;
-        juce::AbstractFifo abstractFIFO{1};
-
-        std::vector<float> fftBuffer;
-
         // smooth dbs over time
         std::array<std::vector<float>, FFTNum> smoothedDBs{};
         std::array<float, FFTNum> currentNum{};
@@ -365,10 +281,9 @@ namespace zlFFT {
         std::array<std::array<float, PointNum>, FFTNum> readyDBs{};
         std::array<std::atomic<bool>, FFTNum> readyFlags;
         std::atomic<int> readyNum{std::numeric_limits<int>::max()};
+        int pendingNum{0};
 
-        std::unique_ptr<juce::dsp::FFT> fft;
-        std::unique_ptr<juce::dsp::WindowingFunction<float> > window;
-        std::atomic<size_t> fftSize;
+        std::atomic<size_t> fftSize{1};
 
         std::atomic<float> sampleRate;
         std::atomic<bool> toReset{true}, toResetOutput{true};
@@ -11,26 +11,16 @@
 
 namespace zlFFT {
     template<typename FloatType>
-    ConflictAnalyzer<FloatType>::ConflictAnalyzer(const size_t fftOrder)
-        : Thread("conflict_analyzer"),
-          syncAnalyzer(fftOrder) {
+    ConflictAnalyzer<FloatType>::ConflictAnalyzer(SpectrumHub<FloatType> &hub, const size_t fftOrder)
+        : hubRef(hub), syncAnalyzer(fftOrder) {
         syncAnalyzer.setDecayRate(0, 0.985f);
         syncAnalyzer.setDecayRate(1, 0.985f);
         syncAnalyzer.setON({true, true});
     }
 
-    template<typename FloatType>
-    ConflictAnalyzer<FloatType>::~ConflictAnalyzer() {
-        if (isThreadRunning()) {
-            stopThread(-1);
-        }
-    }
-
     template<typename FloatType>
     void ConflictAnalyzer<FloatType>::prepare(const juce::dsp::ProcessSpec &spec) {
         syncAnalyzer.prepare(spec);
-        mainBuffer.setSize(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize));
-        refBuffer.setSize(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize));
     }
 
     template<typename FloatType>
@@ -38,72 +28,49 @@ namespace zlFFT {
         syncAnalyzer.reset();
         isON.store(x);
         toReset.store(true);
+        triggerAsyncUpdate();
     }
 
     template<typename FloatType>
-    void ConflictAnalyzer<FloatType>::pushMainBuffer(juce::AudioBuffer<FloatType> &buffer) {
-        currentIsON = isON.load();
-        if (currentIsON) {
-            mainBuffer.makeCopyOf(buffer, true);
+    void ConflictAnalyzer<FloatType>::consumeSpectra(
+        const std::array<const Spectrum *, spectrumSignalNUM> &spectra) {
+        if (spectra[postSignal] == nullptr || spectra[sideSignal] == nullptr) {
+            return;
         }
-    }
-
-    template<typename FloatType>
-    void ConflictAnalyzer<FloatType>::pushRefBuffer(juce::AudioBuffer<FloatType> &buffer) {
-        if (currentIsON) {
-            refBuffer.makeCopyOf(buffer, true);
-            sideDelay.process(refBuffer);
+        syncAnalyzer.run({spectra[postSignal]->dBs.data(), spectra[sideSignal]->dBs.data()});
+        const auto &mainDB = syncAnalyzer.getInterplotDBs(0);
+        const auto &refDB = syncAnalyzer.getInterplotDBs(1);
+        const auto mainM = std::reduce(mainDB.begin(), mainDB.end()) / static_cast<float>(mainDB.size());
+        const auto refM = std::reduce(refDB.begin(), refDB.end()) / static_cast<float>(refDB.size());
+        const auto threshold = juce::jmin(static_cast<float>(strength.load()) * (mainM + refM), 0.f);
+
+        if (toReset.exchange(false)) {
+            std::fill(conflicts.begin(), conflicts.end(), 0.f);
         }
-    }
-
-    template<typename FloatType>
-    void ConflictAnalyzer<FloatType>::process() {
-        if (currentIsON) {
-            syncAnalyzer.process({mainBuffer, refBuffer});
+        for (size_t i = 0; i < conflicts.size(); ++i) {
+            const auto fftIdx = 4 * i;
+            const auto dB1 = (mainDB[fftIdx] + mainDB[fftIdx + 1] + mainDB[fftIdx + 2] + mainDB[fftIdx + 3]) *
+                             .25f;
+            const auto dB2 = (refDB[fftIdx] + refDB[fftIdx + 1] + refDB[fftIdx + 2] + refDB[fftIdx + 3]) * .25f;
+            const auto dBMin = juce::jmin(dB1, dB2, 0.001f);
+            conflicts[i] = juce::jmax(conflicts[i] * .98f,
+                                      (dBMin - threshold) / (0.001f - threshold));
+        }
+        for (size_t i = 1; i < conflicts.size() - 1; ++i) {
+            conflicts[i] = conflicts[i] * .75f + (conflicts[i - 1] + conflicts[i + 1]) * .125f;
         }
-    }
-
-    template<typename FloatType>
-    void ConflictAnalyzer<FloatType>::run() {
-        juce::ScopedNoDenormals noDenormals;
-        while (!threadShouldExit()) {
-            syncAnalyzer.run();
-            const auto &mainDB = syncAnalyzer.getInterplotDBs(0);
-            const auto &refDB = syncAnalyzer.getInterplotDBs(1);
-            const auto mainM = std::reduce(mainDB.begin(), mainDB.end()) / static_cast<float>(mainDB.size());
-            const auto refM = std::reduce(refDB.begin(), refDB.end()) / static_cast<float>(refDB.size());
-            const auto threshold = juce::jmin(static_cast<float>(strength.load()) * (mainM + refM), 0.f);
-
-            if (toReset.exchange(false)) {
-                std::fill(conflicts.begin(), conflicts.end(), 0.f);
-            }
-            for (size_t i = 0; i < conflicts.size(); ++i) {
-                const auto fftIdx = 4 * i;
-                const auto dB1 = (mainDB[fftIdx] + mainDB[fftIdx + 1] + mainDB[fftIdx + 2] + mainDB[fftIdx + 3]) *
-                                 .25f;
-                const auto dB2 = (refDB[fftIdx] + refDB[fftIdx + 1] + refDB[fftIdx + 2] + refDB[fftIdx + 3]) * .25f;
-                const auto dBMin = juce::jmin(dB1, dB2, 0.001f);
-                conflicts[i] = juce::jmax(conflicts[i] * .98f,
-                                          (dBMin - threshold) / (0.001f - threshold));
-            }
-            for (size_t i = 1; i < conflicts.size() - 1; ++i) {
-                conflicts[i] = conflicts[i] * .75f + (conflicts[i - 1] + conflicts[i + 1]) * .125f;
-            }
 
-            // calculate the conflict portion
-            const auto scale = static_cast<float>(conflictScale.load());
-            for (size_t i = 0; i < conflicts.size(); ++i) {
-                conflictsP[i] = conflicts[i] * scale;
-                if (conflictsP[i].load() >= 0.01) {
-                    conflictsP[i].store(juce::jmin(.75f, conflictsP[i].load()));
-                } else {
-                    conflictsP[i].store(-1.f);
-                }
+        // calculate the conflict portion
+        const auto scale = static_cast<float>(conflictScale.load());
+        for (size_t i = 0; i < conflicts.size(); ++i) {
+            conflictsP[i] = conflicts[i] * scale;
+            if (conflictsP[i].load() >= 0.01) {
+                conflictsP[i].store(juce::jmin(.75f, conflictsP[i].load()));
+            } else {
+                conflictsP[i].store(-1.f);
             }
-            isConflictReady.store(true);
-            const auto flag = wait(-1);
-            juce::ignoreUnused(flag);
         }
+        isConflictReady.store(true);
     }
 
     template<typename FloatType>
@@ -133,7 +100,8 @@ namespace zlFFT {
 
     template<typename FloatType>
     void ConflictAnalyzer<FloatType>::handleAsyncUpdate() {
-        notify();
+        hubRef.updateThread();
+        hubRef.trigger();
     }
 
     template
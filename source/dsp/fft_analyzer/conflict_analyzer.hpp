@@ -14,7 +14,7 @@
 #include <juce_dsp/juce_dsp.h>
 
 #include "multiple_fft_analyzer.hpp"
-#include "../delay/delay.hpp"
+#include "spectrum_hub.hpp"
 
 namespace zlFFT {
     /**
@@ -22,23 +22,23 @@ namespace zlFFT {
      * @tparam FloatType
      */
     template<typename FloatType>
-    class ConflictAnalyzer final : private juce::Thread, juce::AsyncUpdater {
+    class ConflictAnalyzer final : public SpectrumConsumer, private juce::AsyncUpdater {
     public:
         static constexpr size_t pointNum = 251;
 
-        explicit ConflictAnalyzer(size_t fftOrder = 12);
+        explicit ConflictAnalyzer(SpectrumHub<FloatType> &hub, size_t fftOrder = 12);
 
-        ~ConflictAnalyzer() override;
-
-        void prepare(const juce::dsp::ProcessSpec &spec);
+        void prepare(const juce::dsp::ProcessSpec &spec) override;
 
         void start() {
             toReset.store(true);
-            startThread(juce::Thread::Priority::low);
+            isStarted.store(true);
+            hubRef.updateThread();
         }
 
         void stop() {
-            stopThread(-1);
+            isStarted.store(false);
+            hubRef.updateThread();
         }
 
         void setON(bool x);
@@ -49,11 +49,17 @@ namespace zlFFT {
 
         void setConflictScale(const FloatType x) { conflictScale.store(x); }
 
-        void pushMainBuffer(juce::AudioBuffer<FloatType> &buffer);
+        size_t getFFTSize() const override { return syncAnalyzer.getFFTSize(); }
+
+        size_t getBinSize() const override { return syncAnalyzer.getBinSize(); }
+
+        bool isSpectrumON() const override { return isStarted.load() && isON.load(); }
 
-        void pushRefBuffer(juce::AudioBuffer<FloatType> &buffer);
+        bool isSignalON(const size_t signal) const override {
+            return signal == postSignal || signal == sideSignal;
+        }
 
-        void process();
+        void consumeSpectra(const std::array<const Spectrum *, spectrumSignalNUM> &spectra) override;
 
         void setLeftRight(const float left, const float right) {
             x1.store(left);
@@ -64,24 +70,18 @@ namespace zlFFT {
 
         MultipleFFTAnalyzer<FloatType, 2, pointNum> &getSyncFFT() { return syncAnalyzer; }
 
-        zlDelay::SampleDelay<FloatType> &getSideDelay() { return sideDelay; }
-
     private:
+        SpectrumHub<FloatType> &hubRef;
         MultipleFFTAnalyzer<FloatType, 2, pointNum> syncAnalyzer;
-        juce::AudioBuffer<FloatType> mainBuffer, refBuffer;
         std::atomic<FloatType> strength{.375f}, conflictScale{1.f};
-        std::atomic<bool> isON{false}, isConflictReady{false}, toReset{false};
-        bool currentIsON{false};
+        std::atomic<bool> isStarted{false}, isON{false}, isConflictReady{false}, toReset{false};
 
         std::atomic<float> x1{0.f}, x2{1.f};
         std::array<float, pointNum / 4> conflicts{};
         std::array<std::atomic<float>, pointNum / 4> conflictsP{};
-        zlDelay::SampleDelay<FloatType> sideDelay;
 
         const juce::Colour gColour = juce::Colours::red;
 
-        void run() override;
-
         void handleAsyncUpdate() override;
     };
 } // zlFFT
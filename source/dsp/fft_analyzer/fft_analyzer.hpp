@@ -14,5 +14,6 @@
 #include "conflict_analyzer.hpp"
 #include "multiple_fft_analyzer.hpp"
 #include "average_fft_analyzer.hpp"
+#include "spectrum_hub.hpp"
 
 #endif //ZLEqualizer_FFT_ANALYZER_HPP
@@ -15,7 +15,7 @@
 
 namespace zlFFT {
     /**
-     * a fft analyzer which make sure that multiple FFTs are synchronized in time
+     * a fft analyzer which smooths multiple spectra (computed by the spectrum hub) synchronized in time
      * @tparam FloatType the float type of input audio buffers
      * @tparam FFTNum the number of FFTs
      * @tparam PointNum the number of output points
@@ -23,7 +23,6 @@ namespace zlFFT {
     template<typename FloatType, size_t FFTNum, size_t PointNum>
     class MultipleFFTAnalyzer final {
     private:
-        juce::SpinLock spinLock;
         static constexpr float minFreq = 10.f, maxFreq = 22000.f, minDB = -72.f;
         static constexpr float minFreqLog2 = 3.321928094887362f;
         static constexpr float maxFreqLog2 = 14.425215903299383f;
@@ -94,7 +93,6 @@ namespace zlFFT {
         }
 
         void prepare(const juce::dsp::ProcessSpec &spec) {
-            juce::GenericScopedLock lock(spinLock);
             sampleRate.store(static_cast<float>(spec.sampleRate));
             if (spec.sampleRate <= 50000) {
                 setOrder(static_cast<int>(defaultFFTOrder));
@@ -116,12 +114,7 @@ namespace zlFFT {
         }
 
         void setOrder(int fftOrder) {
-            fft = std::make_unique<juce::dsp::FFT>(fftOrder);
-            window = std::make_unique<
-                juce::dsp::WindowingFunction<float> >(static_cast<size_t>(fft->getSize()),
-                                                      juce::dsp::WindowingFunction<float>::hann,
-                                                      true);
-            fftSize.store(static_cast<size_t>(fft->getSize()));
+            fftSize.store(static_cast<size_t>(1) << static_cast<size_t>(fftOrder));
 
             deltaT.store(sampleRate.load() / static_cast<float>(fftSize.load()));
             decayRate.store(zlState::ffTSpeed::speeds[static_cast<size_t>(zlState::ffTSpeed::defaultI)]);
@@ -133,134 +126,54 @@ namespace zlFFT {
             for (size_t i = 0; i < FFTNum; ++i) {
                 std::fill(smoothedDBs[i].begin(), smoothedDBs[i].end(), minDB * 2.f);
             }
-
-            const auto tempSize = fft->getSize();
-            fftBuffer.resize(static_cast<size_t>(tempSize * 2));
-            abstractFIFO.setTotalSize(tempSize);
-            for (size_t i = 0; i < FFTNum; ++i) {
-                sampleFIFOs[i].resize(static_cast<size_t>(tempSize));
-                circularBuffers[i].resize(static_cast<size_t>(tempSize));
-            }
-        }
-
-        /**
-         * put input samples into FIFOs
-         * @param buffers
-         */
-        void process(std::array<std::reference_wrapper<juce::AudioBuffer<FloatType> >, FFTNum> buffers) {
-            int freeSpace = abstractFIFO.getFreeSpace();
-            for (size_t i = 0; i < FFTNum; ++i) {
-                if (!isON[i].load()) continue;
-                freeSpace = std::min(freeSpace, buffers[i].get().getNumSamples());
-            }
-            if (freeSpace == 0) { return; }
-            const auto scope = abstractFIFO.write(freeSpace);
-            for (size_t i = 0; i < FFTNum; ++i) {
-                if (!isON[i].load()) continue;
-                int j = 0;
-                const auto &buffer{buffers[i]};
-                const FloatType avgScale = FloatType(1) / static_cast<FloatType>(buffer.get().getNumChannels());
-                int shift = 0;
-                for (; j < scope.blockSize1; ++j) {
-                    FloatType sample{0};
-                    for (int channel = 0; channel < buffer.get().getNumChannels(); ++channel) {
-                        sample += buffer.get().getSample(channel, j);
-                    }
-                    sample *= avgScale;
-                    sampleFIFOs[i][static_cast<size_t>(shift + scope.startIndex1)] = static_cast<float>(sample);
-                    shift += 1;
-                }
-                shift = 0;
-                for (; j < scope.blockSize1 + scope.blockSize2; ++j) {
-                    FloatType sample{0};
-                    for (int channel = 0; channel < buffer.get().getNumChannels(); ++channel) {
-                        sample += buffer.get().getSample(channel, j);
-                    }
-                    sample *= avgScale;
-                    sampleFIFOs[i][static_cast<size_t>(shift + scope.startIndex2)] = static_cast<float>(sample);
-                    shift += 1;
-                }
-            }
         }
 
         /**
-         * run the forward FFT
+         * smooth the spectra and interpolate them to output points
+         * @param dBs magnitudes in dB from DC, at least binSize of them, nullptr if the spectrum is not available
          */
-        void run() {
-            juce::GenericScopedLock lock(spinLock);
+        void run(const std::array<const float *, FFTNum> &dBs) {
             if (!isPrepared.load()) {
                 return;
             }
-            std::vector<size_t> isONVector{};
             for (size_t i = 0; i < FFTNum; ++i) {
-                if (isON[i].load()) isONVector.push_back(i);
-            }
+                if (!isON[i].load() || dBs[i] == nullptr) { continue; }
+                const auto decay = actualDecayRate[i].load();
+                auto &smoothedDB{smoothedDBs[i]};
+                if (toReset[i].exchange(false)) {
+                    std::fill(smoothedDB.begin(), smoothedDB.end(), minDB * 2.f);
+                }
+                for (size_t j = 0; j < smoothedDB.size(); ++j) {
+                    const auto currentDB = dBs[i][j];
+                    smoothedDB[j] = currentDB < smoothedDB[j]
+                                        ? smoothedDB[j] * decay + currentDB * (1 - decay)
+                                        : currentDB;
+                }
 
-            juce::ScopedNoDenormals noDenormals; {
-                const int numReady = abstractFIFO.getNumReady();
-                const auto scope = abstractFIFO.read(numReady);
-                const size_t numReplace = circularBuffers[0].size() - static_cast<size_t>(numReady);
-                for (const auto &i: isONVector) {
-                    auto &circularBuffer{circularBuffers[i]};
-                    auto &sampleFIFO{sampleFIFOs[i]};
-                    size_t j = 0;
-                    for (; j < numReplace; ++j) {
-                        circularBuffer[j] = circularBuffer[j + static_cast<size_t>(numReady)];
-                    }
-                    int shift = 0;
-                    for (; j < numReplace + static_cast<size_t>(scope.blockSize1); ++j) {
-                        circularBuffer[j] = sampleFIFO[static_cast<size_t>(shift + scope.startIndex1)];
-                        shift += 1;
-                    }
-                    shift = 0;
-                    for (; j < numReplace + static_cast<size_t>(scope.blockSize1 + scope.blockSize2); ++j) {
-                        circularBuffer[j] = sampleFIFO[static_cast<size_t>(shift + scope.startIndex2)];
-                        shift += 1;
-                    }
+                for (size_t j = 0; j < seqInputDBs.size(); ++j) {
+                    const auto startIdx = seqInputStarts[j];
+                    const auto endIdx = seqInputEnds[j];
+                    seqInputDBs[j] = std::reduce(
+                                         smoothedDB.begin() + startIdx,
+                                         smoothedDB.begin() + endIdx) / static_cast<float>(endIdx - startIdx);
                 }
-            } {
-                for (const auto &i: isONVector) {
-                    std::copy(circularBuffers[i].begin(), circularBuffers[i].end(), fftBuffer.begin());
-                    window->multiplyWithWindowingTable(fftBuffer.data(), fftSize.load());
-                    fft->performFrequencyOnlyForwardTransform(fftBuffer.data());
-                    const auto decay = actualDecayRate[i].load();
-                    auto &smoothedDB{smoothedDBs[i]};
-                    const auto ampScale = 2.f / static_cast<float>(fftBuffer.size());
-                    if (toReset[i].exchange(false)) {
-                        std::fill(smoothedDB.begin(), smoothedDB.end(), minDB * 2.f);
-                    }
-                    for (size_t j = 0; j < smoothedDB.size(); ++j) {
-                        const auto currentDB = juce::Decibels::gainToDecibels(ampScale * fftBuffer[j], -240.f);
-                        smoothedDB[j] = currentDB < smoothedDB[j]
-                                            ? smoothedDB[j] * decay + currentDB * (1 - decay)
-                                            : currentDB;
-                    }
 
-                    for (size_t j = 0; j < seqInputDBs.size(); ++j) {
-                        const auto startIdx = seqInputStarts[j];
-                        const auto endIdx = seqInputEnds[j];
-                        seqInputDBs[j] = std::reduce(
-                                             smoothedDB.begin() + startIdx,
-                                             smoothedDB.begin() + endIdx) / static_cast<float>(endIdx - startIdx);
-                    }
+                seqAkima->prepare();
+                seqAkima->eval(interplotFreqs.data(), preInterplotDBs[i].data(), PointNum);
+            }
 
-                    seqAkima->prepare();
-                    seqAkima->eval(interplotFreqs.data(), preInterplotDBs[i].data(), PointNum);
-                }
-            } {
-                const float totalTilt = tiltSlope.load() + extraTilt.load();
-                const float tiltShiftTotal = (maxFreqLog2 - minFreqLog2) * totalTilt;
-                const float tiltShiftDelta = tiltShiftTotal / static_cast<float>(PointNum - 1);
-
-                for (const auto &i: isONVector) {
-                    if (readyFlags[i].load() == false) {
-                        float tiltShift = -tiltShiftTotal * .5f;
-                        for (size_t idx = 0; idx < PointNum; ++idx) {
-                            interplotDBs[i][idx] = tiltShift + preInterplotDBs[i][idx];
-                            tiltShift += tiltShiftDelta;
-                        }
-                        readyFlags[i].store(true);
+            const float totalTilt = tiltSlope.load() + extraTilt.load();
+            const float tiltShiftTotal = (maxFreqLog2 - minFreqLog2) * totalTilt;
+            const float tiltShiftDelta = tiltShiftTotal / static_cast<float>(PointNum - 1);
+            for (size_t i = 0; i < FFTNum; ++i) {
+                if (!isON[i].load() || dBs[i] == nullptr) { continue; }
+                if (readyFlags[i].load() == false) {
+                    float tiltShift = -tiltShiftTotal * .5f;
+                    for (size_t idx = 0; idx < PointNum; ++idx) {
+                        interplotDBs[i][idx] = tiltShift + preInterplotDBs[i][idx];
+                        tiltShift += tiltShiftDelta;
                     }
+                    readyFlags[i].store(true);
                 }
             }
         }
@@ -270,11 +183,12 @@ namespace zlFFT {
             for (auto &p: paths) {
                 p.get().clear();
             }
-            std::vector<size_t> isONVector{};
+            std::array<bool, FFTNum> isONs{};
             for (size_t i = 0; i < FFTNum; ++i) {
-                if (isON[i].load()) isONVector.push_back(i);
+                isONs[i] = isON[i].load();
             }
-            for (const auto &i: isONVector) {
+            for (size_t i = 0; i < FFTNum; ++i) {
+                if (!isONs[i]) { continue; }
                 if (readyFlags[i].load() == true) {
                     readyDBs[i] = interplotDBs[i];
                     readyFlags[i].store(false);
@@ -282,7 +196,8 @@ namespace zlFFT {
             }
             constexpr auto cubicNum = (PointNum / 7) * 6;
             const float width = bound.getWidth(), height = bound.getHeight(), boundY = bound.getY();
-            for (const auto &i: isONVector) {
+            for (size_t i = 0; i < FFTNum; ++i) {
+                if (!isONs[i]) { continue; }
                 const auto &path{paths[i]};
                 path.get().startNewSubPath(bound.getX(), bound.getBottom() + 10.f);
                 for (size_t idx = 0; idx < PointNum - cubicNum; ++idx) {
@@ -310,6 +225,8 @@ namespace zlFFT {
 
         inline size_t getFFTSize() const { return fftSize.load(); }
 
+        inline size_t getBinSize() const { return binSize; }
+
         void setDecayRate(const size_t idx, const float x) {
             decayRates[idx].store(x);
             updateActualDecayRate();
@@ -348,12 +265,6 @@ namespace zlFFT {
         size_t defaultFFTOrder = 12;
         size_t binSize = (1 << (defaultFFTOrder - 1)) + 1;
 
-        std::array<std::vector<float>, FFTNum> sampleFIFOs;
-        std::array<std::vector<float>, FFTNum> circularBuffers;
-        juce::AbstractFifo abstractFIFO{1};
-
-        std::vector<float> fftBuffer;
-
         // smooth dbs over time
         std::array<std::vector<float>, FFTNum> smoothedDBs{};
         // smooth dbs over high frequency for Akimas input
@@ -374,9 +285,7 @@ namespace zlFFT {
         std::array<std::atomic<float>, FFTNum> decayRates{}, actualDecayRate{};
         std::atomic<float> extraTilt{0.f}, extraSpeed{1.f};
 
-        std::unique_ptr<juce::dsp::FFT> fft;
-        std::unique_ptr<juce::dsp::WindowingFunction<float> > window;
-        std::atomic<size_t> fftSize;
+        std::atomic<size_t> fftSize{1};
 
         std::atomic<float> sampleRate;
         std::array<std::atomic<bool>, FFTNum> toReset;
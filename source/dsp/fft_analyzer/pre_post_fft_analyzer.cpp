@@ -11,57 +11,42 @@
 
 namespace zlFFT {
     template<typename FloatType>
-    PrePostFFTAnalyzer<FloatType>::PrePostFFTAnalyzer(const size_t fftOrder)
-        : Thread("pre_post_analyzer"),
-          fftAnalyzer(fftOrder) {
+    PrePostFFTAnalyzer<FloatType>::PrePostFFTAnalyzer(SpectrumHub<FloatType> &hub, const size_t fftOrder)
+        : hubRef(hub), fftAnalyzer(fftOrder) {
         fftAnalyzer.setON({isPreON.load(), isPostON.load(), isSideON.load()});
     }
 
     template<typename FloatType>
     void PrePostFFTAnalyzer<FloatType>::prepare(const juce::dsp::ProcessSpec &spec) {
         fftAnalyzer.prepare(spec);
-        preBuffer.setSize(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize));
-        postBuffer.setSize(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize));
-        sideBuffer.setSize(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize));
     }
 
     template<typename FloatType>
-    void PrePostFFTAnalyzer<FloatType>::pushPreFFTBuffer(juce::AudioBuffer<FloatType> &buffer) {
-        currentON = isON.load();
-        if (currentON) {
-            currentPreON = isPreON.load();
-            currentPostON = isPostON.load();
-            currentSideON = isSideON.load();
-        }
-        if (currentPreON) {
-            preBuffer.makeCopyOf(buffer, true);
-            preDelay.process(preBuffer);
-        }
-    }
-
-    template<typename FloatType>
-    void PrePostFFTAnalyzer<FloatType>::pushPostFFTBuffer(juce::AudioBuffer<FloatType> &buffer) {
-        if (currentPostON) {
-            postBuffer.makeCopyOf(buffer, true);
+    void PrePostFFTAnalyzer<FloatType>::process() {
+        if (toReset.exchange(false)) {
+            fftAnalyzer.reset();
         }
     }
 
     template<typename FloatType>
-    void PrePostFFTAnalyzer<FloatType>::pushSideFFTBuffer(juce::AudioBuffer<FloatType> &buffer) {
-        if (currentSideON) {
-            sideBuffer.makeCopyOf(buffer, true);
-            sideDelay.process(sideBuffer);
+    bool PrePostFFTAnalyzer<FloatType>::isSignalON(const size_t signal) const {
+        switch (signal) {
+            case preSignal: return isPreON.load();
+            case postSignal: return isPostON.load();
+            case sideSignal: return isSideON.load();
+            default: return false;
         }
     }
 
     template<typename FloatType>
-    void PrePostFFTAnalyzer<FloatType>::process() {
-        if (toReset.exchange(false)) {
-            fftAnalyzer.reset();
-        }
-        if (currentON) {
-            fftAnalyzer.process({preBuffer, postBuffer, sideBuffer});
+    void PrePostFFTAnalyzer<FloatType>::consumeSpectra(
+        const std::array<const Spectrum *, spectrumSignalNUM> &spectra) {
+        std::array<const float *, 3> dBs{};
+        for (size_t i = 0; i < 3; ++i) {
+            dBs[i] = spectra[i] == nullptr ? nullptr : spectra[i]->dBs.data();
         }
+        fftAnalyzer.run(dBs);
+        isPathReady.store(true);
     }
 
     template<typename FloatType>
@@ -93,26 +78,11 @@ namespace zlFFT {
         toReset.store(true);
     }
 
-    template<typename FloatType>
-    void PrePostFFTAnalyzer<FloatType>::run() {
-        juce::ScopedNoDenormals noDenormals;
-        while (!threadShouldExit()) {
-            fftAnalyzer.run();
-            isPathReady.store(true);
-            const auto flag = wait(-1);
-            juce::ignoreUnused(flag);
-        }
-    }
-
     template<typename FloatType>
     void PrePostFFTAnalyzer<FloatType>::handleAsyncUpdate() {
-        const auto x = isON.load();
-        if (x && !isThreadRunning()) {
-            startThread(juce::Thread::Priority::low);
-        } else if (!x && isThreadRunning()) {
-            stopThread(-1);
-        } else if (x) {
-            notify();
+        hubRef.updateThread();
+        if (isON.load()) {
+            hubRef.trigger();
         }
     }
 
@@ -11,29 +11,33 @@
 #define ZLFFT_PRE_POST_FFT_ANALYZER_HPP
 
 #include "multiple_fft_analyzer.hpp"
-#include "../delay/delay.hpp"
+#include "spectrum_hub.hpp"
 
 namespace zlFFT {
     /**
-     * a fft analyzer which process pre, post and side audio buffers
+     * a fft analyzer which displays pre, post and side spectra from the spectrum hub
      * @tparam FloatType the float type of input audio buffers
      */
     template<typename FloatType>
-    class PrePostFFTAnalyzer final : private juce::Thread, juce::AsyncUpdater {
+    class PrePostFFTAnalyzer final : public SpectrumConsumer, private juce::AsyncUpdater {
     public:
         static constexpr size_t pointNum = 251;
 
-        explicit PrePostFFTAnalyzer(size_t fftOrder = 12);
+        explicit PrePostFFTAnalyzer(SpectrumHub<FloatType> &hub, size_t fftOrder = 12);
 
-        void prepare(const juce::dsp::ProcessSpec &spec);
+        void prepare(const juce::dsp::ProcessSpec &spec) override;
 
-        void pushPreFFTBuffer(juce::AudioBuffer<FloatType> &buffer);
+        void process();
 
-        void pushPostFFTBuffer(juce::AudioBuffer<FloatType> &buffer);
+        size_t getFFTSize() const override { return fftAnalyzer.getFFTSize(); }
 
-        void pushSideFFTBuffer(juce::AudioBuffer<FloatType> &buffer);
+        size_t getBinSize() const override { return fftAnalyzer.getBinSize(); }
 
-        void process();
+        bool isSpectrumON() const override { return isON.load(); }
+
+        bool isSignalON(size_t signal) const override;
+
+        void consumeSpectra(const std::array<const Spectrum *, spectrumSignalNUM> &spectra) override;
 
         MultipleFFTAnalyzer<FloatType, 3, pointNum> &getMultipleFFT() { return fftAnalyzer; }
 
@@ -54,23 +58,13 @@ namespace zlFFT {
         void updatePaths(juce::Path &prePath_, juce::Path &postPath_, juce::Path &sidePath_,
                          juce::Rectangle<float> bound);
 
-        zlDelay::SampleDelay<FloatType> &getPreDelay() { return preDelay; }
-
-        zlDelay::SampleDelay<FloatType> &getSideDelay() { return sideDelay; }
-
     private:
+        SpectrumHub<FloatType> &hubRef;
         MultipleFFTAnalyzer<FloatType, 3, pointNum> fftAnalyzer;
-        juce::AudioBuffer<FloatType> preBuffer, postBuffer, sideBuffer;
         std::atomic<bool> isON{false};
         std::atomic<bool> isPreON{true}, isPostON{true}, isSideON{false};
-        bool currentON{false}, currentPreON{true}, currentPostON{true}, currentSideON{false};
-        std::atomic<float> xx, yy, width, height;
-        std::atomic<bool> isBoundReady{false};
         std::atomic<bool> isPathReady{false};
         std::atomic<bool> toReset{false};
-        zlDelay::SampleDelay<FloatType> preDelay, sideDelay;
-
-        void run() override;
 
         void handleAsyncUpdate() override;
     };
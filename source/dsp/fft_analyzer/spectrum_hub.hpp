@@ -0,0 +1,417 @@
+// Copyright (C) 2024 - zsliu98
+// This file is part of ZLEqualizer
+//
+// ZLEqualizer is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License Version 3 as published by the Free Software Foundation.
+//
+// ZLEqualizer is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License along with ZLEqualizer. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ZLFFT_SPECTRUM_HUB_HPP
+#define ZLFFT_SPECTRUM_HUB_HPP
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_dsp/juce_dsp.h>
+#include <bit>
+
+#include "../delay/delay.hpp"
+
+namespace zlFFT {
+    enum SpectrumSignal {
+        preSignal, postSignal, sideSignal, spectrumSignalNUM
+    };
+
+    /**
+     * the windowed spectrum of one signal
+     */
+    struct Spectrum {
+        // magnitudes in dB from DC
+        std::vector<float> dBs;
+        // the mean square of the (un-windowed) frame
+        float ms{0.f};
+    };
+
+    /**
+     * a consumer of the spectrum hub
+     * all functions except prepare, getFFTSize and getBinSize can be called on the hub thread and the audio thread
+     */
+    class SpectrumConsumer {
+    public:
+        virtual ~SpectrumConsumer() = default;
+
+        /**
+         * prepare the consumer, it is called by the hub while the hub thread is stopped
+         */
+        virtual void prepare(const juce::dsp::ProcessSpec &spec) = 0;
+
+        /**
+         * the FFT size of the consumer, it should be fixed after the consumer is prepared
+         */
+        virtual size_t getFFTSize() const = 0;
+
+        /**
+         * the number of bins (from DC) the consumer reads
+         */
+        virtual size_t getBinSize() const = 0;
+
+        /**
+         * whether the consumer is active, the hub thread runs when any consumer is active
+         */
+        virtual bool isSpectrumON() const = 0;
+
+        /**
+         * whether the consumer needs the signal
+         */
+        virtual bool isSignalON(size_t signal) const = 0;
+
+        /**
+         * whether the consumer wants new spectra
+         * @param numNewSamples the number of samples arrived since the last run of the hub
+         */
+        virtual bool isReadyForSpectra(const int numNewSamples) {
+            juce::ignoreUnused(numNewSamples);
+            return true;
+        }
+
+        /**
+         * receive spectra on the hub thread, spectra of signals which are not needed are nullptr
+         */
+        virtual void consumeSpectra(const std::array<const Spectrum *, spectrumSignalNUM> &spectra) = 0;
+    };
+
+    /**
+     * a spectral analysis hub which computes the windowed spectrum of each distinct signal once per hop
+     * consumers subscribe at their own FFT size, consumers with the same FFT size share the same spectra
+     * pre and side signals are delayed so that they stay synchronized with the post signal
+     * @tparam FloatType the float type of input audio buffers
+     */
+    template<typename FloatType>
+    class SpectrumHub final : private juce::Thread {
+    public:
+        static constexpr size_t maxConsumerNum = 4;
+
+        SpectrumHub() : Thread("spectrum_hub") {
+        }
+
+        ~SpectrumHub() override {
+            if (isThreadRunning()) {
+                stopThread(-1);
+            }
+        }
+
+        /**
+         * add a consumer, call it before prepare
+         */
+        void addConsumer(SpectrumConsumer &consumer) {
+            jassert(consumerNum < maxConsumerNum);
+            consumers[consumerNum] = &consumer;
+            consumerNum += 1;
+        }
+
+        /**
+         * prepare the hub and all consumers
+         * the hub thread is stopped during preparation so that the hub thread never needs a lock
+         */
+        void prepare(const juce::dsp::ProcessSpec &spec) {
+            const auto wasRunning = isThreadRunning();
+            if (wasRunning) {
+                stopThread(-1);
+            }
+            isPrepared.store(false);
+            for (size_t c = 0; c < consumerNum; ++c) {
+                consumers[c]->prepare(spec);
+            }
+            for (auto &buffer: signalBuffers) {
+                buffer.setSize(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize));
+            }
+            preDelay.prepare(spec);
+            sideDelay.prepare(spec);
+            // create one FFT engine for each distinct FFT size
+            engineNum = 0;
+            size_t maxFFTSize = 1;
+            for (size_t c = 0; c < consumerNum; ++c) {
+                const auto fftSize = consumers[c]->getFFTSize();
+                size_t idx = 0;
+                while (idx < engineNum && engines[idx].fftSize != fftSize) {
+                    idx += 1;
+                }
+                if (idx == engineNum) {
+                    auto &engine{engines[idx]};
+                    engine.fftSize = fftSize;
+                    engine.binSize = 0;
+                    engine.fft = std::make_unique<juce::dsp::FFT>(
+                        static_cast<int>(std::round(std::log2(static_cast<double>(fftSize)))));
+                    engine.window.resize(fftSize);
+                    juce::dsp::WindowingFunction<float>::fillWindowingTables(
+                        engine.window.data(), fftSize, juce::dsp::WindowingFunction<float>::hann, true);
+                    engine.fftBuffer.resize(fftSize * 2);
+                    engineNum += 1;
+                }
+                engines[idx].binSize = std::max(engines[idx].binSize,
+                                                std::min(consumers[c]->getBinSize(), fftSize / 2 + 1));
+                consumerEngines[c] = idx;
+                maxFFTSize = std::max(maxFFTSize, fftSize);
+            }
+            for (size_t idx = 0; idx < engineNum; ++idx) {
+                for (auto &s: spectra[idx]) {
+                    s.dBs.resize(engines[idx].binSize);
+                }
+            }
+            // FFT sizes are powers of two, so the ring position wraps with a mask
+            abstractFIFO.setTotalSize(static_cast<int>(maxFFTSize));
+            for (size_t i = 0; i < spectrumSignalNUM; ++i) {
+                sampleFIFOs[i].resize(maxFFTSize);
+                rings[i].resize(maxFFTSize);
+                std::fill(rings[i].begin(), rings[i].end(), 0.f);
+            }
+            ringMask = maxFFTSize - 1;
+            ringPos = 0;
+            isPrepared.store(true);
+            if (wasRunning) {
+                startThread(juce::Thread::Priority::low);
+            }
+        }
+
+        /**
+         * update which signals should be captured, call it on the audio thread before pushing buffers
+         */
+        void updateSignals() {
+            currentIsSignalON.fill(false);
+            for (size_t c = 0; c < consumerNum; ++c) {
+                if (!consumers[c]->isSpectrumON()) { continue; }
+                for (size_t i = 0; i < spectrumSignalNUM; ++i) {
+                    currentIsSignalON[i] = currentIsSignalON[i] || consumers[c]->isSignalON(i);
+                }
+            }
+        }
+
+        /**
+         * @return whether the signal is captured, valid after updateSignals()
+         */
+        bool getIsSignalON(const SpectrumSignal signal) const { return currentIsSignalON[signal]; }
+
+        void pushPreBuffer(juce::AudioBuffer<FloatType> &buffer) {
+            if (currentIsSignalON[preSignal]) {
+                signalBuffers[preSignal].makeCopyOf(buffer, true);
+                preDelay.process(signalBuffers[preSignal]);
+            }
+        }
+
+        void pushPostBuffer(juce::AudioBuffer<FloatType> &buffer) {
+            if (currentIsSignalON[postSignal]) {
+                signalBuffers[postSignal].makeCopyOf(buffer, true);
+            }
+        }
+
+        void pushSideBuffer(juce::AudioBuffer<FloatType> &buffer) {
+            if (currentIsSignalON[sideSignal]) {
+                signalBuffers[sideSignal].makeCopyOf(buffer, true);
+                sideDelay.process(signalBuffers[sideSignal]);
+            }
+        }
+
+        /**
+         * put pushed samples into FIFOs
+         */
+        void process() {
+            bool anyON = false;
+            int freeSpace = abstractFIFO.getFreeSpace();
+            for (size_t i = 0; i < spectrumSignalNUM; ++i) {
+                if (!currentIsSignalON[i]) { continue; }
+                anyON = true;
+                freeSpace = std::min(freeSpace, signalBuffers[i].getNumSamples());
+            }
+            if (!anyON || freeSpace == 0) { return; }
+            const auto scope = abstractFIFO.write(freeSpace);
+            for (size_t i = 0; i < spectrumSignalNUM; ++i) {
+                if (!currentIsSignalON[i]) { continue; }
+                const auto &buffer{signalBuffers[i]};
+                const FloatType avgScale = FloatType(1) / static_cast<FloatType>(buffer.getNumChannels());
+                int j = 0;
+                int shift = 0;
+                for (; j < scope.blockSize1; ++j) {
+                    FloatType sample{0};
+                    for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+                        sample += buffer.getSample(channel, j);
+                    }
+                    sampleFIFOs[i][static_cast<size_t>(shift + scope.startIndex1)] = static_cast<float>(
+                        sample * avgScale);
+                    shift += 1;
+                }
+                shift = 0;
+                for (; j < scope.blockSize1 + scope.blockSize2; ++j) {
+                    FloatType sample{0};
+                    for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+                        sample += buffer.getSample(channel, j);
+                    }
+                    sampleFIFOs[i][static_cast<size_t>(shift + scope.startIndex2)] = static_cast<float>(
+                        sample * avgScale);
+                    shift += 1;
+                }
+            }
+        }
+
+        /**
+         * start the hub thread if any consumer is active, otherwise stop it
+         * call it on the message thread
+         */
+        void updateThread() {
+            bool anyON = false;
+            for (size_t c = 0; c < consumerNum; ++c) {
+                anyON = anyON || consumers[c]->isSpectrumON();
+            }
+            if (anyON && !isThreadRunning()) {
+                startThread(juce::Thread::Priority::low);
+            } else if (!anyON && isThreadRunning()) {
+                stopThread(-1);
+            }
+        }
+
+        /**
+         * ask the hub thread to compute new spectra
+         */
+        void trigger() {
+            notify();
+        }
+
+        /**
+         * collect samples from FIFOs, compute the spectra needed by ready consumers and dispatch them
+         * it is called on the hub thread
+         */
+        void analyze() {
+            if (!isPrepared.load()) {
+                return;
+            }
+            std::array<bool, spectrumSignalNUM> isSignalON{};
+            for (size_t c = 0; c < consumerNum; ++c) {
+                if (!consumers[c]->isSpectrumON()) { continue; }
+                for (size_t i = 0; i < spectrumSignalNUM; ++i) {
+                    isSignalON[i] = isSignalON[i] || consumers[c]->isSignalON(i);
+                }
+            }
+            // collect data from FIFO into the rings
+            const int numReady = abstractFIFO.getNumReady(); {
+                const auto scope = abstractFIFO.read(numReady);
+                const auto pos1 = ringPos;
+                const auto pos2 = (ringPos + static_cast<size_t>(scope.blockSize1)) & ringMask;
+                for (size_t i = 0; i < spectrumSignalNUM; ++i) {
+                    if (!isSignalON[i]) { continue; }
+                    copyToRing(rings[i], pos1, sampleFIFOs[i].data() + scope.startIndex1,
+                               static_cast<size_t>(scope.blockSize1));
+                    copyToRing(rings[i], pos2, sampleFIFOs[i].data() + scope.startIndex2,
+                               static_cast<size_t>(scope.blockSize2));
+                }
+                ringPos = (ringPos + static_cast<size_t>(numReady)) & ringMask;
+            }
+            // compute each spectrum at most once and dispatch them to consumers
+            for (auto &flags: isSpectrumReady) {
+                flags.fill(false);
+            }
+            for (size_t c = 0; c < consumerNum; ++c) {
+                auto &consumer{*consumers[c]};
+                if (!consumer.isSpectrumON() || !consumer.isReadyForSpectra(numReady)) { continue; }
+                const auto engineIdx = consumerEngines[c];
+                std::array<const Spectrum *, spectrumSignalNUM> consumerSpectra{};
+                for (size_t i = 0; i < spectrumSignalNUM; ++i) {
+                    if (!isSignalON[i] || !consumer.isSignalON(i)) { continue; }
+                    if (!isSpectrumReady[engineIdx][i]) {
+                        updateSpectrum(engineIdx, i);
+                        isSpectrumReady[engineIdx][i] = true;
+                    }
+                    consumerSpectra[i] = &spectra[engineIdx][i];
+                }
+                consumer.consumeSpectra(consumerSpectra);
+            }
+        }
+
+        zlDelay::SampleDelay<FloatType> &getPreDelay() { return preDelay; }
+
+        zlDelay::SampleDelay<FloatType> &getSideDelay() { return sideDelay; }
+
+    private:
+        struct Engine {
+            size_t fftSize{0}, binSize{0};
+            std::unique_ptr<juce::dsp::FFT> fft;
+            std::vector<float> window;
+            std::vector<float> fftBuffer;
+        };
+
+        // 20 * log10(2)
+        static constexpr float dBPerLog2 = 6.020599913279624f;
+        // -240 dB
+        static constexpr float minGain = 1e-12f;
+
+        std::atomic<bool> isPrepared{false};
+
+        std::array<SpectrumConsumer *, maxConsumerNum> consumers{};
+        size_t consumerNum{0};
+        std::array<size_t, maxConsumerNum> consumerEngines{};
+
+        std::array<Engine, maxConsumerNum> engines;
+        size_t engineNum{0};
+        std::array<std::array<Spectrum, spectrumSignalNUM>, maxConsumerNum> spectra;
+        std::array<std::array<bool, spectrumSignalNUM>, maxConsumerNum> isSpectrumReady{};
+
+        std::array<juce::AudioBuffer<FloatType>, spectrumSignalNUM> signalBuffers;
+        std::array<bool, spectrumSignalNUM> currentIsSignalON{};
+        zlDelay::SampleDelay<FloatType> preDelay, sideDelay;
+
+        // single producer (audio thread), single consumer (hub thread)
+        std::array<std::vector<float>, spectrumSignalNUM> sampleFIFOs;
+        juce::AbstractFifo abstractFIFO{1};
+        // the latest samples of each signal, only accessed on the hub thread
+        std::array<std::vector<float>, spectrumSignalNUM> rings;
+        size_t ringMask{0}, ringPos{0};
+
+        void run() override {
+            juce::ScopedNoDenormals noDenormals;
+            while (!threadShouldExit()) {
+                analyze();
+                const auto flag = wait(-1);
+                juce::ignoreUnused(flag);
+            }
+        }
+
+        static void copyToRing(std::vector<float> &ring, const size_t pos, const float *samples, const size_t num) {
+            const auto num1 = std::min(num, ring.size() - pos);
+            std::copy(samples, samples + num1, ring.begin() + static_cast<std::ptrdiff_t>(pos));
+            std::copy(samples + num1, samples + num, ring.begin());
+        }
+
+        void updateSpectrum(const size_t engineIdx, const size_t signalIdx) {
+            auto &engine{engines[engineIdx]};
+            auto &spectrum{spectra[engineIdx][signalIdx]};
+            const auto &ring{rings[signalIdx]};
+            // the latest fftSize samples end at the ring position, window them in place of a shift
+            const auto start = (ringPos + ring.size() - engine.fftSize) & ringMask;
+            const auto num1 = std::min(engine.fftSize, ring.size() - start);
+            const auto num2 = engine.fftSize - num1;
+            juce::FloatVectorOperations::multiply(engine.fftBuffer.data(), ring.data() + start,
+                                                  engine.window.data(), static_cast<int>(num1));
+            juce::FloatVectorOperations::multiply(engine.fftBuffer.data() + num1, ring.data(),
+                                                  engine.window.data() + num1, static_cast<int>(num2));
+            spectrum.ms = (std::inner_product(ring.data() + start, ring.data() + start + num1,
+                                              ring.data() + start, 0.f)
+                           + std::inner_product(ring.data(), ring.data() + num2, ring.data(), 0.f))
+                          / static_cast<float>(engine.fftSize);
+            engine.fft->performFrequencyOnlyForwardTransform(engine.fftBuffer.data());
+            magnitudesToDecibels(engine.fftBuffer.data(), spectrum.dBs.data(), spectrum.dBs.size(),
+                                 1.f / static_cast<float>(engine.fftSize));
+        }
+
+        /**
+         * convert magnitudes to dB (floored at -240 dB) with a branchless log2 approximation
+         * the error is below 0.001 dB, the loop can be auto-vectorized
+         */
+        static void magnitudesToDecibels(const float *magnitudes, float *dBs, const size_t num, const float scale) {
+            for (size_t j = 0; j < num; ++j) {
+                const auto bits = std::bit_cast<std::uint32_t>(std::max(magnitudes[j] * scale, minGain));
+                const auto e = static_cast<float>(static_cast<std::int32_t>(bits >> 23) - 127);
+                const auto f = std::bit_cast<float>((bits & 0x007fffffu) | 0x3f800000u) - 1.f;
+                dBs[j] = dBPerLog2 * (e + f * (1.4386380f + f * (-.6777433f + f * (.3218797f - .0828607f * f))));
+            }
+        }
+    };
+}
+
+#endif //ZLFFT_SPECTRUM_HUB_HPP
@@ -14,6 +14,7 @@
 
 #include "../iir_filter/iir_filter.hpp"
 #include "../ideal_filter/ideal_filter.hpp"
+#include "../filter_design/batch_design.hpp"
 #include "../../compressor/compressor.hpp"
 
 namespace zlFilter {
@@ -26,6 +27,11 @@ namespace zlFilter {
     template<typename FloatType, size_t FilterSize>
     class DynamicIIR {
     public:
+        /**
+         * the side filter is always a second order band-pass, i.e. a single biquad
+         */
+        static constexpr size_t SideFilterSize = 1;
+
         DynamicIIR(zlFilter::Empty<FloatType> &b, zlFilter::Empty<FloatType> &t)
             : bFilter(b), tFilter(t) {
         }
@@ -36,6 +42,14 @@ namespace zlFilter {
             compressor.reset();
         }
 
+        /**
+         * clear the states of the main & side filters at once, call it on the audio thread
+         */
+        void clearStates() {
+            mFilter.clearStates();
+            sFilter.clearStates();
+        }
+
         void prepare(const juce::dsp::ProcessSpec &spec) {
             mFilter.prepare(spec);
             sFilter.template setOrder<false>(2);
@@ -55,6 +69,12 @@ namespace zlFilter {
          */
         template<bool isBypassed = false>
         void process(juce::AudioBuffer<FloatType> &mBuffer, juce::AudioBuffer<FloatType> &sBuffer) {
+            if (isBatched) {
+                // pushToBatch has cached the values, run the side chain and prepared the main filter for this block
+                isBatched = false;
+                processMain<isBypassed>(mBuffer);
+                return;
+            }
             cacheCurrentValues();
 
             mFilter.processPre(mBuffer);
@@ -71,6 +91,83 @@ namespace zlFilter {
             }
         }
 
+        /**
+         * prepare the main filter and append it to the cascade if it is static and in the iir structure
+         * the buffer is not processed, otherwise call process() after the cascade has processed the buffer
+         * @param mBuffer main chain audio buffer
+         * @param cascade
+         * @return whether the main filter has been appended
+         */
+        template<bool isBypassed = false, size_t MaxSectionNum>
+        bool pushToCascade(juce::AudioBuffer<FloatType> &mBuffer, IIRCascade<FloatType, MaxSectionNum> &cascade) {
+            cacheCurrentValues();
+            if (currentDynamicON || currentFilterStructure != FilterStructure::iir) return false;
+            mFilter.processPre(mBuffer);
+            return mFilter.template pushToCascade<isBypassed>(cascade);
+        }
+
+        /**
+         * prepare the main filter and append it to the parallel bank if it should be parallel
+         * for the dynamic filter, the side chain is processed and the gain is updated before appending
+         * the main buffer is not processed, filters which should not be parallel are left to processParallelPost()
+         * @param mBuffer main chain audio buffer
+         * @param sBuffer side chain audio buffer
+         * @param bank
+         * @return whether the filter is in the parallel structure, otherwise call process()
+         */
+        template<bool isBypassed = false, size_t MaxBranchNum, size_t MaxSectionNum>
+        bool pushToParallelBank(juce::AudioBuffer<FloatType> &mBuffer, juce::AudioBuffer<FloatType> &sBuffer,
+                                IIRParallelBank<FloatType, MaxBranchNum, MaxSectionNum> &bank) {
+            cacheCurrentValues();
+            if (currentFilterStructure != FilterStructure::parallel) return false;
+            mFilter.template processPre<false>(mBuffer);
+            if (mFilter.getShouldBeParallel()) {
+                if (currentDynamicON) {
+                    updateDynamicGain(sBuffer);
+                }
+                mFilter.template pushToParallelBank<isBypassed>(bank);
+            }
+            return true;
+        }
+
+        /**
+         * run the side chain ahead of process() and push the design of the main filter to the batch
+         * only for a dynamic second order peak in the iir/svf structure
+         * call pullFromBatch() after the batch has been designed, then process() skips the side chain
+         * @param mBuffer main chain audio buffer
+         * @param sBuffer side chain audio buffer
+         * @param batch
+         * @return whether the design has been pushed
+         */
+        template<size_t BatchSize>
+        bool pushToBatch(juce::AudioBuffer<FloatType> &mBuffer, juce::AudioBuffer<FloatType> &sBuffer,
+                         BatchDesign<BatchSize> &batch) {
+            isBatched = false;
+            cacheCurrentValues();
+            if (!currentDynamicON || currentFilterStructure == FilterStructure::parallel || batch.isFull()) {
+                return false;
+            }
+            mFilter.processPre(mBuffer);
+            if (!mFilter.getIsBatchable()) return false;
+            const auto [currentGain, currentQ] = getDynamicGainAndQ(sBuffer);
+            batchGain = currentGain;
+            batchQ = currentQ;
+            batchIdx = batch.push(static_cast<double>(mFilter.getFreq()), mFilter.getSampleRate(),
+                                  static_cast<double>(currentGain), static_cast<double>(currentQ));
+            isBatched = true;
+            return true;
+        }
+
+        template<size_t BatchSize>
+        void pullFromBatch(const BatchDesign<BatchSize> &batch) {
+            if (!isBatched) return;
+            if (currentIsPerSample) {
+                mFilter.template setGainAndQWithCoeff<true>(batchGain, batchQ, batch.getCoeff(batchIdx));
+            } else {
+                mFilter.template setGainAndQWithCoeff<false>(batchGain, batchQ, batch.getCoeff(batchIdx));
+            }
+        }
+
         template<bool isBypassed = false>
         void processParallelPost(juce::AudioBuffer<FloatType> &mBuffer, juce::AudioBuffer<FloatType> &sBuffer) {
             if (mFilter.getShouldNotBeParallel()) {
@@ -89,7 +186,7 @@ namespace zlFilter {
 
         IIR<FloatType, FilterSize> &getMainFilter() { return mFilter; }
 
-        IIR<FloatType, FilterSize> &getSideFilter() { return sFilter; }
+        IIR<FloatType, SideFilterSize> &getSideFilter() { return sFilter; }
 
         zlCompressor::ForwardCompressor<FloatType> &getCompressor() { return compressor; }
 
@@ -119,7 +216,8 @@ namespace zlFilter {
         }
 
     private:
-        zlFilter::IIR<FloatType, FilterSize> mFilter, sFilter;
+        zlFilter::IIR<FloatType, FilterSize> mFilter;
+        zlFilter::IIR<FloatType, SideFilterSize> sFilter;
         zlFilter::Empty<FloatType> &bFilter, &tFilter;
         zlCompressor::ForwardCompressor<FloatType> compressor;
         juce::AudioBuffer<FloatType> sBufferCopy;
@@ -129,12 +227,48 @@ namespace zlFilter {
         bool currentIsDynamicChangeQ{false};
         std::atomic<FilterStructure> filterStructure{FilterStructure::iir};
         FilterStructure currentFilterStructure{FilterStructure::iir};
-        juce::AudioBuffer<FloatType> sampleBuffer;
         std::atomic<bool> isPerSample{false};
         bool currentIsPerSample{false};
+        bool isBatched{false};
+        size_t batchIdx{0};
+        FloatType batchGain{0}, batchQ{0};
 
         template<bool isBypassed = false>
         void processDynamic(juce::AudioBuffer<FloatType> &mBuffer, juce::AudioBuffer<FloatType> &sBuffer) {
+            updateDynamicGain(sBuffer);
+            processMain<isBypassed>(mBuffer);
+        }
+
+        template<bool isBypassed = false>
+        void processMain(juce::AudioBuffer<FloatType> &mBuffer) {
+            if (mFilter.getShouldBeParallel()) {
+                mFilter.template process<isBypassed>(mFilter.getParallelBuffer());
+            } else {
+                mFilter.template process<isBypassed>(mBuffer);
+            }
+        }
+
+        void updateDynamicGain(juce::AudioBuffer<FloatType> &sBuffer) {
+            const auto [currentGain, currentQ] = getDynamicGainAndQ(sBuffer);
+            if (currentIsDynamicChangeQ) {
+                if (currentIsPerSample) {
+                    mFilter.setGainAndQRamp(currentGain, currentQ);
+                } else {
+                    mFilter.setGainAndQNow(currentGain, currentQ);
+                }
+            } else {
+                if (currentIsPerSample) {
+                    mFilter.setGainRamp(currentGain);
+                } else {
+                    mFilter.setGainNow(currentGain);
+                }
+            }
+        }
+
+        /**
+         * process the side chain and calculate the gain & Q of the main filter
+         */
+        std::pair<FloatType, FloatType> getDynamicGainAndQ(juce::AudioBuffer<FloatType> &sBuffer) {
             sBufferCopy.makeCopyOf(sBuffer, true);
             sFilter.processPre(sBufferCopy);
             sFilter.process(sBufferCopy);
@@ -144,51 +278,11 @@ namespace zlFilter {
             if (currentDynamicBypass) {
                 portion = 0;
             }
-            if (!currentIsPerSample) {
-                if (currentIsDynamicChangeQ) {
-                    mFilter.setGainAndQNow((1 - portion) * bFilter.getGain() + portion * tFilter.getGain(),
-                                           (1 - portion) * bFilter.getQ() + portion * tFilter.getQ());
-                } else {
-                    mFilter.setGainNow((1 - portion) * bFilter.getGain() + portion * tFilter.getGain());
-                }
-                if (mFilter.getShouldBeParallel()) {
-                    mFilter.template process<isBypassed>(mFilter.getParallelBuffer());
-                } else {
-                    mFilter.template process<isBypassed>(mBuffer);
-                }
+            const auto currentGain = (1 - portion) * bFilter.getGain() + portion * tFilter.getGain();
+            if (currentIsDynamicChangeQ) {
+                return {currentGain, (1 - portion) * bFilter.getQ() + portion * tFilter.getQ()};
             } else {
-                if (currentIsDynamicChangeQ) {
-                    const auto oldGain = mFilter.getGain();
-                    const auto oldQ = mFilter.getQ();
-                    const auto newGain = (1 - portion) * bFilter.getGain() + portion * tFilter.getGain();
-                    const auto newQ = (1 - portion) * bFilter.getQ() + portion * tFilter.getQ();
-                    auto audioWriters = mFilter.getShouldBeParallel()
-                                            ? mFilter.getParallelBuffer().getArrayOfWritePointers()
-                                            : mBuffer.getArrayOfWritePointers();
-                    for (int i = 0; i < mBuffer.getNumSamples(); ++i) {
-                        const auto pp = static_cast<FloatType>(i) / static_cast<FloatType>(mBuffer.getNumSamples());
-                        const auto currentGain = newGain * pp + oldGain * (1 - pp);
-                        const auto currentQ = newQ * pp + oldQ * (1 - pp);
-                        mFilter.setGainAndQNow(currentGain, currentQ);
-                        sampleBuffer.setDataToReferTo(audioWriters, static_cast<int>(mBuffer.getNumChannels()), i,
-                                                      1);
-                        mFilter.template process<isBypassed>(sampleBuffer);
-                    }
-                } else {
-                    const auto oldGain = mFilter.getGain();
-                    const auto newGain = (1 - portion) * bFilter.getGain() + portion * tFilter.getGain();
-                    auto audioWriters = mFilter.getShouldBeParallel()
-                                            ? mFilter.getParallelBuffer().getArrayOfWritePointers()
-                                            : mBuffer.getArrayOfWritePointers();
-                    for (int i = 0; i < mBuffer.getNumSamples(); ++i) {
-                        const auto pp = static_cast<FloatType>(i) / static_cast<FloatType>(mBuffer.getNumSamples());
-                        const auto currentGain = newGain * pp + oldGain * (1 - pp);
-                        mFilter.setGainNow(currentGain);
-                        sampleBuffer.setDataToReferTo(audioWriters, static_cast<int>(mBuffer.getNumChannels()), i,
-                                                      1);
-                        mFilter.template process<isBypassed>(sampleBuffer);
-                    }
-                }
+                return {currentGain, mFilter.getQ()};
             }
         }
 
@@ -14,6 +14,8 @@
 #include "ideal_filter/ideal_filter.hpp"
 #include "dynamic_filter/dynamic_filter.hpp"
 #include "filter_design/filter_design.hpp"
+#include "filter_design/coeff_cache.hpp"
+#include "filter_design/batch_design.hpp"
 #include "static_frequency_array.hpp"
 #include "fir_correction/fir_correction.hpp"
 
@@ -0,0 +1,131 @@
+// Copyright (C) 2024 - zsliu98
+// This file is part of ZLEqualizer
+//
+// ZLEqualizer is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License Version 3 as published by the Free Software Foundation.
+//
+// ZLEqualizer is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License along with ZLEqualizer. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ZLFILTER_COEFF_CACHE_HPP
+#define ZLFILTER_COEFF_CACHE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
+#include "../helpers.hpp"
+
+namespace zlFilter {
+    /**
+     * a bounded lock-free cache of designed coefficients, which can be shared by the audio & message threads
+     * the key is (type, order, frequency, gain, Q, sample rate), the parameters are compared bit by bit
+     * so a hit returns exactly the design of the same parameters
+     * the slots form two-way sets, each slot is a seqlock:
+     * a reader treats a slot being written as a miss, a writer skips a slot being written
+     * @tparam ArraySize the maximum number of biquads of a design
+     * @tparam SlotNum the number of slots, must be a power of two
+     */
+    template<size_t ArraySize, size_t SlotNum = 256>
+    class CoeffCache {
+    public:
+        static_assert(SlotNum >= 2 && (SlotNum & (SlotNum - 1)) == 0);
+
+        struct Key {
+            std::array<uint64_t, 5> bits;
+        };
+
+        static Key getKey(const FilterType filterType, const size_t n,
+                          const double f, const double fs, const double gDB, const double q0) {
+            return {
+                {
+                    (static_cast<uint64_t>(filterType) << 32) | static_cast<uint32_t>(n),
+                    std::bit_cast<uint64_t>(f), std::bit_cast<uint64_t>(fs),
+                    std::bit_cast<uint64_t>(gDB), std::bit_cast<uint64_t>(q0)
+                }
+            };
+        }
+
+        /**
+         * look up the coefficients
+         * @param key
+         * @param coeffs the coefficients, which may be partially overwritten on a miss
+         * @param num the number of biquads
+         * @return whether the key is found
+         */
+        bool load(const Key &key, std::array<std::array<double, 6>, ArraySize> &coeffs, size_t &num) const {
+            const auto idx = getSlotIdx(key);
+            return loadSlot(slots[idx], key, coeffs, num) || loadSlot(slots[idx ^ 1], key, coeffs, num);
+        }
+
+        /**
+         * store the coefficients, skipped if the slot is being written by another thread
+         * @param key
+         * @param coeffs
+         * @param num the number of biquads
+         */
+        void store(const Key &key, const std::array<std::array<double, 6>, ArraySize> &coeffs, const size_t num) {
+            // two-way set: replace the slot which has been written less often
+            const auto idx = getSlotIdx(key);
+            auto &slot = slots[idx].version.load(std::memory_order_relaxed) <=
+                         slots[idx ^ 1].version.load(std::memory_order_relaxed)
+                             ? slots[idx]
+                             : slots[idx ^ 1];
+            auto version = slot.version.load(std::memory_order_relaxed);
+            if ((version & 1) || !slot.version.compare_exchange_strong(
+                    version, version + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                return;
+            }
+            std::atomic_thread_fence(std::memory_order_release);
+            for (size_t i = 0; i < key.bits.size(); ++i) {
+                slot.key[i].store(key.bits[i], std::memory_order_relaxed);
+            }
+            slot.num.store(num, std::memory_order_relaxed);
+            for (size_t i = 0; i < std::min(num, ArraySize); ++i) {
+                for (size_t j = 0; j < 6; ++j) {
+                    slot.coeffs[i][j].store(coeffs[i][j], std::memory_order_relaxed);
+                }
+            }
+            slot.version.store(version + 2, std::memory_order_release);
+        }
+
+    private:
+        struct Slot {
+            std::atomic<uint64_t> version{0};
+            std::array<std::atomic<uint64_t>, std::tuple_size_v<decltype(Key::bits)> > key{};
+            std::atomic<size_t> num{0};
+            std::array<std::array<std::atomic<double>, 6>, ArraySize> coeffs{};
+        };
+
+        std::array<Slot, SlotNum> slots{};
+
+        static bool loadSlot(const Slot &slot, const Key &key,
+                             std::array<std::array<double, 6>, ArraySize> &coeffs, size_t &num) {
+            const auto version = slot.version.load(std::memory_order_acquire);
+            if (version & 1) return false;
+            for (size_t i = 0; i < key.bits.size(); ++i) {
+                if (slot.key[i].load(std::memory_order_relaxed) != key.bits[i]) return false;
+            }
+            num = std::min(slot.num.load(std::memory_order_relaxed), ArraySize);
+            for (size_t i = 0; i < num; ++i) {
+                for (size_t j = 0; j < 6; ++j) {
+                    coeffs[i][j] = slot.coeffs[i][j].load(std::memory_order_relaxed);
+                }
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return slot.version.load(std::memory_order_relaxed) == version;
+        }
+
+        static size_t getSlotIdx(const Key &key) {
+            uint64_t hash = 0x9e3779b97f4a7c15ull;
+            for (const auto bits: key.bits) {
+                hash = (hash ^ bits) * 0xbf58476d1ce4e5b9ull;
+                hash ^= hash >> 31;
+            }
+            return static_cast<size_t>(hash & (SlotNum - 1));
+        }
+    };
+}
+
+#endif //ZLFILTER_COEFF_CACHE_HPP
@@ -72,7 +72,7 @@ namespace zlFilter::FilterDesign {
         const size_t number = n / 2;
         const auto halfbw = std::asinh(0.5 / q0) / std::log(2);
         const auto w = w0 / std::pow(2, halfbw);
-        const auto g = db_to_gain(-6 / static_cast<double>(n));
+        const auto g = db_to_gain_fast(-6 / static_cast<double>(n));
         const auto _q = std::sqrt(1 - g * g) * w * w0 / g / (w0 * w0 - w * w);
 
         const auto singleCoeff = func(w0, _q);
@@ -90,7 +90,7 @@ namespace zlFilter::FilterDesign {
         const size_t number = n / 2;
         const auto halfbw = std::asinh(0.5 / q0) / std::log(2);
         const auto w = w0 / std::pow(2, halfbw);
-        const auto g = db_to_gain(-6 / static_cast<double>(n));
+        const auto g = db_to_gain_fast(-6 / static_cast<double>(n));
         const auto _q = g * w * w0 / std::sqrt((1 - g * g)) / (w0 * w0 - w * w);
 
         const auto singleCoeff = func(w0, _q);
@@ -151,7 +151,7 @@ namespace zlFilter::FilterDesign {
                         const double f, const double fs, const double gDB, const double q0,
                         std::array<std::array<double, 6>, ArraySize> &coeffs) {
         const auto w0 = ppi * f / fs;
-        const auto g0 = db_to_gain(gDB);
+        const auto g0 = db_to_gain_fast(gDB);
         switch (filterType) {
             case peak:
                 switch (n) {
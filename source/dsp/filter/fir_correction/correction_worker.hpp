@@ -0,0 +1,101 @@
+// Copyright (C) 2024 - zsliu98
+// This file is part of ZLEqualizer
+//
+// ZLEqualizer is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License Version 3 as published by the Free Software Foundation.
+//
+// ZLEqualizer is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License along with ZLEqualizer. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ZLFILTER_CORRECTION_WORKER_HPP
+#define ZLFILTER_CORRECTION_WORKER_HPP
+
+#include <juce_dsp/juce_dsp.h>
+#include <semaphore>
+
+namespace zlFilter {
+    /**
+     * a job of the correction worker
+     */
+    class CorrectionJob {
+    public:
+        virtual ~CorrectionJob() = default;
+
+        /**
+         * run the job if it has been requested, it is called on the worker thread
+         */
+        virtual void runJob() = 0;
+    };
+
+    /**
+     * a background thread which builds correction kernels for the convolution stages
+     * the stages share the same filters, so their jobs run one after another on this single thread
+     * the worker sleeps until a job is requested, it is woken by a semaphore since juce::Thread::notify takes a lock
+     */
+    class CorrectionWorker final : private juce::Thread {
+    public:
+        static constexpr size_t MaxJobNum = 4;
+
+        CorrectionWorker() : Thread("correction_worker") {
+        }
+
+        ~CorrectionWorker() override {
+            stop();
+        }
+
+        /**
+         * add a job, call it before the worker starts
+         */
+        void addJob(CorrectionJob &job) {
+            jassert(jobNum < MaxJobNum);
+            jobs[jobNum] = &job;
+            jobNum += 1;
+        }
+
+        void start() {
+            if (!isThreadRunning()) {
+                startThread(juce::Thread::Priority::normal);
+            }
+        }
+
+        /**
+         * stop the worker, the jobs can then be prepared without a lock
+         */
+        void stop() {
+            if (isThreadRunning()) {
+                signalThreadShouldExit();
+                signal();
+                stopThread(-1);
+            }
+        }
+
+        /**
+         * wake the worker up to run the requested jobs, it does not block and can be called on the audio thread
+         */
+        void signal() {
+            if (!isSignalled.exchange(true)) {
+                semaphore.release();
+            }
+        }
+
+    private:
+        std::array<CorrectionJob *, MaxJobNum> jobs{};
+        size_t jobNum{0};
+        // the flag keeps the semaphore count small if the audio thread signals faster than the worker runs
+        std::atomic<bool> isSignalled{false};
+        std::counting_semaphore<> semaphore{0};
+
+        void run() override {
+            while (!threadShouldExit()) {
+                semaphore.acquire();
+                isSignalled.store(false);
+                if (threadShouldExit()) { break; }
+                for (size_t i = 0; i < jobNum; ++i) {
+                    jobs[i]->runJob();
+                }
+            }
+        }
+    };
+}
+
+#endif //ZLFILTER_CORRECTION_WORKER_HPP
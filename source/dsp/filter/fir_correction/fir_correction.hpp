@@ -11,8 +11,11 @@
 #define ZLFILTER_FIR_CORRECTION_HPP
 
 #include "correction_helper.hpp"
+#include "correction_worker.hpp"
+#include "product_tree.hpp"
 #include "prototype_correction.hpp"
 #include "mixed_correction.hpp"
 #include "fir_filter.hpp"
+#include "stereo_correction.hpp"
 
 #endif //ZLFILTER_FIR_CORRECTION_HPP
@@ -15,11 +15,12 @@
 #include "../iir_filter/iir_filter.hpp"
 #include "../ideal_filter/ideal_filter.hpp"
 #include "../../container/array.hpp"
+#include "product_tree.hpp"
 
 namespace zlFilter {
     /**
-     * an FIR which corrects the magnitude responses of IIR filters to prototype filters
-     * and minimizes phase responses at high-end
+     * the correction spectrum which corrects the responses of IIR filters to mixed-phase prototype filters
+     * it is applied to the audio signal by StereoCorrection
      * @tparam FloatType the float type of input audio buffer
      * @tparam FilterNum the number of filters
      * @tparam FilterSize the size of each filter
@@ -45,15 +46,15 @@ namespace zlFilter {
 
         void prepare(const juce::dsp::ProcessSpec &spec) {
             if (spec.sampleRate <= 50000) {
-                setOrder(static_cast<size_t>(spec.numChannels), defaultFFTOrder);
+                setOrder(defaultFFTOrder);
             } else if (spec.sampleRate <= 100000) {
-                setOrder(static_cast<size_t>(spec.numChannels), defaultFFTOrder + 1);
+                setOrder(defaultFFTOrder + 1);
                 // decayMultiplier = 0.9899494936611666;
             } else if (spec.sampleRate <= 200000) {
-                setOrder(static_cast<size_t>(spec.numChannels), defaultFFTOrder + 2);
+                setOrder(defaultFFTOrder + 2);
                 // decayMultiplier = 0.9949620563926881;
             } else {
-                setOrder(static_cast<size_t>(spec.numChannels), defaultFFTOrder + 3);
+                setOrder(defaultFFTOrder + 3);
                 // decayMultiplier = 0.9974778475699037;
             }
             double mix = decayMultiplier;
@@ -69,194 +70,125 @@ namespace zlFilter {
             }
         }
 
-        void reset() {
-            pos = 0;
-            count = 0;
-            for (auto &fifo: inputFIFOs) {
-                fifo.resize(fftSize);
-                std::fill(fifo.begin(), fifo.end(), 0.f);
-            }
-            for (auto &fifo: outputFIFOs) {
-                fifo.resize(fftSize);
-                std::fill(fifo.begin(), fifo.end(), 0.f);
+        void setToUpdate() { toUpdate.store(true); }
+
+        size_t getCorrectionSize() const { return corrections.size(); }
+
+        size_t getFFTOrder() const { return fftOrder; }
+
+        const std::vector<std::complex<float> > &getCorrections() const { return corrections; }
+
+        /**
+         * check whether a routed filter or the correction itself is outdated, call it on the audio thread
+         */
+        bool getIsOutdated() const {
+            if (toUpdate.load()) { return true; }
+            for (size_t idx = 0; idx < filterIndices.size(); ++idx) {
+                const auto i = filterIndices[idx];
+                if (!bypassMask[i] && (idealFs[i].getMagOutdated() || iirFs[i].getResponseOutdated())) {
+                    return true;
+                }
             }
-            std::fill(fftData.begin(), fftData.end(), 0.f);
+            return false;
         }
 
-        template<bool isBypassed = false>
-        void process(juce::AudioBuffer<FloatType> &buffer) {
-            for (size_t i = 0; i < static_cast<size_t>(buffer.getNumSamples()); ++i) {
-                for (size_t channel = 0; channel < static_cast<size_t>(buffer.getNumChannels()); ++channel) {
-                    auto writePointer = buffer.getWritePointer(static_cast<int>(channel), static_cast<int>(i));
-                    inputFIFOs[channel][pos] = static_cast<float>(*writePointer);
-                    *writePointer = static_cast<FloatType>(outputFIFOs[channel][pos]);
-                    outputFIFOs[channel][pos] = FloatType(0);
+        /**
+         * copy the routed & un-bypassed filters for the next update
+         * call it on the audio thread while update is not running
+         */
+        void syncRouting() {
+            activeIndices.clear();
+            for (size_t idx = 0; idx < filterIndices.size(); ++idx) {
+                const auto i = filterIndices[idx];
+                if (!bypassMask[i]) {
+                    activeIndices.push(i);
                 }
+            }
+        }
 
-                pos += 1;
-                if (pos == fftSize) {
-                    pos = 0;
+        /**
+         * update the correction spectrum if a filter has been updated, call it on the correction worker
+         * only the corrections of updated bands are recomputed, and the total is composed by a product tree
+         * @return whether the correction spectrum has changed
+         */
+        bool update() {
+            // a full update rebuilds every leaf, since another group may have consumed the updated responses
+            // of a band while it was routed there
+            const auto isFullUpdate = toUpdate.exchange(false);
+            bool needToUpdate = isFullUpdate;
+            std::array<bool, FilterNum> isActive{};
+            for (size_t idx = 0; idx < activeIndices.size(); ++idx) {
+                const auto i = activeIndices[idx];
+                isActive[i] = true;
+                // update both responses, a short-circuit would leave the other one outdated
+                const auto isIdealUpdated = idealFs[i].updateMixPhaseResponse(
+                    wis1, startMixIdx, endMixIdx, correctionMix);
+                const auto isIIRUpdated = iirFs[i].updateResponse(wis2);
+                if (isIdealUpdated || isIIRUpdated || isFullUpdate || !isBandActive[i]) {
+                    updateBand(i);
+                    needToUpdate = true;
                 }
-                count += 1;
-                if (count == hopSize) {
-                    count = 0;
-                    processFrame<isBypassed>();
+            }
+            // bands which have been removed from the group
+            for (size_t i = 0; i < FilterNum; ++i) {
+                if ((isFullUpdate || isBandActive[i]) && !isActive[i]) {
+                    bandProducts.setLeafToOne(i);
+                    needToUpdate = true;
                 }
             }
+            isBandActive = isActive;
+            if (!needToUpdate) { return false; }
+            const auto &product = bandProducts.update();
+            std::copy(product.begin() + startMixIdx, product.end() - 1, corrections.begin() + startMixIdx);
+            // remove all infinity & NaN
+            for (size_t j = startMixIdx; j < corrections.size() - 1; ++j) {
+                if (!std::isfinite(corrections[j].real()) || !std::isfinite(corrections[j].imag())
+                    || std::abs(corrections[j].real()) > 10000.f || std::abs(corrections[j].imag()) > 10000.f) {
+                    corrections[j] = std::complex(1.f, 0.f);
+                }
+            }
+            corrections.end()[-1] = std::abs(corrections.end()[-2]);
+            return true;
         }
 
-        int getLatency() const { return latency.load(); }
-
-        void setToUpdate() { toUpdate.store(true); }
-
-        size_t getCorrectionSize() const { return corrections.size(); }
-
     private:
         std::array<IIRIdle<FloatType, FilterSize>, FilterNum> &iirFs;
         std::array<Ideal<FloatType, FilterSize>, FilterNum> &idealFs;
         zlContainer::FixedMaxSizeArray<size_t, FilterNum> &filterIndices;
         std::array<bool, FilterNum> &bypassMask;
+        // the routed & un-bypassed filters, which are only read by update
+        zlContainer::FixedMaxSizeArray<size_t, FilterNum> activeIndices;
         std::atomic<bool> toUpdate{true};
 
-        std::vector<std::complex<FloatType> > iirTotalResponse, idealTotalResponse;
-        // mixed corrections
+        // mixed corrections, bins below startMixIdx are always 1
         std::vector<std::complex<float> > corrections{};
+        // the correction of each band and their partial products
+        ProductTree<std::complex<float>, FilterNum> bandProducts;
+        std::array<bool, FilterNum> isBandActive{};
         std::vector<std::complex<FloatType> > &wis1, &wis2;
         std::vector<FloatType> correctionMix{};
 
-        std::unique_ptr<juce::dsp::FFT> fft;
-        std::unique_ptr<juce::dsp::WindowingFunction<float> > window;
-
         size_t fftOrder = defaultFFTOrder;
-        size_t fftSize = static_cast<size_t>(1) << fftOrder;
-        size_t numBins = fftSize / 2 + 1;
-        size_t overlap = 4; // 75% overlap
-        size_t hopSize = fftSize / overlap;
-        static constexpr float windowCorrection = 2.0f / 3.0f;
-        static constexpr float bypassCorrection = 1.0f / 4.0f;
-        // counts up until the next hop.
-        size_t count = 0;
-        // write position in input FIFO and read position in output FIFO.
-        size_t pos = 0;
-        // circular buffers for incoming and outgoing audio data.
-        std::vector<std::vector<float> > inputFIFOs, outputFIFOs;
-        // circular FFT working space which contains interleaved complex numbers.
-        std::vector<float> fftData;
-        size_t fftDataPos = 0;
-
-        std::atomic<int> latency{0};
 
-        void setOrder(const size_t channelNum, const size_t order) {
+        void setOrder(const size_t order) {
             fftOrder = order;
-            fftSize = static_cast<size_t>(1) << fftOrder;
-            numBins = fftSize / 2 + 1;
-            hopSize = fftSize / overlap;
-            latency.store(static_cast<int>(fftSize));
-
-            fft = std::make_unique<juce::dsp::FFT>(static_cast<int>(fftOrder));
-            window = std::make_unique<juce::dsp::WindowingFunction<float> >(
-                fftSize + 1, juce::dsp::WindowingFunction<float>::WindowingMethod::hann, false);
-
-            inputFIFOs.resize(channelNum);
-            outputFIFOs.resize(channelNum);
-            fftData.resize(fftSize * 2);
-
+            const auto numBins = (static_cast<size_t>(1) << fftOrder) / 2 + 1;
             corrections.resize(numBins);
+            std::fill(corrections.begin(), corrections.end(), std::complex(1.f, 0.f));
             correctionMix.resize(numBins);
-
-            reset();
+            bandProducts.setSize(numBins);
+            isBandActive.fill(false);
+            toUpdate.store(true);
         }
 
-        template<bool isBypassed = false>
-        void processFrame() {
-            for (size_t idx = 0; idx < inputFIFOs.size(); ++idx) {
-                const auto *inputPtr = inputFIFOs[idx].data();
-                auto *fftPtr = fftData.data();
-
-                // Copy the input FIFO into the FFT working space in two parts.
-                std::memcpy(fftPtr, inputPtr + pos, (fftSize - pos) * sizeof(float));
-                if (pos > 0) {
-                    std::memcpy(fftPtr + fftSize - pos, inputPtr, pos * sizeof(float));
-                }
-
-                if (!isBypassed) {
-                    window->multiplyWithWindowingTable(fftPtr, fftSize);
-
-                    fft->performRealOnlyForwardTransform(fftPtr, true);
-                    processSpectrum();
-                    fft->performRealOnlyInverseTransform(fftPtr);
-
-                    window->multiplyWithWindowingTable(fftPtr, fftSize);
-                    for (size_t i = 0; i < fftSize; ++i) {
-                        fftPtr[i] *= windowCorrection;
-                    }
-                } else {
-                    for (size_t i = 0; i < fftSize; ++i) {
-                        fftPtr[i] *= bypassCorrection;
-                    }
-                }
-
-                for (size_t i = 0; i < pos; ++i) {
-                    outputFIFOs[idx][i] += fftData[i + fftSize - pos];
-                }
-                for (size_t i = 0; i < fftSize - pos; ++i) {
-                    outputFIFOs[idx][i + pos] += fftData[i];
-                }
-            }
-        }
-
-        void processSpectrum() {
-            update();
-            auto *cdata = reinterpret_cast<std::complex<float> *>(fftData.data());
-            for (size_t i = startMixIdx; i < corrections.size(); ++i) {
-                cdata[i] = cdata[i] * corrections[i];
-            }
-        }
-
-        void update() {
-            // check whether a filter has been updated
-            bool needToUpdate{false};
-            for (size_t idx = 0; idx < filterIndices.size(); ++idx) {
-                const auto i = filterIndices[idx];
-                if (!bypassMask[i]) {
-                    needToUpdate = needToUpdate || idealFs[i].updateMixPhaseResponse(
-                        wis1, startMixIdx, endMixIdx, correctionMix);
-                    needToUpdate = needToUpdate || iirFs[i].updateResponse(wis2);
-                }
-            }
-            // if a filter has been updated or the correction has to be updated
-            if (needToUpdate || toUpdate.exchange(false)) {
-                bool hasBeenUpdated = false;
-                for (size_t idx = 0; idx < filterIndices.size(); ++idx) {
-                    const auto i = filterIndices[idx];
-                    if (!bypassMask[i]) {
-                        const auto &idealResponse = idealFs[i].getResponse();
-                        const auto &iirResponse = iirFs[i].getResponse();
-                        if (!hasBeenUpdated) {
-                            for (size_t j = startMixIdx; j < corrections.size() - 1; ++j) {
-                                corrections[j] = static_cast<std::complex<float>>(idealResponse[j] / iirResponse[j]);
-                            }
-                            hasBeenUpdated = true;
-                        } else {
-                            for (size_t j = startMixIdx; j < corrections.size() - 1; ++j) {
-                                corrections[j] *= static_cast<std::complex<float>>(idealResponse[j] / iirResponse[j]);
-                            }
-                        }
-                    }
-                }
-                if (!hasBeenUpdated) {
-                    std::fill(corrections.begin(), corrections.end(), std::complex(1.f, 0.f));
-                } else {
-                    // remove all infinity & NaN
-                    for (size_t j = startMixIdx; j < corrections.size() - 1; ++j) {
-                        if (!std::isfinite(corrections[j].real()) || !std::isfinite(corrections[j].imag())
-                            || std::abs(corrections[j].real()) > 10000.f || std::abs(corrections[j].imag()) > 10000.f) {
-                            corrections[j] = std::complex(1.f, 0.f);
-                        }
-                    }
-                    corrections.end()[-1] = std::abs(corrections.end()[-2]);
-                }
+        void updateBand(const size_t i) {
+            const auto &idealResponse = idealFs[i].getResponse();
+            const auto &iirResponse = iirFs[i].getResponse();
+            auto &band = bandProducts.getLeaf(i);
+            for (size_t j = startMixIdx; j < band.size() - 1; ++j) {
+                band[j] = static_cast<std::complex<float>>(idealResponse[j] / iirResponse[j]);
             }
+            bandProducts.setToUpdate(i);
         }
     };
 }
@@ -0,0 +1,84 @@
+// Copyright (C) 2024 - zsliu98
+// This file is part of ZLEqualizer
+//
+// ZLEqualizer is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License Version 3 as published by the Free Software Foundation.
+//
+// ZLEqualizer is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License along with ZLEqualizer. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ZLFILTER_PRODUCT_TREE_HPP
+#define ZLFILTER_PRODUCT_TREE_HPP
+
+#include <array>
+#include <bit>
+#include <vector>
+
+namespace zlFilter {
+    /**
+     * a binary tree of the partial products of per-band spectra
+     * each band owns a leaf and each node holds the product of its two children,
+     * so that changing one band only recomputes the log2(LeafNum) nodes on its path to the root
+     * the product is exact, i.e. no band is ever divided out
+     * @tparam ValueType the type of spectrum values
+     * @tparam LeafNum the number of leaves
+     */
+    template<typename ValueType, size_t LeafNum>
+    class ProductTree {
+    public:
+        // the number of leaves rounded up to a power of two, the extra leaves stay one
+        static constexpr size_t Width = std::bit_ceil(LeafNum);
+
+        ProductTree() = default;
+
+        /**
+         * resize all spectra and reset them to one
+         */
+        void setSize(const size_t x) {
+            // nodes[0] is not used, nodes[1] is the root
+            for (size_t node = 1; node < nodes.size(); ++node) {
+                nodes[node].resize(x);
+                std::fill(nodes[node].begin(), nodes[node].end(), ValueType(1));
+            }
+            isDirty.fill(false);
+        }
+
+        /**
+         * the spectrum of a leaf, call setToUpdate after writing it
+         */
+        std::vector<ValueType> &getLeaf(const size_t idx) { return nodes[Width + idx]; }
+
+        void setToUpdate(const size_t idx) { isDirty[(Width + idx) >> 1] = true; }
+
+        void setLeafToOne(const size_t idx) {
+            std::fill(nodes[Width + idx].begin(), nodes[Width + idx].end(), ValueType(1));
+            setToUpdate(idx);
+        }
+
+        /**
+         * recompute the nodes above the updated leaves
+         * @return the product of all leaves
+         */
+        const std::vector<ValueType> &update() {
+            // children always have larger indices than their parents
+            for (size_t node = Width - 1; node > 0; --node) {
+                if (!isDirty[node]) { continue; }
+                isDirty[node] = false;
+                isDirty[node >> 1] = true;
+                const auto &left = nodes[node << 1], &right = nodes[(node << 1) + 1];
+                auto &product = nodes[node];
+                for (size_t j = 0; j < product.size(); ++j) {
+                    product[j] = left[j] * right[j];
+                }
+            }
+            isDirty[0] = false;
+            return nodes[1];
+        }
+
+    private:
+        std::array<std::vector<ValueType>, Width * 2> nodes;
+        std::array<bool, Width> isDirty{};
+    };
+}
+
+#endif //ZLFILTER_PRODUCT_TREE_HPP
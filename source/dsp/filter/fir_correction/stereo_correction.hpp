@@ -0,0 +1,252 @@
+// Copyright (C) 2024 - zsliu98
+// This file is part of ZLEqualizer
+//
+// ZLEqualizer is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License Version 3 as published by the Free Software Foundation.
+//
+// ZLEqualizer is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License along with ZLEqualizer. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ZLFILTER_STEREO_CORRECTION_HPP
+#define ZLFILTER_STEREO_CORRECTION_HPP
+
+#include <cmath>
+
+#include <juce_dsp/juce_dsp.h>
+
+#include "correction_worker.hpp"
+#include "../../convolution/convolution.hpp"
+
+namespace zlFilter {
+    /**
+     * a stereo stage which applies the corrections of the stereo, left, right, mid and side groups together
+     * since L/R and M/S are linear transforms of the same stereo signal, all corrections are combined into
+     * a 2x2 matrix per bin, so the latency is always the same no matter how bands are routed
+     * with a mono spec, the single channel is the left channel of identical stereo channels,
+     * so the matrix collapses into the sum of its first row
+     * the matrix is turned into FIR kernels, which are applied by a uniformly partitioned convolution
+     * with partitions of 1/8 of the FFT size, hence the latency is 5/8 of the FFT size
+     * the corrections, the matrix & the kernels are built on the correction worker into the back kernel,
+     * which is swapped with the front one at a hop boundary
+     * @tparam FloatType the float type of input audio buffer
+     * @tparam Correction the correction spectrum of each group
+     */
+    template<typename FloatType, typename Correction>
+    class StereoCorrection final : private CorrectionJob {
+    public:
+        StereoCorrection(std::array<Correction, 5> &corrections, CorrectionWorker &worker)
+            : groupCorrections(corrections), workerRef(worker) {
+            workerRef.addJob(*this);
+        }
+
+        ~StereoCorrection() override {
+            workerRef.stop();
+        }
+
+        /**
+         * prepare the stage, call it while the correction worker is stopped
+         */
+        void prepare(const juce::dsp::ProcessSpec &spec) {
+            numChannels = spec.numChannels == 1 ? 1 : 2;
+            for (auto &c: groupCorrections) {
+                c.prepare(spec);
+            }
+            setOrder(groupCorrections[0].getFFTOrder());
+        }
+
+        void reset() {
+            conv.reset();
+        }
+
+        template<bool isBypassed = false>
+        void process(juce::AudioBuffer<FloatType> &buffer) {
+            conv.template process<isBypassed>(buffer, [this]() {
+                if constexpr (!isBypassed) {
+                    updateKernel();
+                }
+            });
+        }
+
+        /**
+         * set whether L/R and M/S groups are in use, call it on the audio thread
+         */
+        void setGroups(const bool isLR, const bool isMS) {
+            if (useLR != isLR || useMS != isMS) {
+                useLR = isLR;
+                useMS = isMS;
+                setToUpdate();
+            }
+        }
+
+        /**
+         * set the static gain of a group, which will be multiplied with the correction of the group
+         */
+        void setGroupGain(const size_t idx, const FloatType x) {
+            groupGains[idx].store(static_cast<float>(x));
+            toUpdateGain.store(true);
+        }
+
+        /**
+         * update all corrections at the next hop boundary
+         */
+        void setToUpdate() {
+            toUpdate.store(true);
+        }
+
+        int getLatency() const { return latency.load(); }
+
+        int getTailSamples() const { return conv.getTailSamples(); }
+
+        size_t getCorrectionSize() const { return numBins; }
+
+    private:
+        enum class JobState {
+            idle, requested, finished
+        };
+
+        /**
+         * the per-bin matrix {{m00, m01}, {m10, m11}} which is applied to {L, R}
+         */
+        struct Matrix {
+            // whether the corrections are diagonal, i.e. only the stereo group is in use
+            bool isDiagonal{true};
+            std::vector<std::complex<float> > m00, m01, m10, m11;
+        };
+
+        std::array<Correction, 5> &groupCorrections;
+        CorrectionWorker &workerRef;
+        bool useLR{false}, useMS{false};
+        std::array<std::atomic<float>, 5> groupGains{1.f, 1.f, 1.f, 1.f, 1.f};
+        std::atomic<bool> toUpdate{true};
+        // a gain change only rebuilds the matrix, the corrections stay as they are
+        std::atomic<bool> toUpdateGain{false};
+        size_t numChannels{2};
+
+        // the matrix is only used by the worker, the kernels are double-buffered inside the convolution
+        Matrix matrix;
+        zlConvolution::UniformPartitionConv<FloatType> conv;
+        std::atomic<JobState> jobState{JobState::idle};
+        // the groups in use of the requested job
+        bool jobUseLR{false}, jobUseMS{false};
+
+        // the partition size is 2^(fftOrder - partitionNumOrder)
+        static constexpr size_t partitionNumOrder = 3;
+        size_t fftOrder = 10;
+        size_t numBins = (static_cast<size_t>(1) << fftOrder) / 2 + 1;
+
+        std::atomic<int> latency{0};
+
+        void setOrder(const size_t order) {
+            fftOrder = order;
+            numBins = (static_cast<size_t>(1) << fftOrder) / 2 + 1;
+            conv.prepare(fftOrder, fftOrder - partitionNumOrder, numChannels);
+            latency.store(conv.getLatency());
+
+            matrix.isDiagonal = true;
+            for (auto m: {&matrix.m00, &matrix.m01, &matrix.m10, &matrix.m11}) {
+                m->resize(numBins);
+                std::fill(m->begin(), m->end(), std::complex<float>(1.f, 0.f));
+            }
+            jobState.store(JobState::idle);
+            setToUpdate();
+        }
+
+        /**
+         * swap in the kernel finished by the worker, and request a new one if anything is outdated
+         * it is called at hop boundaries on the audio thread
+         */
+        void updateKernel() {
+            const auto state = jobState.load(std::memory_order_acquire);
+            if (state == JobState::requested) { return; }
+            if (state == JobState::finished) {
+                // the old kernel is crossfaded out during this hop, so the next job is requested at the next hop
+                conv.swapKernel();
+                jobState.store(JobState::idle, std::memory_order_relaxed);
+                return;
+            }
+            bool toRequest = toUpdate.exchange(false);
+            if (toRequest) {
+                for (auto &c: groupCorrections) {
+                    c.setToUpdate();
+                }
+            }
+            toRequest = toUpdateGain.exchange(false) || toRequest || groupCorrections[0].getIsOutdated();
+            if (useLR) {
+                toRequest = toRequest || groupCorrections[1].getIsOutdated() || groupCorrections[2].getIsOutdated();
+            }
+            if (useMS) {
+                toRequest = toRequest || groupCorrections[3].getIsOutdated() || groupCorrections[4].getIsOutdated();
+            }
+            if (!toRequest) { return; }
+            // the worker reads the routing & the groups in use from the snapshot
+            for (auto &c: groupCorrections) {
+                c.syncRouting();
+            }
+            jobUseLR = useLR;
+            jobUseMS = useMS;
+            jobState.store(JobState::requested, std::memory_order_release);
+            workerRef.signal();
+        }
+
+        /**
+         * update the corrections, the matrix and the back kernel, it is called on the correction worker
+         */
+        void runJob() override {
+            if (jobState.load(std::memory_order_acquire) != JobState::requested) { return; }
+            groupCorrections[0].update();
+            if (jobUseLR) {
+                groupCorrections[1].update();
+                groupCorrections[2].update();
+            }
+            if (jobUseMS) {
+                groupCorrections[3].update();
+                groupCorrections[4].update();
+            }
+            updateMatrix();
+            conv.setBackKernel(matrix.m00, matrix.m01, matrix.m10, matrix.m11, matrix.isDiagonal);
+            jobState.store(JobState::finished, std::memory_order_release);
+        }
+
+        void updateMatrix() {
+            auto &[isDiagonal, m00, m01, m10, m11] = matrix;
+            const auto &c0 = groupCorrections[0].getCorrections();
+            const auto g0 = groupGains[0].load();
+            isDiagonal = !jobUseLR && !jobUseMS;
+            if (isDiagonal) {
+                for (size_t i = 0; i < numBins; ++i) {
+                    m00[i] = c0[i] * g0;
+                }
+                return;
+            }
+            // L/R corrections are applied first, then M/S corrections
+            // M = (L + R) / 2, S = (L - R) / 2, L = M + S, R = M - S
+            const auto &cL = groupCorrections[1].getCorrections();
+            const auto &cR = groupCorrections[2].getCorrections();
+            const auto &cM = groupCorrections[3].getCorrections();
+            const auto &cS = groupCorrections[4].getCorrections();
+            const auto gL = groupGains[1].load(), gR = groupGains[2].load();
+            const auto gM = groupGains[3].load(), gS = groupGains[4].load();
+            const std::complex<float> one{1.f, 0.f};
+            for (size_t i = 0; i < numBins; ++i) {
+                const auto l = jobUseLR ? cL[i] * gL : one;
+                const auto r = jobUseLR ? cR[i] * gR : one;
+                const auto m = jobUseMS ? cM[i] * gM : one;
+                const auto s = jobUseMS ? cS[i] * gS : one;
+                const auto p = (m + s) * (c0[i] * g0 * .5f);
+                const auto q = (m - s) * (c0[i] * g0 * .5f);
+                m00[i] = p * l;
+                m01[i] = q * r;
+                m10[i] = q * l;
+                m11[i] = p * r;
+            }
+            if (numChannels == 1) {
+                // L = m00 * L + m01 * R with R = L
+                for (size_t i = 0; i < numBins; ++i) {
+                    m00[i] += m01[i];
+                }
+            }
+        }
+    };
+}
+
+#endif //ZLFILTER_STEREO_CORRECTION_HPP
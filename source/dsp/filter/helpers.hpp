@@ -40,6 +40,39 @@ namespace zlFilter {
         return std::pow(10, db * 0.05);
     }
 
+    // 10^(a/20) for whole dB a in [-100, 100] and 10^(b/2000) for hundredths b in [0, 99]
+    inline const auto db_to_gain_coarse = [] {
+        std::array<double, 201> table{};
+        for (size_t i = 0; i < table.size(); ++i) {
+            table[i] = db_to_gain(static_cast<double>(i) - 100.0);
+        }
+        return table;
+    }();
+
+    inline const auto db_to_gain_fine = [] {
+        std::array<double, 100> table{};
+        for (size_t i = 0; i < table.size(); ++i) {
+            table[i] = db_to_gain(static_cast<double>(i) * 0.01);
+        }
+        return table;
+    }();
+
+    /**
+     * db_to_gain with a table-driven fast path for gains on the 0.01 dB grid within [-100, 100] dB
+     * (which is the grid of the gain parameters)
+     * the relative error of the fast path is below 3e-15 (as accurate as db_to_gain), other gains fall back to db_to_gain
+     */
+    inline double db_to_gain_fast(const double db) {
+        const auto x = db * 100;
+        const auto k = std::round(x);
+        if (std::abs(x - k) > 1e-6 || std::abs(k) > 10000) {
+            return db_to_gain(db);
+        }
+        const auto a = std::floor(k * 0.01);
+        const auto b = k - a * 100;
+        return db_to_gain_coarse[static_cast<size_t>(a + 100)] * db_to_gain_fine[static_cast<size_t>(b)];
+    }
+
     inline std::array<double, 2> get_bandwidth(const double w0, const double q) {
         const auto bw = 2 * std::asinh(0.5 / q) / std::log(2);
         const auto scale = std::pow(2, bw / 2);
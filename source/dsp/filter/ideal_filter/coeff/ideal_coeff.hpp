@@ -42,6 +42,38 @@ public:
 
     static std::array<double, 6> get2HighShelf(double w0, double g, double q);
 
+    /**
+     * exponents of (w0, g, q) in each coefficient {a0, a1, a2, b0, b1, b2}
+     * every coefficient is a monomial of w0, g and q, hence d coeff / d log(x) = exponent * coeff
+     * first order coefficients are placed as {a0, a1, 0, b0, b1, 0}
+     */
+    using Exps = std::array<std::array<double, 3>, 6>;
+
+    static constexpr Exps exps1LowPass{{{0, 0, 0}, {1, 0, 0}, {0, 0, 0}, {0, 0, 0}, {1, 0, 0}, {0, 0, 0}}};
+
+    static constexpr Exps exps1HighPass{{{0, 0, 0}, {1, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}}};
+
+    static constexpr Exps exps1TiltShelf{{{0, 0, 0}, {1, .5, 0}, {0, 0, 0}, {0, .5, 0}, {1, 0, 0}, {0, 0, 0}}};
+
+    static constexpr Exps exps1LowShelf{{{0, 0, 0}, {1, -.5, 0}, {0, 0, 0}, {0, 0, 0}, {1, .5, 0}, {0, 0, 0}}};
+
+    static constexpr Exps exps1HighShelf{{{0, -.5, 0}, {1, 0, 0}, {0, 0, 0}, {0, .5, 0}, {1, 0, 0}, {0, 0, 0}}};
+
+    static constexpr Exps exps2LowPass{{{0, 0, 0}, {1, 0, -1}, {2, 0, 0}, {0, 0, 0}, {0, 0, 0}, {2, 0, 0}}};
+
+    static constexpr Exps exps2HighPass{{{0, 0, 0}, {1, 0, -1}, {2, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}}};
+
+    static constexpr Exps exps2BandPass{{{0, 0, 0}, {1, 0, -1}, {2, 0, 0}, {0, 0, 0}, {1, 0, -1}, {0, 0, 0}}};
+
+    static constexpr Exps exps2Notch{{{0, 0, 0}, {1, 0, -1}, {2, 0, 0}, {0, 0, 0}, {0, 0, 0}, {2, 0, 0}}};
+
+    static constexpr Exps exps2Peak{{{0, 0, 0}, {1, -.5, -1}, {2, 0, 0}, {0, 0, 0}, {1, .5, -1}, {2, 0, 0}}};
+
+    static constexpr Exps exps2TiltShelf{{{0, 0, 0}, {1, .25, -1}, {2, .5, 0}, {0, .5, 0}, {1, .25, -1}, {2, 0, 0}}};
+
+    static constexpr Exps exps2LowShelf{{{0, .5, 0}, {1, .25, -1}, {2, 0, 0}, {0, .5, 0}, {1, .75, -1}, {2, 1, 0}}};
+
+    static constexpr Exps exps2HighShelf{{{0, 0, 0}, {1, .25, -1}, {2, .5, 0}, {0, 1, 0}, {1, .75, -1}, {2, .5, 0}}};
 };
 
 } // zlFilter
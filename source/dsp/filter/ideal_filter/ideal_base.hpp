@@ -12,6 +12,8 @@
 
 #include <array>
 #include <complex>
+#include <numbers>
+#include <vector>
 
 namespace zlFilter {
     template<typename SampleType>
@@ -25,6 +27,40 @@ namespace zlFilter {
             }
         }
 
+        /**
+         * accumulate the derivatives of the dB magnitude w.r.t. three parameters
+         * @param coeff the coefficients
+         * @param logGrads d log(coeff) / d parameters
+         * @param ws the angular frequencies
+         * @param grads the derivatives of the dB magnitude
+         */
+        static void updateDBGrads(
+            const std::array<double, 6> &coeff, const std::array<std::array<double, 3>, 6> &logGrads,
+            const std::vector<SampleType> &ws, std::array<std::vector<SampleType>, 3> &grads) {
+            std::array<std::array<double, 6>, 3> cGrads{};
+            for (size_t j = 0; j < 3; ++j) {
+                for (size_t k = 0; k < 6; ++k) {
+                    cGrads[j][k] = coeff[k] * logGrads[k][j];
+                }
+            }
+            constexpr auto scale = 20.0 / std::numbers::ln10;
+            for (size_t idx = 0; idx < ws.size(); ++idx) {
+                const auto w_2 = static_cast<double>(ws[idx]) * static_cast<double>(ws[idx]);
+                const auto t1 = coeff[2] - coeff[0] * w_2;
+                const auto denominator = coeff[1] * coeff[1] * w_2 + t1 * t1;
+                const auto t2 = coeff[5] - coeff[3] * w_2;
+                const auto numerator = coeff[4] * coeff[4] * w_2 + t2 * t2;
+                for (size_t j = 0; j < 3; ++j) {
+                    const auto &c = cGrads[j];
+                    // half of the derivatives of the denominator and the numerator
+                    const auto dDenominator = coeff[1] * c[1] * w_2 + t1 * (c[2] - c[0] * w_2);
+                    const auto dNumerator = coeff[4] * c[4] * w_2 + t2 * (c[5] - c[3] * w_2);
+                    grads[j][idx] += static_cast<SampleType>(
+                        scale * (dNumerator / numerator - dDenominator / denominator));
+                }
+            }
+        }
+
         static void updateResponse(
             const std::array<double, 6> &coeff,
             const std::vector<std::complex<SampleType> > &wis, std::vector<std::complex<SampleType> > &response) {
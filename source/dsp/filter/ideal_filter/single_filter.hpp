@@ -77,6 +77,9 @@ namespace zlFilter {
         void prepareDBSize(const size_t x) {
             dBs.resize(x);
             gains.resize(x);
+            for (auto &g: dBGrads) {
+                g.resize(x);
+            }
         }
 
         bool getMagOutdated() const { return toUpdatePara.load(); }
@@ -138,6 +141,28 @@ namespace zlFilter {
             return false;
         }
 
+        /**
+         * update dBs and their derivatives w.r.t. log(freq), gain (dB) and log(Q)
+         * @param ws the angular frequencies
+         */
+        void updateMagnitudeAndGrads(const std::vector<FloatType> &ws) {
+            toUpdatePara.store(false);
+            updateParas();
+            updateLogGrads();
+            std::fill(gains.begin(), gains.end(), FloatType(1));
+            for (auto &g: dBGrads) {
+                std::fill(g.begin(), g.end(), FloatType(0));
+            }
+            for (size_t i = 0; i < currentFilterNum; ++i) {
+                IdealBase<FloatType>::updateMagnitude(coeffs[i], ws, gains);
+                IdealBase<FloatType>::updateDBGrads(coeffs[i], logGrads[i], ws, dBGrads);
+            }
+            std::transform(gains.begin(), gains.end(), dBs.begin(),
+                           [](auto &g) {
+                               return g > FloatType(0) ? std::log10(g) * FloatType(20) : FloatType(-480);
+                           });
+        }
+
         void addDBs(std::vector<FloatType> &x) {
             std::transform(x.begin(), x.end(), dBs.begin(), x.begin(),
                            [](auto &c1, auto &c2) { return c1 + c2; });
@@ -155,12 +180,18 @@ namespace zlFilter {
             return g0 > FloatType(0) ? std::log10(g0) * FloatType(20) : FloatType(-480);
         }
 
+        std::array<std::vector<FloatType>, 3> &getDBGrads() {
+            return dBGrads;
+        }
+
         std::vector<std::complex<FloatType> > &getResponse() { return response; }
 
         void setToUpdate() { toUpdatePara.store(true); }
 
     private:
         std::array<std::array<double, 6>, FilterSize> coeffs{};
+        // d log(g) / d gain
+        static constexpr double gainLog = std::numbers::ln10 / 20;
         std::atomic<bool> toUpdatePara{true};
         std::atomic<size_t> order{2};
         size_t currentFilterNum{1};
@@ -168,6 +199,10 @@ namespace zlFilter {
         std::atomic<double> fs{48000.0};
         std::atomic<FilterType> filterType = FilterType::peak;
         std::vector<FloatType> dBs{}, gains{};
+        std::array<std::vector<FloatType>, 3> dBGrads{};
+        // d log(coeff) / d (log(freq), gain, log(Q)) of each cascading filter
+        std::array<IdealCoeff::Exps, FilterSize> logGrads{};
+        using ParaGrads = std::array<std::array<double, 3>, 3>;
         std::vector<std::complex<FloatType> > response{};
 
         void updateParas() {
@@ -176,6 +211,132 @@ namespace zlFilter {
                                                gain.load(), q.load(), coeffs);
         }
 
+        /**
+         * follow FilterDesign::updateCoeffs and calculate d log(w, g, q) / d (log(freq), gain, log(Q))
+         * of each cascading filter, then chain them with the coefficient exponents
+         */
+        void updateLogGrads() {
+            const auto n = order.load();
+            const auto q0 = q.load();
+            switch (filterType.load()) {
+                case FilterType::peak: {
+                    if (n == 2) {
+                        setLogGrads(0, IdealCoeff::exps2Peak, {{{1, 0, 0}, {0, gainLog, 0}, {0, 0, 1}}});
+                    } else {
+                        updateBandShelfLogGrads(n, q0);
+                    }
+                    return;
+                }
+                case FilterType::lowShelf: {
+                    updateShelfLogGrads(n, 0, IdealCoeff::exps1LowShelf, IdealCoeff::exps2LowShelf,
+                                        {1, 0, 0}, gainLog, .5);
+                    return;
+                }
+                case FilterType::highShelf: {
+                    updateShelfLogGrads(n, 0, IdealCoeff::exps1HighShelf, IdealCoeff::exps2HighShelf,
+                                        {1, 0, 0}, gainLog, .5);
+                    return;
+                }
+                case FilterType::tiltShelf: {
+                    updateShelfLogGrads(n, 0, IdealCoeff::exps1TiltShelf, IdealCoeff::exps2TiltShelf,
+                                        {1, 0, 0}, gainLog, .5);
+                    return;
+                }
+                case FilterType::lowPass: {
+                    updateShelfLogGrads(n, 0, IdealCoeff::exps1LowPass, IdealCoeff::exps2LowPass,
+                                        {1, 0, 0}, 0, 1);
+                    return;
+                }
+                case FilterType::highPass: {
+                    updateShelfLogGrads(n, 0, IdealCoeff::exps1HighPass, IdealCoeff::exps2HighPass,
+                                        {1, 0, 0}, 0, 1);
+                    return;
+                }
+                case FilterType::bandShelf: {
+                    updateBandShelfLogGrads(n, q0);
+                    return;
+                }
+                case FilterType::notch:
+                case FilterType::bandPass: {
+                    // the q of each cascading filter is proportional to Q
+                    const auto &exps = filterType.load() == FilterType::notch
+                                           ? IdealCoeff::exps2Notch
+                                           : IdealCoeff::exps2BandPass;
+                    for (size_t i = 0; i < currentFilterNum; ++i) {
+                        setLogGrads(i, exps, {{{1, 0, 0}, {0, 0, 0}, {0, 0, 1}}});
+                    }
+                    return;
+                }
+            }
+        }
+
+        /**
+         * @param wGrads d log(w) / d (log(freq), gain, log(Q))
+         * @param gGrad d log(g) / d gain of the whole cascade
+         * @param qGrad d log(q) / d log(Q) of the whole cascade
+         * @return the number of cascading filters
+         */
+        size_t updateShelfLogGrads(const size_t n, const size_t startIdx,
+                                   const IdealCoeff::Exps &exps1, const IdealCoeff::Exps &exps2,
+                                   const std::array<double, 3> &wGrads, const double gGrad, const double qGrad) {
+            if (n == 1) {
+                setLogGrads(startIdx, exps1, {{wGrads, {0, gGrad, 0}, {0, 0, 0}}});
+                return 1;
+            }
+            const size_t number = n / 2;
+            const auto numberInv = 1 / static_cast<double>(number);
+            const auto rescaleGrad = std::numbers::ln2 / std::numbers::ln10 / std::pow(static_cast<double>(n), 1.5) * 12;
+            for (size_t i = 0; i < number; i++) {
+                const auto centered = static_cast<double>(i) - static_cast<double>(number) / 2 + 0.5;
+                setLogGrads(i + startIdx, exps2, {
+                                {
+                                    wGrads, {0, gGrad * numberInv, 0},
+                                    {0, 0, qGrad * (numberInv + centered * rescaleGrad)}
+                                }
+                            });
+            }
+            return number;
+        }
+
+        void updateBandShelfLogGrads(const size_t n, const double q0) {
+            if (n < 2) { return; }
+            const auto w0 = ppi * freq.load() / fs.load();
+            const auto halfbw = std::asinh(0.5 / q0) / std::log(2);
+            const auto scale = std::pow(2, halfbw);
+            const auto w1 = w0 / scale;
+            const auto w2 = w0 * scale;
+            const auto f1 = w1 > 10.0 * 2 * pi / 48000, f2 = w2 < 22000.0 * 2 * pi / 48000;
+            // d log(scale) / d log(Q)
+            const auto scaleGrad = -0.5 / q0 / std::sqrt(1 + 0.25 / q0 / q0);
+            if (f1 && f2) {
+                const auto n1 = updateShelfLogGrads(n, 0, IdealCoeff::exps1LowShelf, IdealCoeff::exps2LowShelf,
+                                                    {1, 0, -scaleGrad}, -gainLog, 0);
+                updateShelfLogGrads(n, n1, IdealCoeff::exps1LowShelf, IdealCoeff::exps2LowShelf,
+                                    {1, 0, scaleGrad}, gainLog, 0);
+            } else if (f1) {
+                updateShelfLogGrads(n, 0, IdealCoeff::exps1HighShelf, IdealCoeff::exps2HighShelf,
+                                    {1, 0, -scaleGrad}, gainLog, 0);
+            } else if (f2) {
+                updateShelfLogGrads(n, 0, IdealCoeff::exps1LowShelf, IdealCoeff::exps2LowShelf,
+                                    {1, 0, scaleGrad}, gainLog, 0);
+            } else {
+                logGrads[0] = {};
+                for (size_t k = 3; k < 6; ++k) {
+                    logGrads[0][k][1] = gainLog;
+                }
+            }
+        }
+
+        void setLogGrads(const size_t idx, const IdealCoeff::Exps &exps, const ParaGrads &paraGrads) {
+            for (size_t k = 0; k < 6; ++k) {
+                for (size_t j = 0; j < 3; ++j) {
+                    logGrads[idx][k][j] = exps[k][0] * paraGrads[0][j]
+                                          + exps[k][1] * paraGrads[1][j]
+                                          + exps[k][2] * paraGrads[2][j];
+                }
+            }
+        }
+
         static size_t updateIIRCoeffs(const FilterType filterType, const size_t n,
                                       const double f, const double fs, const double g0, const double q0,
                                       std::array<std::array<double, 6>, FilterSize> &coeffs) {
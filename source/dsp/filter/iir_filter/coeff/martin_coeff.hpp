@@ -11,6 +11,8 @@
 #define ZLFILTER_MARTIN_COEFFS_H
 
 #include "analog_func.hpp"
+#include "../../filter_design/filter_design.hpp"
+#include "../../filter_design/coeff_cache.hpp"
 #include <numbers>
 
 namespace zlFilter {
@@ -42,7 +44,49 @@ namespace zlFilter {
 
         static std::array<double, 6> get2HighShelf(double w0, double g, double q);
 
+        /**
+         * design the cascading biquads with FilterDesign::updateCoeffs, through a cache shared by all filters
+         * the cache only hits on exactly the same parameters, so the design does not depend on the cache state
+         * @tparam useCache set it to false for parameters which hardly repeat, e.g. the dynamic gain,
+         * so that they do not evict the designs of the static filters
+         * @return the number of biquads
+         */
+        template<size_t ArraySize, bool useCache = true>
+        static size_t updateCoeffs(const FilterType filterType, const size_t n,
+                                   const double f, const double fs, const double gDB, const double q0,
+                                   std::array<std::array<double, 6>, ArraySize> &coeffs) {
+            if constexpr (useCache) {
+                const auto key = CoeffCache<ArraySize>::getKey(filterType, n, f, fs, gDB, q0);
+                size_t num = 0;
+                if (cache<ArraySize>.load(key, coeffs, num)) {
+                    return num;
+                }
+                num = design(filterType, n, f, fs, gDB, q0, coeffs);
+                cache<ArraySize>.store(key, coeffs, num);
+                return num;
+            } else {
+                return design(filterType, n, f, fs, gDB, q0, coeffs);
+            }
+        }
+
     private:
+        template<size_t ArraySize>
+        inline static CoeffCache<ArraySize> cache{};
+
+        template<size_t ArraySize>
+        static size_t design(const FilterType filterType, const size_t n,
+                             const double f, const double fs, const double gDB, const double q0,
+                             std::array<std::array<double, 6>, ArraySize> &coeffs) {
+            return FilterDesign::updateCoeffs<ArraySize,
+                get1LowShelf, get1HighShelf, get1TiltShelf,
+                get1LowPass, get1HighPass,
+                get2Peak,
+                get2LowShelf, get2HighShelf, get2TiltShelf,
+                get2LowPass, get2HighPass,
+                get2BandPass, get2Notch>(
+                filterType, n, f, fs, gDB, q0, coeffs);
+        }
+
         constexpr static double piHalf = std::numbers::pi * 0.5;
         constexpr static double pi = std::numbers::pi;
         constexpr static double pi2 = std::numbers::pi * std::numbers::pi;
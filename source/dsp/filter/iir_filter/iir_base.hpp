@@ -13,9 +13,25 @@
 #include <numbers>
 
 namespace zlFilter {
+    /**
+     * a biquad in transposed direct form II
+     * the coefficients and the states are kept inline in one cache-aligned block (two lines)
+     * so that an array of sections is a contiguous block without any pointer chasing
+     * the coefficients and the states are always double, only the input & output follow the sample type
+     * @tparam SampleType
+     */
     template<typename SampleType>
-    class IIRBase {
+    class alignas(64) IIRBase {
     public:
+        static constexpr size_t MaxChannelNum = 2;
+
+        /**
+         * the type of the coefficients and the states
+         * float coefficients of a pole pair close to z = 1 (a band around 20 Hz) leave an error of about -55 dB,
+         * so the biquads compute in double even in the float engine
+         */
+        using ComputeType = double;
+
         // w should be an array of std::exp(-2pi * f / samplerate * i)
         static void updateResponse(
             const std::array<double, 6> &coeff,
@@ -38,17 +54,34 @@ namespace zlFilter {
                     static_cast<SampleType>(coeff[2]) * wi2);
         }
 
+        /**
+         * estimate the number of samples the impulse response takes to decay by 120 dB
+         * from the largest pole radius of biquad coefficients {a0, a1, a2, b0, b1, b2}
+         */
+        static double getTailSamples(const std::array<double, 6> &coeff) {
+            const auto a1 = coeff[1] / coeff[0], a2 = coeff[2] / coeff[0];
+            const auto disc = a1 * a1 - 4 * a2;
+            const auto r = disc < 0
+                               ? std::sqrt(a2)
+                               : 0.5 * (std::abs(a1) + std::sqrt(disc));
+            if (r < 1e-6) return 2.0;
+            if (r >= 1.0) return maxTailSamples;
+            // close poles (e.g. a high Q at a low frequency) amplify the response by 1 / their distance
+            const auto spread = std::clamp(std::sqrt(std::abs(disc)) / (2 * r), 1e-6, 1.0);
+            return std::min(std::log(1e-6 * spread) / std::log(r) + 2.0, maxTailSamples);
+        }
+
         IIRBase() = default;
 
         void prepare(const juce::dsp::ProcessSpec &spec) {
-            s1.resize(spec.numChannels);
-            s2.resize(spec.numChannels);
+            jassert(spec.numChannels <= MaxChannelNum);
+            juce::ignoreUnused(spec);
             reset();
         }
 
         void reset() {
-            std::fill(s1.begin(), s1.end(), static_cast<SampleType>(0));
-            std::fill(s2.begin(), s2.end(), static_cast<SampleType>(0));
+            s1.fill(ComputeType(0));
+            s2.fill(ComputeType(0));
         }
 
         void snapToZero() {
@@ -74,19 +107,16 @@ namespace zlFilter {
                 if (context.usesSeparateInputAndOutputBlocks()) {
                     outputBlock.copyFrom(inputBlock);
                 }
-                for (size_t channel = 0; channel < numChannels; ++channel) {
-                    auto *inputSamples = inputBlock.getChannelPointer(channel);
-                    for (size_t i = 0; i < numSamples; ++i) {
-                        processSample(channel, inputSamples[i]);
-                    }
+                if (toRamp) {
+                    processChannels<true, true>(inputBlock, outputBlock, numChannels, numSamples);
+                } else {
+                    processChannels<true, false>(inputBlock, outputBlock, numChannels, numSamples);
                 }
             } else {
-                for (size_t channel = 0; channel < numChannels; ++channel) {
-                    auto *inputSamples = inputBlock.getChannelPointer(channel);
-                    auto *outputSamples = outputBlock.getChannelPointer(channel);
-                    for (size_t i = 0; i < numSamples; ++i) {
-                        outputSamples[i] = processSample(channel, inputSamples[i]);
-                    }
+                if (toRamp) {
+                    processChannels<false, true>(inputBlock, outputBlock, numChannels, numSamples);
+                } else {
+                    processChannels<false, false>(inputBlock, outputBlock, numChannels, numSamples);
                 }
             }
 
@@ -96,24 +126,146 @@ namespace zlFilter {
         }
 
         SampleType processSample(const size_t channel, SampleType inputValue) {
-            const auto outputValue = inputValue * mCoeff[0] + s1[channel];
-            s1[channel] = (inputValue * mCoeff[1]) - (outputValue * mCoeff[3]) + s2[channel];
-            s2[channel] = (inputValue * mCoeff[2]) - (outputValue * mCoeff[4]);
-            return outputValue;
+            const auto x = static_cast<ComputeType>(inputValue);
+            const auto outputValue = x * mCoeff[0] + s1[channel];
+            s1[channel] = (x * mCoeff[1]) - (outputValue * mCoeff[3]) + s2[channel];
+            s2[channel] = (x * mCoeff[2]) - (outputValue * mCoeff[4]);
+            return static_cast<SampleType>(outputValue);
+        }
+
+        /**
+         * process all channels of one sample together, the state is kept in local lanes during the whole block
+         * so that the compiler can put L/R of this biquad into one SIMD register
+         * @tparam isBypassed whether only the state gets updated
+         * @tparam isRamping whether coefficients move linearly towards the ramp target during the block
+         * @tparam NumChannels the number of channels
+         */
+        template<bool isBypassed, bool isRamping, size_t NumChannels, typename InputBlock, typename OutputBlock>
+        void processInterleaved(const InputBlock &inputBlock, OutputBlock &outputBlock,
+                                const size_t startChannel, const size_t numSamples) noexcept {
+            std::array<const SampleType *, NumChannels> inputs;
+            std::array<SampleType *, NumChannels> outputs;
+            alignas(32) std::array<ComputeType, NumChannels> z1, z2;
+            for (size_t channel = 0; channel < NumChannels; ++channel) {
+                inputs[channel] = inputBlock.getChannelPointer(startChannel + channel);
+                outputs[channel] = outputBlock.getChannelPointer(startChannel + channel);
+                z1[channel] = s1[startChannel + channel];
+                z2[channel] = s2[startChannel + channel];
+            }
+            auto b0 = mCoeff[0], b1 = mCoeff[1], b2 = mCoeff[2], a1 = mCoeff[3], a2 = mCoeff[4];
+            ComputeType db0{0}, db1{0}, db2{0}, da1{0}, da2{0};
+            if constexpr (isRamping) {
+                const auto step = ComputeType(1) / static_cast<ComputeType>(numSamples);
+                db0 = (rampCoeff[0] - b0) * step;
+                db1 = (rampCoeff[1] - b1) * step;
+                db2 = (rampCoeff[2] - b2) * step;
+                da1 = (rampCoeff[3] - a1) * step;
+                da2 = (rampCoeff[4] - a2) * step;
+            }
+            for (size_t i = 0; i < numSamples; ++i) {
+                alignas(32) std::array<ComputeType, NumChannels> x, y;
+                for (size_t channel = 0; channel < NumChannels; ++channel) {
+                    x[channel] = inputs[channel][i];
+                }
+                for (size_t channel = 0; channel < NumChannels; ++channel) {
+                    y[channel] = x[channel] * b0 + z1[channel];
+                    z1[channel] = x[channel] * b1 - y[channel] * a1 + z2[channel];
+                    z2[channel] = x[channel] * b2 - y[channel] * a2;
+                }
+                if constexpr (!isBypassed) {
+                    for (size_t channel = 0; channel < NumChannels; ++channel) {
+                        outputs[channel][i] = static_cast<SampleType>(y[channel]);
+                    }
+                }
+                if constexpr (isRamping) {
+                    b0 += db0;
+                    b1 += db1;
+                    b2 += db2;
+                    a1 += da1;
+                    a2 += da2;
+                }
+            }
+            for (size_t channel = 0; channel < NumChannels; ++channel) {
+                s1[startChannel + channel] = z1[channel];
+                s2[startChannel + channel] = z2[channel];
+            }
         }
 
+        /**
+         * update the coefficients from biquad coefficients {a0, a1, a2, b0, b1, b2}
+         * @tparam ramp if true, the coefficients move linearly to the new values during the next processed block
+         * (since the stability triangle of a1 & a2 is convex, the ramp between two stable filters stays stable)
+         * @param coeff
+         */
+        template<bool ramp = false>
         void updateFromBiquad(const std::array<double, 6> &coeff) {
             const auto a0Inv = 1.0 / coeff[0];
-            mCoeff[0] = static_cast<SampleType>(coeff[3] * a0Inv);
-            mCoeff[1] = static_cast<SampleType>(coeff[4] * a0Inv);
-            mCoeff[2] = static_cast<SampleType>(coeff[5] * a0Inv);
-            mCoeff[3] = static_cast<SampleType>(coeff[1] * a0Inv);
-            mCoeff[4] = static_cast<SampleType>(coeff[2] * a0Inv);
+            auto &target = ramp ? rampCoeff : mCoeff;
+            target[0] = coeff[3] * a0Inv;
+            target[1] = coeff[4] * a0Inv;
+            target[2] = coeff[5] * a0Inv;
+            target[3] = coeff[1] * a0Inv;
+            target[4] = coeff[2] * a0Inv;
+            toRamp = ramp;
+        }
+
+        /**
+         * the coefficients {b0, b1, b2, a1, a2} and the states are exposed for IIRCascade
+         */
+        const std::array<ComputeType, 5> &getCoeff() const { return mCoeff; }
+
+        const std::array<ComputeType, 5> &getRampCoeff() const { return rampCoeff; }
+
+        bool getToRamp() const { return toRamp; }
+
+        std::array<ComputeType, MaxChannelNum> &getS1() { return s1; }
+
+        std::array<ComputeType, MaxChannelNum> &getS2() { return s2; }
+
+        /**
+         * jump to the ramp target, call it after the ramping block has been processed outside
+         */
+        void finishRamp() {
+            if (toRamp) {
+                mCoeff = rampCoeff;
+                toRamp = false;
+            }
         }
 
     private:
-        std::array<SampleType, 5> mCoeff{0, 0, 0, 0, 0};
-        std::vector<SampleType> s1, s2;
+        static constexpr double maxTailSamples = 16777216.0;
+
+        // hot: read & written on every block
+        std::array<ComputeType, 5> mCoeff{0, 0, 0, 0, 0};
+        std::array<ComputeType, MaxChannelNum> s1{}, s2{};
+        bool toRamp{false};
+        // warm: only read when the coefficients ramp
+        std::array<ComputeType, 5> rampCoeff{0, 0, 0, 0, 0};
+
+        template<bool isBypassed, bool isRamping, typename InputBlock, typename OutputBlock>
+        void processChannels(const InputBlock &inputBlock, OutputBlock &outputBlock,
+                             const size_t numChannels, const size_t numSamples) noexcept {
+            static_assert(MaxChannelNum == 2, "add a lane for every channel number up to MaxChannelNum");
+            jassert(numChannels <= MaxChannelNum);
+            // the states only hold MaxChannelNum channels, the channels above are left unprocessed
+            switch (std::min(numChannels, MaxChannelNum)) {
+                case 1: {
+                    processInterleaved<isBypassed, isRamping, 1>(inputBlock, outputBlock, 0, numSamples);
+                    break;
+                }
+                case 2: {
+                    processInterleaved<isBypassed, isRamping, 2>(inputBlock, outputBlock, 0, numSamples);
+                    break;
+                }
+                default: {
+                    break;
+                }
+            }
+            if constexpr (isRamping) {
+                mCoeff = rampCoeff;
+                toRamp = false;
+            }
+        }
     };
 }
 
@@ -0,0 +1,162 @@
+// Copyright (C) 2024 - zsliu98
+// This file is part of ZLEqualizer
+//
+// ZLEqualizer is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License Version 3 as published by the Free Software Foundation.
+//
+// ZLEqualizer is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License along with ZLEqualizer. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef IIR_CASCADE_HPP
+#define IIR_CASCADE_HPP
+
+#include "iir_base.hpp"
+
+namespace zlFilter {
+    /**
+     * a chain of biquads collected from several filters, which are processed in a single pass over the samples
+     * each sample runs through the whole chain before the next one is read, so the buffer is read & written once
+     * and the coefficients & states of the chain stay in L1 instead of being streamed per biquad
+     * the result is identical to processing the biquads one after another
+     * @tparam SampleType
+     * @tparam MaxSectionNum the maximum number of biquads
+     */
+    template<typename SampleType, size_t MaxSectionNum>
+    class IIRCascade {
+    public:
+        IIRCascade() = default;
+
+        void clear() {
+            sectionNum = 0;
+            isRamping = false;
+        }
+
+        size_t getSectionNum() const { return sectionNum; }
+
+        size_t getFreeNum() const { return MaxSectionNum - sectionNum; }
+
+        /**
+         * append a biquad to the end of the chain
+         * @param section
+         * @param isBypassed if true, the biquad only updates its state and passes the signal unchanged
+         */
+        void push(IIRBase<SampleType> &section, const bool isBypassed) {
+            jassert(sectionNum < MaxSectionNum);
+            sections[sectionNum] = &section;
+            bypasses[sectionNum] = isBypassed;
+            isRamping = isRamping || section.getToRamp();
+            sectionNum += 1;
+        }
+
+        /**
+         * process the audio buffer through the whole chain and clear the chain
+         * @param buffer
+         */
+        void process(juce::AudioBuffer<SampleType> &buffer) noexcept {
+            if (sectionNum == 0) return;
+            if (isRamping) {
+                processChannels<true>(buffer);
+            } else {
+                processChannels<false>(buffer);
+            }
+            for (size_t s = 0; s < sectionNum; ++s) {
+                sections[s]->finishRamp();
+#if JUCE_DSP_ENABLE_SNAP_TO_ZERO
+                sections[s]->snapToZero();
+#endif
+            }
+            clear();
+        }
+
+    private:
+        std::array<IIRBase<SampleType> *, MaxSectionNum> sections{};
+        std::array<bool, MaxSectionNum> bypasses{};
+        size_t sectionNum{0};
+        bool isRamping{false};
+
+        using ComputeType = typename IIRBase<SampleType>::ComputeType;
+
+        alignas(32) std::array<std::array<ComputeType, 5>, MaxSectionNum> coeffs{}, deltas{};
+        alignas(32) std::array<std::array<ComputeType, IIRBase<SampleType>::MaxChannelNum>, MaxSectionNum> z1s{}, z2s{};
+
+        template<bool isRamping>
+        void processChannels(juce::AudioBuffer<SampleType> &buffer) noexcept {
+            auto *const *channels = buffer.getArrayOfWritePointers();
+            const auto numChannels = static_cast<size_t>(buffer.getNumChannels());
+            const auto numSamples = static_cast<size_t>(buffer.getNumSamples());
+            jassert(numChannels <= IIRBase<SampleType>::MaxChannelNum);
+            // the states only hold MaxChannelNum channels, the channels above are left unprocessed
+            switch (std::min(numChannels, IIRBase<SampleType>::MaxChannelNum)) {
+                case 1: {
+                    processInterleaved<isRamping, 1>(channels, 0, numSamples);
+                    break;
+                }
+                case 2: {
+                    processInterleaved<isRamping, 2>(channels, 0, numSamples);
+                    break;
+                }
+                default: {
+                    break;
+                }
+            }
+        }
+
+        template<bool isRamping, size_t NumChannels>
+        void processInterleaved(SampleType *const *channels,
+                                const size_t startChannel, const size_t numSamples) noexcept {
+            const auto step = ComputeType(1) / static_cast<ComputeType>(numSamples);
+            for (size_t s = 0; s < sectionNum; ++s) {
+                coeffs[s] = sections[s]->getCoeff();
+                if constexpr (isRamping) {
+                    const auto &target = sections[s]->getToRamp() ? sections[s]->getRampCoeff() : coeffs[s];
+                    for (size_t j = 0; j < 5; ++j) {
+                        deltas[s][j] = (target[j] - coeffs[s][j]) * step;
+                    }
+                }
+                const auto &s1 = sections[s]->getS1(), &s2 = sections[s]->getS2();
+                for (size_t channel = 0; channel < NumChannels; ++channel) {
+                    z1s[s][channel] = s1[startChannel + channel];
+                    z2s[s][channel] = s2[startChannel + channel];
+                }
+            }
+            for (size_t i = 0; i < numSamples; ++i) {
+                alignas(32) std::array<ComputeType, NumChannels> x;
+                for (size_t channel = 0; channel < NumChannels; ++channel) {
+                    x[channel] = channels[startChannel + channel][i];
+                }
+                for (size_t s = 0; s < sectionNum; ++s) {
+                    const auto &c = coeffs[s];
+                    auto &z1 = z1s[s], &z2 = z2s[s];
+                    alignas(32) std::array<ComputeType, NumChannels> y;
+                    for (size_t channel = 0; channel < NumChannels; ++channel) {
+                        y[channel] = x[channel] * c[0] + z1[channel];
+                        z1[channel] = x[channel] * c[1] - y[channel] * c[3] + z2[channel];
+                        z2[channel] = x[channel] * c[2] - y[channel] * c[4];
+                    }
+                    if (!bypasses[s]) {
+                        x = y;
+                    }
+                }
+                for (size_t channel = 0; channel < NumChannels; ++channel) {
+                    channels[startChannel + channel][i] = static_cast<SampleType>(x[channel]);
+                }
+                if constexpr (isRamping) {
+                    for (size_t s = 0; s < sectionNum; ++s) {
+                        for (size_t j = 0; j < 5; ++j) {
+                            coeffs[s][j] += deltas[s][j];
+                        }
+                    }
+                }
+            }
+            for (size_t s = 0; s < sectionNum; ++s) {
+                auto &s1 = sections[s]->getS1(), &s2 = sections[s]->getS2();
+                for (size_t channel = 0; channel < NumChannels; ++channel) {
+                    s1[startChannel + channel] = z1s[s][channel];
+                    s2[startChannel + channel] = z2s[s][channel];
+                }
+            }
+        }
+    };
+}
+
+#endif //IIR_CASCADE_HPP
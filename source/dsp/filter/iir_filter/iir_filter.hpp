@@ -10,6 +10,8 @@
 #ifndef ZLEQUALIZER_IIR_FILTER_HPP
 #define ZLEQUALIZER_IIR_FILTER_HPP
 
+#include "iir_cascade.hpp"
+#include "iir_parallel_bank.hpp"
 #include "single_filter.hpp"
 #include "single_idle_filter.hpp"
 
@@ -0,0 +1,229 @@
+// Copyright (C) 2024 - zsliu98
+// This file is part of ZLEqualizer
+//
+// ZLEqualizer is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License Version 3 as published by the Free Software Foundation.
+//
+// ZLEqualizer is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License along with ZLEqualizer. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef IIR_PARALLEL_BANK_HPP
+#define IIR_PARALLEL_BANK_HPP
+
+#include "iir_base.hpp"
+
+namespace zlFilter {
+    /**
+     * a bank of parallel branches, each of which is a chain of biquads followed by a gain
+     * every branch is evaluated from a single read of the input and the weighted outputs are summed up,
+     * so that no branch needs its own copy of the input buffer
+     * the branches of one sample are independent, which leaves the CPU free to overlap their biquads
+     * @tparam SampleType
+     * @tparam MaxBranchNum the maximum number of branches
+     * @tparam MaxSectionNum the maximum number of biquads of all branches
+     */
+    template<typename SampleType, size_t MaxBranchNum, size_t MaxSectionNum>
+    class IIRParallelBank {
+    public:
+        IIRParallelBank() = default;
+
+        void prepare(const juce::dsp::ProcessSpec &spec) {
+            sumBuffer.setSize(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize));
+            clear();
+            isSumEmpty = true;
+        }
+
+        void clear() {
+            branchNum = 0;
+            sectionNum = 0;
+            isRamping = false;
+        }
+
+        /**
+         * @return the number of biquads which can still be pushed, zero if there is no free branch
+         */
+        size_t getFreeNum() const { return branchNum < MaxBranchNum ? MaxSectionNum - sectionNum : 0; }
+
+        /**
+         * append a branch
+         * @param branchSections the biquads of the branch
+         * @param branchSectionNum the number of biquads
+         * @param startGain the gain at the start of the block
+         * @param endGain the gain at the end of the block
+         * @param isBypassed if true, the branch only updates its state and does not contribute to the sum
+         * @param isPassThrough if true, the biquads only update their states and the branch outputs the weighted input
+         */
+        void push(IIRBase<SampleType> *branchSections, const size_t branchSectionNum,
+                  const SampleType startGain, const SampleType endGain,
+                  const bool isBypassed, const bool isPassThrough) {
+            jassert(branchNum < MaxBranchNum && sectionNum + branchSectionNum <= MaxSectionNum);
+            branchEnds[branchNum] = sectionNum + branchSectionNum;
+            startGains[branchNum] = startGain;
+            endGains[branchNum] = endGain;
+            bypasses[branchNum] = isBypassed;
+            passThroughs[branchNum] = isPassThrough;
+            branchNum += 1;
+            for (size_t s = 0; s < branchSectionNum; ++s) {
+                sections[sectionNum] = &branchSections[s];
+                isRamping = isRamping || branchSections[s].getToRamp();
+                sectionNum += 1;
+            }
+        }
+
+        /**
+         * process the input through all branches, add the result to the internal sum and clear the branches
+         * the input buffer is not changed
+         * @param buffer
+         */
+        void process(const juce::AudioBuffer<SampleType> &buffer) noexcept {
+            if (branchNum == 0) return;
+            if (isRamping) {
+                processChannels<true>(buffer);
+            } else {
+                processChannels<false>(buffer);
+            }
+            for (size_t s = 0; s < sectionNum; ++s) {
+                sections[s]->finishRamp();
+#if JUCE_DSP_ENABLE_SNAP_TO_ZERO
+                sections[s]->snapToZero();
+#endif
+            }
+            clear();
+        }
+
+        /**
+         * add the internal sum to the audio buffer and reset the sum
+         * @param buffer
+         */
+        void processPost(juce::AudioBuffer<SampleType> &buffer) {
+            if (isSumEmpty) return;
+            const auto numChannels = std::min(buffer.getNumChannels(), sumBuffer.getNumChannels());
+            for (int channel = 0; channel < numChannels; ++channel) {
+                auto *dest = buffer.getWritePointer(channel);
+                auto *source = sumBuffer.getReadPointer(channel);
+                for (size_t idx = 0; idx < static_cast<size_t>(buffer.getNumSamples()); ++idx) {
+                    dest[idx] = dest[idx] + source[idx];
+                }
+            }
+            isSumEmpty = true;
+        }
+
+    private:
+        std::array<IIRBase<SampleType> *, MaxSectionNum> sections{};
+        size_t sectionNum{0};
+        std::array<size_t, MaxBranchNum> branchEnds{};
+        std::array<SampleType, MaxBranchNum> startGains{}, endGains{};
+        std::array<bool, MaxBranchNum> bypasses{}, passThroughs{};
+        size_t branchNum{0};
+        bool isRamping{false};
+
+        juce::AudioBuffer<SampleType> sumBuffer;
+        bool isSumEmpty{true};
+
+        using ComputeType = typename IIRBase<SampleType>::ComputeType;
+
+        alignas(32) std::array<std::array<ComputeType, 5>, MaxSectionNum> coeffs{}, deltas{};
+        alignas(32) std::array<std::array<ComputeType, IIRBase<SampleType>::MaxChannelNum>, MaxSectionNum> z1s{}, z2s{};
+        std::array<ComputeType, MaxBranchNum> gains{}, gainDeltas{};
+
+        template<bool isRamping>
+        void processChannels(const juce::AudioBuffer<SampleType> &buffer) noexcept {
+            const auto *const *inputs = buffer.getArrayOfReadPointers();
+            auto *const *outputs = sumBuffer.getArrayOfWritePointers();
+            const auto numChannels = static_cast<size_t>(buffer.getNumChannels());
+            const auto numSamples = static_cast<size_t>(buffer.getNumSamples());
+            jassert(numChannels <= IIRBase<SampleType>::MaxChannelNum);
+            jassert(numChannels <= static_cast<size_t>(sumBuffer.getNumChannels()));
+            jassert(numSamples <= static_cast<size_t>(sumBuffer.getNumSamples()));
+            // the states only hold MaxChannelNum channels, the channels above are left unprocessed
+            switch (std::min(numChannels, IIRBase<SampleType>::MaxChannelNum)) {
+                case 1: {
+                    processInterleaved<isRamping, 1>(inputs, outputs, 0, numSamples);
+                    break;
+                }
+                case 2: {
+                    processInterleaved<isRamping, 2>(inputs, outputs, 0, numSamples);
+                    break;
+                }
+                default: {
+                    break;
+                }
+            }
+            isSumEmpty = false;
+        }
+
+        template<bool isRamping, size_t NumChannels>
+        void processInterleaved(const SampleType *const *inputs, SampleType *const *outputs,
+                                const size_t startChannel, const size_t numSamples) noexcept {
+            const auto step = ComputeType(1) / static_cast<ComputeType>(numSamples);
+            for (size_t s = 0; s < sectionNum; ++s) {
+                coeffs[s] = sections[s]->getCoeff();
+                if constexpr (isRamping) {
+                    const auto &target = sections[s]->getToRamp() ? sections[s]->getRampCoeff() : coeffs[s];
+                    for (size_t j = 0; j < 5; ++j) {
+                        deltas[s][j] = (target[j] - coeffs[s][j]) * step;
+                    }
+                }
+                const auto &s1 = sections[s]->getS1(), &s2 = sections[s]->getS2();
+                for (size_t channel = 0; channel < NumChannels; ++channel) {
+                    z1s[s][channel] = s1[startChannel + channel];
+                    z2s[s][channel] = s2[startChannel + channel];
+                }
+            }
+            for (size_t b = 0; b < branchNum; ++b) {
+                gains[b] = startGains[b];
+                gainDeltas[b] = (endGains[b] - startGains[b]) * step;
+            }
+            const auto toAdd = !isSumEmpty;
+            for (size_t i = 0; i < numSamples; ++i) {
+                alignas(32) std::array<ComputeType, NumChannels> x, sum;
+                for (size_t channel = 0; channel < NumChannels; ++channel) {
+                    x[channel] = inputs[startChannel + channel][i];
+                    sum[channel] = toAdd ? outputs[startChannel + channel][i] : ComputeType(0);
+                }
+                size_t s = 0;
+                for (size_t b = 0; b < branchNum; ++b) {
+                    alignas(32) std::array<ComputeType, NumChannels> v = x;
+                    for (; s < branchEnds[b]; ++s) {
+                        const auto &c = coeffs[s];
+                        auto &z1 = z1s[s], &z2 = z2s[s];
+                        alignas(32) std::array<ComputeType, NumChannels> y;
+                        for (size_t channel = 0; channel < NumChannels; ++channel) {
+                            y[channel] = v[channel] * c[0] + z1[channel];
+                            z1[channel] = v[channel] * c[1] - y[channel] * c[3] + z2[channel];
+                            z2[channel] = v[channel] * c[2] - y[channel] * c[4];
+                        }
+                        if (!passThroughs[b]) {
+                            v = y;
+                        }
+                    }
+                    if (!bypasses[b]) {
+                        for (size_t channel = 0; channel < NumChannels; ++channel) {
+                            sum[channel] += v[channel] * gains[b];
+                        }
+                    }
+                    gains[b] += gainDeltas[b];
+                }
+                for (size_t channel = 0; channel < NumChannels; ++channel) {
+                    outputs[startChannel + channel][i] = static_cast<SampleType>(sum[channel]);
+                }
+                if constexpr (isRamping) {
+                    for (s = 0; s < sectionNum; ++s) {
+                        for (size_t j = 0; j < 5; ++j) {
+                            coeffs[s][j] += deltas[s][j];
+                        }
+                    }
+                }
+            }
+            for (size_t s = 0; s < sectionNum; ++s) {
+                auto &s1 = sections[s]->getS1(), &s2 = sections[s]->getS2();
+                for (size_t channel = 0; channel < NumChannels; ++channel) {
+                    s1[startChannel + channel] = z1s[s][channel];
+                    s2[startChannel + channel] = z2s[s][channel];
+                }
+            }
+        }
+    };
+}
+
+#endif //IIR_PARALLEL_BANK_HPP
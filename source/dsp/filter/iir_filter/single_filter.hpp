@@ -14,6 +14,8 @@
 #include "../filter_design/filter_design.hpp"
 #include "coeff/martin_coeff.hpp"
 #include "iir_base.hpp"
+#include "iir_cascade.hpp"
+#include "iir_parallel_bank.hpp"
 #include "svf_base.hpp"
 
 namespace zlFilter {
@@ -42,6 +44,18 @@ namespace zlFilter {
 
         void setToRest() { toReset.store(true); }
 
+        /**
+         * clear the states of all biquads at once, call it on the audio thread
+         */
+        void clearStates() {
+            for (auto &f: filters) {
+                f.reset();
+            }
+            for (auto &f: svfFilters) {
+                f.reset();
+            }
+        }
+
         void prepare(const juce::dsp::ProcessSpec &spec) {
             processSpec = spec;
             numChannels.store(spec.numChannels);
@@ -60,8 +74,10 @@ namespace zlFilter {
         /**
          * prepare for processing the incoming audio buffer
          * call it when you want to update filter parameters
+         * @tparam copyParallel whether to copy the buffer into the parallel buffer, not needed with IIRParallelBank
          * @param buffer
          */
+        template<bool copyParallel = true>
         void processPre(juce::AudioBuffer<FloatType> &buffer) {
             if (currentFilterStructure != filterStructure.load() || currentFilterType != filterType.load()) {
                 currentFilterStructure = filterStructure.load();
@@ -76,7 +92,7 @@ namespace zlFilter {
                 toReset.store(true);
                 toUpdatePara.store(true);
             }
-            if (shouldBeParallel) {
+            if (copyParallel && shouldBeParallel) {
                 parallelBuffer.makeCopyOf(buffer);
             }
             reset();
@@ -122,7 +138,13 @@ namespace zlFilter {
                         for (size_t i = 0; i < currentFilterNum; ++i) {
                             filters[i].process(context);
                         }
-                        buffer.applyGain(parallelMultiplier);
+                        if (toRampParallel) {
+                            toRampParallel = false;
+                            buffer.applyGainRamp(0, buffer.getNumSamples(),
+                                                 previousParallelMultiplier, parallelMultiplier);
+                        } else {
+                            buffer.applyGain(parallelMultiplier);
+                        }
                         break;
                     } else {
                         auto block = juce::dsp::AudioBlock<FloatType>(buffer);
@@ -138,6 +160,40 @@ namespace zlFilter {
             }
         }
 
+        /**
+         * append the biquads to a cascade instead of processing them, only for the iir structure
+         * call it after processPre, the cascade should have at least FilterSize free biquads
+         * @return whether the biquads have been appended
+         */
+        template<bool isBypassed = false, size_t MaxSectionNum>
+        bool pushToCascade(IIRCascade<FloatType, MaxSectionNum> &cascade) {
+            if (currentFilterStructure != FilterStructure::iir) return false;
+            jassert(cascade.getFreeNum() >= currentFilterNum);
+            const auto bypass = isBypassed || bypassNextBlock;
+            bypassNextBlock = false;
+            for (size_t i = 0; i < currentFilterNum; ++i) {
+                cascade.push(filters[i], bypass);
+            }
+            return true;
+        }
+
+        /**
+         * append the biquads and the parallel gain to a parallel bank as one branch, instead of processing them
+         * only for the parallel structure with shouldBeParallel, call it after processPre<false>
+         * @return whether the branch has been appended
+         */
+        template<bool isBypassed = false, size_t MaxBranchNum, size_t MaxSectionNum>
+        bool pushToParallelBank(IIRParallelBank<FloatType, MaxBranchNum, MaxSectionNum> &bank) {
+            if (currentFilterStructure != FilterStructure::parallel || !shouldBeParallel) return false;
+            jassert(bank.getFreeNum() >= currentFilterNum);
+            const auto startGain = toRampParallel ? previousParallelMultiplier : parallelMultiplier;
+            toRampParallel = false;
+            bank.push(filters.data(), currentFilterNum, startGain, parallelMultiplier,
+                      isBypassed, bypassNextBlock);
+            bypassNextBlock = false;
+            return true;
+        }
+
         /**
          * add the processed parallel buffer to the incoming audio buffer
          * @param buffer
@@ -208,14 +264,37 @@ namespace zlFilter {
             switch (currentFilterStructure) {
                 case FilterStructure::iir:
                 case FilterStructure::svf: {
-                    updateCoeffs();
+                    updateCoeffs<false, false>();
                     break;
                 }
                 case FilterStructure::parallel: {
                     if (shouldBeParallel) {
                         updateParallelGain(x);
                     } else {
-                        updateCoeffs();
+                        updateCoeffs<false, false>();
+                    }
+                }
+            }
+        }
+
+        /**
+         * set gain and move coeffs linearly to the new ones during the next processed block
+         * the filter is only designed once per block, instead of once per sample
+         * @param x gain
+         */
+        void setGainRamp(FloatType x) {
+            gain.store(static_cast<double>(x));
+            switch (currentFilterStructure) {
+                case FilterStructure::iir:
+                case FilterStructure::svf: {
+                    updateCoeffs<true, false>();
+                    break;
+                }
+                case FilterStructure::parallel: {
+                    if (shouldBeParallel) {
+                        updateParallelGain<true>(x);
+                    } else {
+                        updateCoeffs<true, false>();
                     }
                 }
             }
@@ -241,9 +320,53 @@ namespace zlFilter {
         void setGainAndQNow(FloatType g1, FloatType q1) {
             gain.store(static_cast<double>(g1));
             q.store(static_cast<double>(q1));
-            updateCoeffs();
+            updateCoeffs<false, false>();
+        }
+
+        /**
+         * set gain & Q and move coeffs linearly to the new ones during the next processed block
+         * the filter is only designed once per block, instead of once per sample
+         * @param g1 gain
+         * @param q1 Q value
+         */
+        void setGainAndQRamp(FloatType g1, FloatType q1) {
+            gain.store(static_cast<double>(g1));
+            q.store(static_cast<double>(q1));
+            updateCoeffs<true, false>();
+        }
+
+        /**
+         * set gain & Q with the coefficients designed outside, e.g. by BatchDesign
+         * @tparam ramp whether to move coeffs linearly to the new ones during the next processed block
+         * @param g1 gain
+         * @param q1 Q value
+         * @param coeff the biquad coefficients {a0, a1, a2, b0, b1, b2}
+         */
+        template<bool ramp = false>
+        void setGainAndQWithCoeff(FloatType g1, FloatType q1, const std::array<double, 6> &coeff) {
+            gain.store(static_cast<double>(g1));
+            q.store(static_cast<double>(q1));
+            const auto previousFilterNum = currentFilterNum;
+            currentFilterNum = 1;
+            coeffs[0] = coeff;
+            if (ramp && previousFilterNum == currentFilterNum) {
+                updateFromBiquads<true>();
+            } else {
+                updateFromBiquads<false>();
+            }
         }
 
+        /**
+         * whether the coefficients can be designed by BatchDesign, i.e. a second order peak in the iir/svf structure
+         * call it after processPre
+         */
+        bool getIsBatchable() const {
+            return currentFilterType == FilterType::peak && currentOrder == 2 &&
+                   currentFilterStructure != FilterStructure::parallel;
+        }
+
+        double getSampleRate() const { return processSpec.sampleRate; }
+
         /**
          * set the type of the filter, the filter will always reset
          * @param x filter type
@@ -275,45 +398,42 @@ namespace zlFilter {
         /**
          * update filter coefficients
          * DO NOT call it unless you are sure what you are doing
+         * @tparam ramp whether to move coeffs linearly to the new ones during the next processed block
+         * if the number of cascading filters changes, coeffs are always updated immediately
+         * @tparam useCache whether to design through the shared cache, the dynamic gain & Q bypass it
          */
+        template<bool ramp = false, bool useCache = true>
         void updateCoeffs() {
+            const auto previousFilterNum = currentFilterNum;
+            currentOrder = order.load();
             if (!shouldBeParallel) {
-                currentFilterNum = updateIIRCoeffs(currentFilterType, order.load(),
+                currentFilterNum = updateIIRCoeffs<useCache>(currentFilterType, currentOrder,
                                                    freq.load(), processSpec.sampleRate,
                                                    gain.load(), q.load(), coeffs);
             } else {
                 if (currentFilterType == FilterType::peak) {
-                    currentFilterNum = updateIIRCoeffs(FilterType::bandPass,
-                                                       std::min(static_cast<size_t>(4), order.load()),
+                    currentFilterNum = updateIIRCoeffs<useCache>(FilterType::bandPass,
+                                                       std::min(static_cast<size_t>(4), currentOrder),
                                                        freq.load(), processSpec.sampleRate,
                                                        gain.load(), q.load(), coeffs);
                 } else if (currentFilterType == FilterType::lowShelf) {
-                    currentFilterNum = updateIIRCoeffs(FilterType::lowPass,
-                                                       std::min(static_cast<size_t>(2), order.load()),
+                    currentFilterNum = updateIIRCoeffs<useCache>(FilterType::lowPass,
+                                                       std::min(static_cast<size_t>(2), currentOrder),
                                                        freq.load(), processSpec.sampleRate,
                                                        gain.load(), q.load(), coeffs);
                 } else if (currentFilterType == FilterType::highShelf) {
-                    currentFilterNum = updateIIRCoeffs(FilterType::highPass,
-                                                       std::min(static_cast<size_t>(2), order.load()),
+                    currentFilterNum = updateIIRCoeffs<useCache>(FilterType::highPass,
+                                                       std::min(static_cast<size_t>(2), currentOrder),
                                                        freq.load(), processSpec.sampleRate,
                                                        gain.load(), q.load(), coeffs);
                 }
 
-                updateParallelGain(gain.load());
+                updateParallelGain<ramp>(gain.load());
             }
-            switch (currentFilterStructure) {
-                case FilterStructure::iir:
-                case FilterStructure::parallel: {
-                    for (size_t i = 0; i < currentFilterNum; i++) {
-                        filters[i].updateFromBiquad(coeffs[i]);
-                    }
-                    break;
-                }
-                case FilterStructure::svf: {
-                    for (size_t i = 0; i < currentFilterNum; i++) {
-                        svfFilters[i].updateFromBiquad(coeffs[i]);
-                    }
-                }
+            if (ramp && previousFilterNum == currentFilterNum) {
+                updateFromBiquads<true>();
+            } else {
+                updateFromBiquads<false>();
             }
         }
 
@@ -333,6 +453,17 @@ namespace zlFilter {
             filterStructure.store(x);
         }
 
+        /**
+         * whether new parameters are waiting for the next processPre
+         */
+        bool getIsUpdatePending() const { return toUpdatePara.load() || toReset.load(); }
+
+        /**
+         * get the number of samples the filter takes to decay after the input becomes silent
+         * @return
+         */
+        size_t getTailSamples() const { return tailSamples.load(); }
+
         bool getShouldBeParallel() const { return shouldBeParallel; }
 
         bool getShouldNotBeParallel() const { return shouldNotBeParallel; }
@@ -340,49 +471,71 @@ namespace zlFilter {
         juce::AudioBuffer<FloatType> &getParallelBuffer() { return parallelBuffer; }
 
     private:
+        // hot: read on every block by the audio thread
+        size_t currentFilterNum{1};
+        // the order of the current coefficients
+        size_t currentOrder{2};
+        FilterType currentFilterType{FilterType::peak};
+        FilterStructure currentFilterStructure{FilterStructure::iir};
+        bool shouldBeParallel{false}, shouldNotBeParallel{false};
+        bool bypassNextBlock{false}, toRampParallel{false};
+        FloatType parallelMultiplier{0}, previousParallelMultiplier{0};
+        std::atomic<bool> toUpdatePara = false, toReset = false;
+        std::atomic<FilterStructure> filterStructure{FilterStructure::iir};
+        std::atomic<FilterType> filterType{FilterType::peak};
+        // the sections, only the first currentFilterNum ones are touched
         std::array<IIRBase<FloatType>, FilterSize> filters{};
-        juce::AudioBuffer<FloatType> parallelBuffer;
+        std::array<SVFBase<FloatType>, FilterSize> svfFilters{};
 
-        size_t currentFilterNum{1};
+        // cold: parameters & design scratch, only touched when the filter gets updated
         std::atomic<double> freq = 1000, gain = 0, q = 0.707;
         std::atomic<size_t> order{2};
-        std::atomic<FilterType> filterType{FilterType::peak};
-        FilterType currentFilterType{FilterType::peak};
-        bool bypassNextBlock{false};
-
+        std::atomic<bool> useSVF{false};
+        bool currentUseSVF{false};
         juce::dsp::ProcessSpec processSpec{48000, 512, 2};
         std::atomic<float> sampleRate{48000};
         std::atomic<juce::uint32> numChannels;
-
-        std::atomic<bool> toUpdatePara = false, toReset = false;
-
         std::array<std::array<double, 6>, FilterSize> coeffs{};
+        std::atomic<size_t> tailSamples{0};
+        juce::AudioBuffer<FloatType> parallelBuffer;
 
-        std::atomic<bool> useSVF{false};
-        bool currentUseSVF{false};
-        std::array<SVFBase<FloatType>, FilterSize> svfFilters{};
-
-        std::atomic<FilterStructure> filterStructure{FilterStructure::iir};
-        FilterStructure currentFilterStructure{FilterStructure::iir};
-        bool shouldBeParallel{false}, shouldNotBeParallel{false};
-        FloatType parallelMultiplier;
-
+        template<bool useCache = true>
         static size_t updateIIRCoeffs(const FilterType filterType, const size_t n,
                                       const double f, const double fs, const double g0, const double q0,
                                       std::array<std::array<double, 6>, FilterSize> &coeffs) {
-            return FilterDesign::updateCoeffs<FilterSize,
-                MartinCoeff::get1LowShelf, MartinCoeff::get1HighShelf, MartinCoeff::get1TiltShelf,
-                MartinCoeff::get1LowPass, MartinCoeff::get1HighPass,
-                MartinCoeff::get2Peak,
-                MartinCoeff::get2LowShelf, MartinCoeff::get2HighShelf, MartinCoeff::get2TiltShelf,
-                MartinCoeff::get2LowPass, MartinCoeff::get2HighPass,
-                MartinCoeff::get2BandPass, MartinCoeff::get2Notch>(
-                filterType, n, f, fs, g0, q0, coeffs);
+            return MartinCoeff::updateCoeffs<FilterSize, useCache>(filterType, n, f, fs, g0, q0, coeffs);
         }
 
+        template<bool ramp = false>
         void updateParallelGain(double x) {
+            previousParallelMultiplier = parallelMultiplier;
+            toRampParallel = ramp;
             parallelMultiplier = juce::Decibels::decibelsToGain<FloatType>(static_cast<FloatType>(x)) - FloatType(1);
         }
+
+        template<bool ramp = false>
+        void updateFromBiquads() {
+            // the sections are in series, so their tails add up
+            double tail = 0.0;
+            for (size_t i = 0; i < currentFilterNum; i++) {
+                tail += IIRBase<FloatType>::getTailSamples(coeffs[i]);
+            }
+            tailSamples.store(static_cast<size_t>(tail));
+            switch (currentFilterStructure) {
+                case FilterStructure::iir:
+                case FilterStructure::parallel: {
+                    for (size_t i = 0; i < currentFilterNum; i++) {
+                        filters[i].template updateFromBiquad<ramp>(coeffs[i]);
+                    }
+                    break;
+                }
+                case FilterStructure::svf: {
+                    for (size_t i = 0; i < currentFilterNum; i++) {
+                        svfFilters[i].template updateFromBiquad<ramp>(coeffs[i]);
+                    }
+                }
+            }
+        }
     };
 }
 
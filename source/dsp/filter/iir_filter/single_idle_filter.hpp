@@ -79,6 +79,8 @@ namespace zlFilter {
             return false;
         }
 
+        bool getResponseOutdated() const { return toUpdatePara.load(); }
+
         std::vector<std::complex<FloatType> > &getResponse() { return response; }
 
         void setToUpdate() {toUpdatePara.store(true);}
@@ -102,14 +104,7 @@ namespace zlFilter {
         static size_t updateIIRCoeffs(const FilterType filterType, const size_t n,
                                       const double f, const double fs, const double g0, const double q0,
                                       std::array<std::array<double, 6>, FilterSize> &coeffs) {
-            return FilterDesign::updateCoeffs<FilterSize,
-                MartinCoeff::get1LowShelf, MartinCoeff::get1HighShelf, MartinCoeff::get1TiltShelf,
-                MartinCoeff::get1LowPass, MartinCoeff::get1HighPass,
-                MartinCoeff::get2Peak,
-                MartinCoeff::get2LowShelf, MartinCoeff::get2HighShelf, MartinCoeff::get2TiltShelf,
-                MartinCoeff::get2LowPass, MartinCoeff::get2HighPass,
-                MartinCoeff::get2BandPass, MartinCoeff::get2Notch>(
-                filterType, n, f, fs, g0, q0, coeffs);
+            return MartinCoeff::updateCoeffs<FilterSize>(filterType, n, f, fs, g0, q0, coeffs);
         }
     };
 }
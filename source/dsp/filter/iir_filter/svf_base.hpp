@@ -11,20 +11,27 @@
 #define SVF_BASE_HPP
 
 namespace zlFilter {
+    /**
+     * a state variable filter in the topology-preserving structure
+     * the parameters and the states are kept inline in one cache-aligned block, as in IIRBase
+     * @tparam SampleType
+     */
     template<typename SampleType>
-    class SVFBase {
+    class alignas(64) SVFBase {
     public:
+        static constexpr size_t MaxChannelNum = 2;
+
         SVFBase() = default;
 
         void prepare(const juce::dsp::ProcessSpec &spec) {
-            s1.resize(spec.numChannels);
-            s2.resize(spec.numChannels);
+            jassert(spec.numChannels <= MaxChannelNum);
+            juce::ignoreUnused(spec);
             reset();
         }
 
         void reset() {
-            std::fill(s1.begin(), s1.end(), static_cast<SampleType>(0));
-            std::fill(s2.begin(), s2.end(), static_cast<SampleType>(0));
+            s1.fill(static_cast<SampleType>(0));
+            s2.fill(static_cast<SampleType>(0));
         }
 
         void snapToZero() {
@@ -47,20 +54,16 @@ namespace zlFilter {
             jassert(inputBlock.getNumSamples() == numSamples);
 
             if (context.isBypassed) {
-                for (size_t channel = 0; channel < numChannels; ++channel) {
-                    auto *inputSamples = inputBlock.getChannelPointer(channel);
-                    auto *outputSamples = outputBlock.getChannelPointer(channel);
-                    for (size_t i = 0; i < numSamples; ++i) {
-                        outputSamples[i] = processSampleBypass(channel, inputSamples[i]);
-                    }
+                if (toRamp) {
+                    processChannels<true, true>(inputBlock, outputBlock, numChannels, numSamples);
+                } else {
+                    processChannels<true, false>(inputBlock, outputBlock, numChannels, numSamples);
                 }
             } else {
-                for (size_t channel = 0; channel < numChannels; ++channel) {
-                    auto *inputSamples = inputBlock.getChannelPointer(channel);
-                    auto *outputSamples = outputBlock.getChannelPointer(channel);
-                    for (size_t i = 0; i < numSamples; ++i) {
-                        outputSamples[i] = processSample(channel, inputSamples[i]);
-                    }
+                if (toRamp) {
+                    processChannels<false, true>(inputBlock, outputBlock, numChannels, numSamples);
+                } else {
+                    processChannels<false, false>(inputBlock, outputBlock, numChannels, numSamples);
                 }
             }
 
@@ -93,21 +96,141 @@ namespace zlFilter {
             return yHP - R2 * yBP + yLP;
         }
 
+        /**
+         * process all channels of one sample together, the state is kept in local lanes during the whole block
+         * so that the compiler can put L/R of this filter into one SIMD register
+         * @tparam isBypassed whether to output the all-pass sum instead of the filtered signal
+         * @tparam isRamping whether parameters move linearly towards the ramp target during the block
+         * @tparam NumChannels the number of channels
+         */
+        template<bool isBypassed, bool isRamping, size_t NumChannels, typename InputBlock, typename OutputBlock>
+        void processInterleaved(const InputBlock &inputBlock, OutputBlock &outputBlock,
+                                const size_t startChannel, const size_t numSamples) noexcept {
+            std::array<const SampleType *, NumChannels> inputs;
+            std::array<SampleType *, NumChannels> outputs;
+            alignas(32) std::array<SampleType, NumChannels> z1, z2;
+            for (size_t channel = 0; channel < NumChannels; ++channel) {
+                inputs[channel] = inputBlock.getChannelPointer(startChannel + channel);
+                outputs[channel] = outputBlock.getChannelPointer(startChannel + channel);
+                z1[channel] = s1[startChannel + channel];
+                z2[channel] = s2[startChannel + channel];
+            }
+            auto cg = g, cR2 = R2, ch = h;
+            auto c0 = isBypassed ? static_cast<SampleType>(1) : chp;
+            auto c1 = isBypassed ? -R2 : cbp;
+            auto c2 = isBypassed ? static_cast<SampleType>(1) : clp;
+            SampleType dg{0}, dR2{0}, dc0{0}, dc1{0}, dc2{0};
+            if constexpr (isRamping) {
+                const auto step = static_cast<SampleType>(1) / static_cast<SampleType>(numSamples);
+                dg = (rampG - g) * step;
+                dR2 = (rampR2 - R2) * step;
+                if constexpr (isBypassed) {
+                    dc1 = -dR2;
+                } else {
+                    dc0 = (rampChp - chp) * step;
+                    dc1 = (rampCbp - cbp) * step;
+                    dc2 = (rampClp - clp) * step;
+                }
+            }
+            for (size_t i = 0; i < numSamples; ++i) {
+                const auto gR2 = cg + cR2;
+                alignas(32) std::array<SampleType, NumChannels> x, y;
+                for (size_t channel = 0; channel < NumChannels; ++channel) {
+                    x[channel] = inputs[channel][i];
+                }
+                for (size_t channel = 0; channel < NumChannels; ++channel) {
+                    const auto yHP = ch * (x[channel] - z1[channel] * gR2 - z2[channel]);
+
+                    const auto yBP = yHP * cg + z1[channel];
+                    z1[channel] = yHP * cg + yBP;
+
+                    const auto yLP = yBP * cg + z2[channel];
+                    z2[channel] = yBP * cg + yLP;
+
+                    y[channel] = c0 * yHP + c1 * yBP + c2 * yLP;
+                }
+                for (size_t channel = 0; channel < NumChannels; ++channel) {
+                    outputs[channel][i] = y[channel];
+                }
+                if constexpr (isRamping) {
+                    cg += dg;
+                    cR2 += dR2;
+                    ch = static_cast<SampleType>(1) / (cg * (cR2 + cg) + static_cast<SampleType>(1));
+                    c0 += dc0;
+                    c1 += dc1;
+                    c2 += dc2;
+                }
+            }
+            for (size_t channel = 0; channel < NumChannels; ++channel) {
+                s1[startChannel + channel] = z1[channel];
+                s2[startChannel + channel] = z2[channel];
+            }
+        }
+
+        /**
+         * update the parameters from biquad coefficients {a0, a1, a2, b0, b1, b2}
+         * @tparam ramp if true, the parameters move linearly to the new values during the next processed block
+         * (the topology-preserving structure stays stable as long as g & R2 stay positive)
+         * @param coeffs
+         */
+        template<bool ramp = false>
         void updateFromBiquad(const std::array<double, 6>& coeffs) {
             const auto temp1 = std::sqrt(std::abs((-coeffs[0] - coeffs[1] - coeffs[2])));
             const auto temp2 = std::sqrt(std::abs((-coeffs[0] + coeffs[1] - coeffs[2])));
-            g = static_cast<SampleType>(temp1 / temp2);
-            R2 = static_cast<SampleType>(2 * (coeffs[0] - coeffs[2]) / (temp1 * temp2));
-            h = static_cast<SampleType>(1) / (g * (R2 + g) + static_cast<SampleType>(1));
+            auto &tg = ramp ? rampG : g;
+            auto &tR2 = ramp ? rampR2 : R2;
+            auto &tChp = ramp ? rampChp : chp;
+            auto &tCbp = ramp ? rampCbp : cbp;
+            auto &tClp = ramp ? rampClp : clp;
+            tg = static_cast<SampleType>(temp1 / temp2);
+            tR2 = static_cast<SampleType>(2 * (coeffs[0] - coeffs[2]) / (temp1 * temp2));
+            if (!ramp) {
+                h = static_cast<SampleType>(1) / (g * (R2 + g) + static_cast<SampleType>(1));
+            }
 
-            chp = static_cast<SampleType>((coeffs[3] - coeffs[4] + coeffs[5]) / (coeffs[0] - coeffs[1] + coeffs[2]));
-            cbp = static_cast<SampleType>(2 * (coeffs[5] - coeffs[3]) / (temp1 * temp2));
-            clp = static_cast<SampleType>((coeffs[3] + coeffs[4] + coeffs[5]) / (coeffs[0] + coeffs[1] + coeffs[2]));
+            tChp = static_cast<SampleType>((coeffs[3] - coeffs[4] + coeffs[5]) / (coeffs[0] - coeffs[1] + coeffs[2]));
+            tCbp = static_cast<SampleType>(2 * (coeffs[5] - coeffs[3]) / (temp1 * temp2));
+            tClp = static_cast<SampleType>((coeffs[3] + coeffs[4] + coeffs[5]) / (coeffs[0] + coeffs[1] + coeffs[2]));
+            toRamp = ramp;
         }
 
     private:
-        SampleType g, R2, h, chp, cbp, clp;
-        std::vector<SampleType> s1, s2;
+        // hot: read & written on every block
+        SampleType g{0}, R2{0}, h{0}, chp{0}, cbp{0}, clp{0};
+        std::array<SampleType, MaxChannelNum> s1{}, s2{};
+        bool toRamp{false};
+        // warm: only read when the parameters ramp
+        SampleType rampG{0}, rampR2{0}, rampChp{0}, rampCbp{0}, rampClp{0};
+
+        template<bool isBypassed, bool isRamping, typename InputBlock, typename OutputBlock>
+        void processChannels(const InputBlock &inputBlock, OutputBlock &outputBlock,
+                             const size_t numChannels, const size_t numSamples) noexcept {
+            static_assert(MaxChannelNum == 2, "add a lane for every channel number up to MaxChannelNum");
+            jassert(numChannels <= MaxChannelNum);
+            // the states only hold MaxChannelNum channels, the channels above are left unprocessed
+            switch (std::min(numChannels, MaxChannelNum)) {
+                case 1: {
+                    processInterleaved<isBypassed, isRamping, 1>(inputBlock, outputBlock, 0, numSamples);
+                    break;
+                }
+                case 2: {
+                    processInterleaved<isBypassed, isRamping, 2>(inputBlock, outputBlock, 0, numSamples);
+                    break;
+                }
+                default: {
+                    break;
+                }
+            }
+            if constexpr (isRamping) {
+                g = rampG;
+                R2 = rampR2;
+                h = static_cast<SampleType>(1) / (g * (R2 + g) + static_cast<SampleType>(1));
+                chp = rampChp;
+                cbp = rampCbp;
+                clp = rampClp;
+                toRamp = false;
+            }
+        }
     };
 }
 
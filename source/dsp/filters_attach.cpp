@@ -16,7 +16,8 @@ namespace zlDSP {
                                             juce::AudioProcessorValueTreeState &parametersNA,
                                             Controller<FloatType> &controller)
         : processorRef(processor), parameterRef(parameters), parameterNARef(parametersNA),
-          controllerRef(controller), filtersRef(controller.getFilters()) {
+          controllerRef(controller), scalePara(parameters.getRawParameterValue(scale::ID)),
+          filtersRef(controller.getFilters()) {
         addListeners();
         initDefaultValues();
         for (size_t i = 0; i < bandNUM; ++i) {
@@ -176,7 +177,7 @@ namespace zlDSP {
             }
             controllerRef.updateSgc(idx);
         } else if (parameterID.startsWith(gain::ID)) {
-            value *= static_cast<FloatType>(scale::formatV(parameterRef.getRawParameterValue(scale::ID)->load()));
+            value *= static_cast<FloatType>(scale::formatV(scalePara->load()));
             value = gain::range.snapToLegalValue(static_cast<float>(value));
             controllerRef.getBaseFilter(idx).setGain(value);
             filtersRef[idx].getMainFilter().setGain(value);
@@ -217,7 +218,7 @@ namespace zlDSP {
         } else if (parameterID.startsWith(dynamicRelative::ID)) {
             controllerRef.setRelative(idx, newValue > .5f);
         } else if (parameterID.startsWith(targetGain::ID)) {
-            value *= static_cast<FloatType>(scale::formatV(parameterRef.getRawParameterValue(scale::ID)->load()));
+            value *= static_cast<FloatType>(scale::formatV(scalePara->load()));
             value = targetGain::range.snapToLegalValue(static_cast<float>(value));
             controllerRef.getTargetFilter(idx).setGain(value);
         } else if (parameterID.startsWith(targetQ::ID)) {
@@ -41,6 +41,8 @@ namespace zlDSP {
         juce::AudioProcessor &processorRef;
         juce::AudioProcessorValueTreeState &parameterRef, &parameterNARef;
         Controller<FloatType> &controllerRef;
+        // cached so that automated gains do not look up the parameter on the audio thread
+        std::atomic<float> *scalePara;
         std::array<zlFilter::DynamicIIR<FloatType, Controller<FloatType>::FilterSize>, bandNUM> &filtersRef;
         std::array<std::string, bandNUM * 2> sideParaNames;
         std::array<std::unique_ptr<zlChore::ParaUpdater>, bandNUM> sideFreqUpdater, sideQUpdater;
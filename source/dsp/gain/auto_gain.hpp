@@ -88,6 +88,8 @@ namespace zlGain {
             }
         }
 
+        bool getIsON() const { return isON.load(); }
+
         FloatType getGainDecibels() const {
             return juce::Decibels::gainToDecibels(gain.load());
         }
@@ -39,17 +39,17 @@ namespace zlPanel {
             auto item = &iterator.getItem();
             if (item->itemID == 1) {
                 item->setAction([this] {
-                    analyzer.setMatchMode(zlEqMatch::EqMatchAnalyzer<double>::matchSide);
+                    analyzer.setMatchMode(zlEqMatch::EqMatchAnalyzer<zlDSP::EngineFloatType>::matchSide);
                 });
             } else if (item->itemID == 2) {
                 item->setAction([this] {
                     loadFromPreset();
-                    analyzer.setMatchMode(zlEqMatch::EqMatchAnalyzer<double>::matchPreset);
+                    analyzer.setMatchMode(zlEqMatch::EqMatchAnalyzer<zlDSP::EngineFloatType>::matchPreset);
                 });
             } else if (item->itemID == 3) {
                 item->setAction([this] {
                     analyzer.setTargetSlope(0.f);
-                    analyzer.setMatchMode(zlEqMatch::EqMatchAnalyzer<double>::matchSlope);
+                    analyzer.setMatchMode(zlEqMatch::EqMatchAnalyzer<zlDSP::EngineFloatType>::matchSlope);
                 });
             }
         }
@@ -177,7 +177,7 @@ namespace zlPanel {
         matchRunner.setNumBand(static_cast<size_t>(8));
 
         sideChooseBox.getBox().setSelectedId(1, juce::dontSendNotification);
-        analyzer.setMatchMode(zlEqMatch::EqMatchAnalyzer<double>::MatchMode::matchSide);
+        analyzer.setMatchMode(zlEqMatch::EqMatchAnalyzer<zlDSP::EngineFloatType>::MatchMode::matchSide);
 
         fitAlgoBox.getBox().setSelectedId(2, juce::dontSendNotification);
         matchRunner.setMode(static_cast<size_t>(1));
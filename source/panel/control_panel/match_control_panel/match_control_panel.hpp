@@ -32,7 +32,7 @@ namespace zlPanel {
     private:
         static constexpr float weightP = 0.05216f * 7.f;
         zlInterface::UIBase &uiBase;
-        zlEqMatch::EqMatchAnalyzer<double> &analyzer;
+        zlEqMatch::EqMatchAnalyzer<zlDSP::EngineFloatType> &analyzer;
 
         const std::unique_ptr<juce::Drawable> startDrawable, pauseDrawable, saveDrawable;
 
@@ -69,7 +69,7 @@ namespace zlPanel {
         PluginProcessor &processorRef;
         juce::AudioProcessorValueTreeState &parametersRef, &parametersNARef;
         zlInterface::UIBase &uiBase;
-        zlDSP::Controller<double> &controllerRef;
+        zlDSP::Controller<zlDSP::EngineFloatType> &controllerRef;
 
         std::array<zlInterface::SnappingSlider, 3> wheelSlider;
         std::array<std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>, 3> wheelAttachment;
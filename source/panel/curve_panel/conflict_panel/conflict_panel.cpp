@@ -10,7 +10,7 @@
 #include "conflict_panel.hpp"
 
 namespace zlPanel {
-    ConflictPanel::ConflictPanel(zlFFT::ConflictAnalyzer<double> &conflictAnalyzer, zlInterface::UIBase &base)
+    ConflictPanel::ConflictPanel(zlFFT::ConflictAnalyzer<zlDSP::EngineFloatType> &conflictAnalyzer, zlInterface::UIBase &base)
         : analyzer(conflictAnalyzer), uiBase(base) {
         analyzer.start();
         setInterceptsMouseClicks(false, false);
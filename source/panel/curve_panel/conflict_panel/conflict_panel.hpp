@@ -18,7 +18,7 @@
 namespace zlPanel {
     class ConflictPanel final : public juce::Component {
     public:
-        explicit ConflictPanel(zlFFT::ConflictAnalyzer<double> &conflictAnalyzer,
+        explicit ConflictPanel(zlFFT::ConflictAnalyzer<zlDSP::EngineFloatType> &conflictAnalyzer,
                                zlInterface::UIBase &base);
 
         ~ConflictPanel() override;
@@ -37,7 +37,7 @@ namespace zlPanel {
         }
 
     private:
-        zlFFT::ConflictAnalyzer<double> &analyzer;
+        zlFFT::ConflictAnalyzer<zlDSP::EngineFloatType> &analyzer;
         zlInterface::UIBase &uiBase;
         juce::Path path;
         juce::ColourGradient gradient;
@@ -42,7 +42,7 @@ namespace zlPanel {
         PluginProcessor &processorRef;
         juce::AudioProcessorValueTreeState &parametersRef, &parametersNARef;
         zlInterface::UIBase &uiBase;
-        zlDSP::Controller<double> &controllerRef;
+        zlDSP::Controller<zlDSP::EngineFloatType> &controllerRef;
         std::array<zlFilter::Ideal<double, 16>, 16> baseFilters, targetFilters, mainFilters;
         BackgroundPanel backgroundPanel;
         FFTPanel fftPanel;
@@ -17,7 +17,7 @@
 namespace zlPanel {
     class FFTPanel final : public juce::Component {
     public:
-        explicit FFTPanel(zlFFT::PrePostFFTAnalyzer<double> &analyzer,
+        explicit FFTPanel(zlFFT::PrePostFFTAnalyzer<zlDSP::EngineFloatType> &analyzer,
                           zlInterface::UIBase &base);
 
         ~FFTPanel() override;
@@ -31,7 +31,7 @@ namespace zlPanel {
         void visibilityChanged() override;
 
     private:
-        zlFFT::PrePostFFTAnalyzer<double> &analyzerRef;
+        zlFFT::PrePostFFTAnalyzer<zlDSP::EngineFloatType> &analyzerRef;
         zlInterface::UIBase &uiBase;
         juce::Path path1{}, path2{}, path3{};
         juce::Path recentPath1{}, recentPath2{}, recentPath3{};
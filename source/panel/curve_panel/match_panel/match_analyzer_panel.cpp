@@ -10,7 +10,7 @@
 #include "match_analyzer_panel.hpp"
 
 namespace zlPanel {
-    MatchAnalyzerPanel::MatchAnalyzerPanel(zlEqMatch::EqMatchAnalyzer<double> &analyzer,
+    MatchAnalyzerPanel::MatchAnalyzerPanel(zlEqMatch::EqMatchAnalyzer<zlDSP::EngineFloatType> &analyzer,
                                            juce::AudioProcessorValueTreeState &parametersNA,
                                            zlInterface::UIBase &base)
         : analyzerRef(analyzer), parametersNARef(parametersNA), uiBase(base),
@@ -20,7 +20,7 @@ namespace zlPanel {
                                      private juce::ValueTree::Listener,
                                      private zlInterface::Dragger::Listener {
     public:
-        explicit MatchAnalyzerPanel(zlEqMatch::EqMatchAnalyzer<double> &analyzer,
+        explicit MatchAnalyzerPanel(zlEqMatch::EqMatchAnalyzer<zlDSP::EngineFloatType> &analyzer,
                                     juce::AudioProcessorValueTreeState &parametersNA,
                                     zlInterface::UIBase &base);
 
@@ -43,7 +43,7 @@ namespace zlPanel {
         void mouseDoubleClick(const juce::MouseEvent &event) override;
 
     private:
-        zlEqMatch::EqMatchAnalyzer<double> &analyzerRef;
+        zlEqMatch::EqMatchAnalyzer<zlDSP::EngineFloatType> &analyzerRef;
         juce::AudioProcessorValueTreeState &parametersNARef;
         zlInterface::UIBase &uiBase;
         juce::Path path1{}, path2{}, path3{};
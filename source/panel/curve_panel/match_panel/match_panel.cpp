@@ -10,7 +10,7 @@
 #include "match_panel.hpp"
 
 namespace zlPanel {
-    MatchPanel::MatchPanel(zlEqMatch::EqMatchAnalyzer<double> &analyzer,
+    MatchPanel::MatchPanel(zlEqMatch::EqMatchAnalyzer<zlDSP::EngineFloatType> &analyzer,
                            juce::AudioProcessorValueTreeState &parametersNA, zlInterface::UIBase &base)
         : uiBase(base), matchAnalyzerPanel(analyzer, parametersNA, base) {
         juce::ignoreUnused(analyzer, uiBase);
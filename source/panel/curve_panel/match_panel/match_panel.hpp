@@ -15,7 +15,7 @@
 namespace zlPanel {
     class MatchPanel final : public juce::Component {
     public:
-        explicit MatchPanel(zlEqMatch::EqMatchAnalyzer<double> &analyzer,
+        explicit MatchPanel(zlEqMatch::EqMatchAnalyzer<zlDSP::EngineFloatType> &analyzer,
                             juce::AudioProcessorValueTreeState &parametersNA,
                             zlInterface::UIBase &base);
 
@@ -14,7 +14,7 @@ namespace zlPanel {
                          juce::AudioProcessorValueTreeState &parameters,
                          juce::AudioProcessorValueTreeState &parametersNA,
                          zlInterface::UIBase &base,
-                         zlDSP::Controller<double> &controller,
+                         zlDSP::Controller<zlDSP::EngineFloatType> &controller,
                          zlInterface::Dragger &sideDragger)
         : idx(bandIdx),
           parametersRef(parameters), parametersNARef(parametersNA),
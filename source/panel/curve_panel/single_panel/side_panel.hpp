@@ -24,7 +24,7 @@ namespace zlPanel {
                            juce::AudioProcessorValueTreeState &parameters,
                            juce::AudioProcessorValueTreeState &parametersNA,
                            zlInterface::UIBase &base,
-                           zlDSP::Controller<double> &controller,
+                           zlDSP::Controller<zlDSP::EngineFloatType> &controller,
                            zlInterface::Dragger &sideDragger);
 
         ~SidePanel() override;
@@ -39,7 +39,7 @@ namespace zlPanel {
         size_t idx;
         juce::AudioProcessorValueTreeState &parametersRef, &parametersNARef;
         zlInterface::UIBase &uiBase;
-        zlFilter::IIR<double, zlDSP::Controller<double>::FilterSize> &sideF;
+        zlFilter::IIR<zlDSP::EngineFloatType, zlDSP::Controller<zlDSP::EngineFloatType>::SideFilterSize> &sideF;
         zlInterface::Dragger &sideDraggerRef;
         std::atomic<bool> dynON, selected, actived;
 
@@ -14,7 +14,7 @@ namespace zlPanel {
                              juce::AudioProcessorValueTreeState &parameters,
                              juce::AudioProcessorValueTreeState &parametersNA,
                              zlInterface::UIBase &base,
-                             zlDSP::Controller<double> &controller,
+                             zlDSP::Controller<zlDSP::EngineFloatType> &controller,
                              zlFilter::Ideal<double, 16> &baseFilter,
                              zlFilter::Ideal<double, 16> &targetFilter,
                              zlFilter::Ideal<double, 16> &mainFilter,
@@ -25,7 +25,7 @@ namespace zlPanel {
                              juce::AudioProcessorValueTreeState &parameters,
                              juce::AudioProcessorValueTreeState &parametersNA,
                              zlInterface::UIBase &base,
-                             zlDSP::Controller<double> &controller,
+                             zlDSP::Controller<zlDSP::EngineFloatType> &controller,
                              zlFilter::Ideal<double, 16> &baseFilter,
                              zlFilter::Ideal<double, 16> &targetFilter,
                              zlFilter::Ideal<double, 16> &mainFilter,
@@ -70,7 +70,7 @@ namespace zlPanel {
         size_t idx;
         juce::AudioProcessorValueTreeState &parametersRef, &parametersNARef;
         zlInterface::UIBase &uiBase;
-        zlDSP::Controller<double> &controllerRef;
+        zlDSP::Controller<zlDSP::EngineFloatType> &controllerRef;
         zlPanel::ResetAttach resetAttach;
         zlFilter::Ideal<double, 16> &baseF, &targetF, &mainF;
 
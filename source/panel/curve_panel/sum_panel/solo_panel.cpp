@@ -15,7 +15,7 @@ namespace zlPanel {
     SoloPanel::SoloPanel(juce::AudioProcessorValueTreeState &parameters,
                          juce::AudioProcessorValueTreeState &parametersNA,
                          zlInterface::UIBase &base,
-                         zlDSP::Controller<double> &controller,
+                         zlDSP::Controller<zlDSP::EngineFloatType> &controller,
                          ButtonPanel &buttonPanel)
         : parametersRef(parameters), parametersNARef(parametersNA),
           uiBase(base),
@@ -21,7 +21,7 @@ namespace zlPanel {
         SoloPanel(juce::AudioProcessorValueTreeState &parameters,
                   juce::AudioProcessorValueTreeState &parametersNA,
                   zlInterface::UIBase &base,
-                  zlDSP::Controller<double> &controller,
+                  zlDSP::Controller<zlDSP::EngineFloatType> &controller,
                   ButtonPanel &buttonPanel);
 
         ~SoloPanel() override;
@@ -31,8 +31,8 @@ namespace zlPanel {
     private:
         juce::AudioProcessorValueTreeState &parametersRef, &parametersNARef;
         zlInterface::UIBase &uiBase;
-        zlFilter::IIR<double, zlDSP::Controller<double>::FilterSize> &soloF;
-        zlDSP::Controller<double> &controllerRef;
+        zlFilter::IIR<zlDSP::EngineFloatType, zlDSP::Controller<zlDSP::EngineFloatType>::FilterSize> &soloF;
+        zlDSP::Controller<zlDSP::EngineFloatType> &controllerRef;
         ButtonPanel &buttonPanelRef;
         float currentX{0.}, currentBW{0.};
         double soloQ{0.};
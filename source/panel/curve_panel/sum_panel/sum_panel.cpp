@@ -12,14 +12,20 @@
 namespace zlPanel {
     SumPanel::SumPanel(juce::AudioProcessorValueTreeState &parameters,
                        zlInterface::UIBase &base,
-                       zlDSP::Controller<double> &controller,
+                       zlDSP::Controller<zlDSP::EngineFloatType> &controller,
                        std::array<zlFilter::Ideal<double, 16>, 16> &baseFilters,
                        std::array<zlFilter::Ideal<double, 16>, 16> &mainFilters)
         : parametersRef(parameters),
           uiBase(base), c(controller),
           mMainFilters(mainFilters) {
         juce::ignoreUnused(baseFilters);
-        dBs.resize(ws.size());
+        for (auto &dBs: groupDBs) {
+            dBs.resize(ws.size());
+        }
+        for (auto &dBs: bandDBs) {
+            dBs.resize(ws.size());
+        }
+        bandGroups.fill(noGroup);
         for (auto &path: paths) {
             path.preallocateSpace(static_cast<int>(zlFilter::frequencies.size() * 3));
         }
@@ -75,34 +81,62 @@ namespace zlPanel {
 
     void SumPanel::run() {
         juce::ScopedNoDenormals noDenormals;
-        std::array<bool, 5> useLRMS{false, false, false, false, false};
-        for (size_t i = 0; i < zlDSP::bandNUM; ++i) {
-            const auto idx = static_cast<size_t>(lrTypes[i].load());
-            if (!isBypassed[i].load()) {
-                useLRMS[idx] = true;
+        const auto toRedraw = toRepaint.exchange(false);
+        std::array<bool, 5> isGroupChanged{false, false, false, false, false};
+        // move changed band responses in/out of group sums
+        for (size_t i = 0; i < zlState::bandNUM; ++i) {
+            const auto group = isBypassed[i].load() ? noGroup : static_cast<size_t>(lrTypes[i].load());
+            bool isMagChanged = false;
+            if (group != noGroup) {
+                const auto &filter{c.getMainIdealFilter(i)};
+                mMainFilters[i].setGain(filter.getGain());
+                mMainFilters[i].setQ(filter.getQ());
+                isMagChanged = mMainFilters[i].updateMagnitude(ws);
             }
-        }
-
-        for (size_t j = 0; j < useLRMS.size(); ++j) {
-            paths[j].clear();
-            if (!useLRMS[j]) {
+            if (group == bandGroups[i] && !isMagChanged) {
                 continue;
             }
-
-            std::fill(dBs.begin(), dBs.end(), 0.0);
-            for (size_t i = 0; i < zlState::bandNUM; i++) {
-                auto &filter{c.getMainIdealFilter(i)};
-                if (lrTypes[i].load() == static_cast<zlDSP::lrType::lrTypes>(j) && !isBypassed[i].load()) {
-                    mMainFilters[i].setGain(filter.getGain());
-                    mMainFilters[i].setQ(filter.getQ());
-                    mMainFilters[i].updateMagnitude(ws);
-                    mMainFilters[i].addDBs(dBs);
+            const auto oldGroup = bandGroups[i];
+            if (oldGroup != noGroup) {
+                auto &oldDBs{groupDBs[oldGroup]};
+                groupCounts[oldGroup] -= 1;
+                if (groupCounts[oldGroup] == 0) {
+                    std::fill(oldDBs.begin(), oldDBs.end(), 0.0);
+                } else {
+                    std::transform(oldDBs.begin(), oldDBs.end(), bandDBs[i].begin(), oldDBs.begin(),
+                                   [](const double c1, const double c2) { return c1 - c2; });
                 }
+                isGroupChanged[oldGroup] = true;
             }
-
-            drawCurve(paths[j], dBs, maximumDB.load(), atomicBound.load(), false, true);
+            if (group != noGroup) {
+                bandDBs[i] = mMainFilters[i].getDBs();
+                mMainFilters[i].addDBs(groupDBs[group]);
+                groupCounts[group] += 1;
+                isGroupChanged[group] = true;
+            }
+            bandGroups[i] = group;
         }
-        for (size_t j = 0; j < useLRMS.size(); ++j) {
+        // re-sum groups from cached band responses to avoid drift on full redraws
+        if (toRedraw) {
+            for (auto &dBs: groupDBs) {
+                std::fill(dBs.begin(), dBs.end(), 0.0);
+            }
+            for (size_t i = 0; i < zlState::bandNUM; ++i) {
+                if (bandGroups[i] == noGroup) { continue; }
+                auto &dBs{groupDBs[bandGroups[i]]};
+                std::transform(dBs.begin(), dBs.end(), bandDBs[i].begin(), dBs.begin(),
+                               [](const double c1, const double c2) { return c1 + c2; });
+            }
+        }
+
+        for (size_t j = 0; j < groupDBs.size(); ++j) {
+            if (!toRedraw && !isGroupChanged[j]) {
+                continue;
+            }
+            paths[j].clear();
+            if (groupCounts[j] > 0) {
+                drawCurve(paths[j], groupDBs[j], maximumDB.load(), atomicBound.load(), false, true);
+            }
             juce::GenericScopedLock lock(pathLocks[j]);
             recentPaths[j] = paths[j];
         }
@@ -22,7 +22,7 @@ namespace zlPanel {
     public:
         explicit SumPanel(juce::AudioProcessorValueTreeState &parameters,
                           zlInterface::UIBase &base,
-                          zlDSP::Controller<double> &controller,
+                          zlDSP::Controller<zlDSP::EngineFloatType> &controller,
                           std::array<zlFilter::Ideal<double, 16>, 16> &baseFilters,
                           std::array<zlFilter::Ideal<double, 16>, 16> &mainFilters);
 
@@ -49,12 +49,19 @@ namespace zlPanel {
         std::array<juce::Colour, 5> colours;
         juce::AudioProcessorValueTreeState &parametersRef;
         zlInterface::UIBase &uiBase;
-        zlDSP::Controller<double> &c;
+        zlDSP::Controller<zlDSP::EngineFloatType> &c;
         std::array<zlFilter::Ideal<double, 16>, zlState::bandNUM> &mMainFilters;
         std::atomic<float> maximumDB;
-        std::vector<double> dBs{};
         AtomicBound atomicBound;
 
+        static constexpr size_t noGroup = 5;
+        // the summed dBs of each L/R/M/S group, updated incrementally
+        std::array<std::vector<double>, 5> groupDBs{};
+        std::array<size_t, 5> groupCounts{};
+        // the dBs of each band which have been added to its group
+        std::array<std::vector<double>, zlState::bandNUM> bandDBs{};
+        std::array<size_t, zlState::bandNUM> bandGroups{};
+
         static constexpr std::array changeIDs{
             zlDSP::bypass::ID, zlDSP::lrType::ID
         };
@@ -0,0 +1,564 @@
+// Copyright (C) 2024 - zsliu98
+// This file is part of ZLEqualizer
+//
+// ZLEqualizer is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License Version 3 as published by the Free Software Foundation.
+//
+// ZLEqualizer is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License along with ZLEqualizer. If not, see <https://www.gnu.org/licenses/>.
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <numbers>
+#include <random>
+
+#include "dsp/filter/filter.hpp"
+#include "test_helpers.hpp"
+
+namespace {
+    constexpr size_t bandNum = 4;
+    constexpr size_t filterSize = 16;
+    constexpr double sampleRate = 48000.0;
+
+    using Prototype = zlFilter::PrototypeCorrection<double, bandNum, filterSize>;
+    using Mixed = zlFilter::MixedCorrection<double, bandNum, filterSize>;
+    using Linear = zlFilter::FIR<double, bandNum, filterSize>;
+
+    /**
+     * the filters shared by the stereo (0), left (1), right (2), mid (3) and side (4) groups,
+     * the way the controller holds them
+     */
+    struct Bands {
+        std::array<zlFilter::IIRIdle<double, filterSize>, bandNum> iirs;
+        std::array<zlFilter::Ideal<double, filterSize>, bandNum> ideals;
+        std::array<zlContainer::FixedMaxSizeArray<size_t, bandNum>, 5> indices;
+        std::array<size_t, bandNum> groups{};
+        std::array<bool, bandNum> bypass{};
+        std::vector<std::complex<double> > w1, w2;
+
+        void prepare(const size_t size) {
+            w1.resize(size);
+            w2.resize(size);
+            zlFilter::calculateWsForPrototype<double>(w1);
+            zlFilter::calculateWsForBiquad<double>(w2);
+            for (size_t i = 0; i < bandNum; ++i) {
+                iirs[i].prepare(sampleRate);
+                iirs[i].prepareResponseSize(size);
+                ideals[i].prepare(sampleRate);
+                ideals[i].prepareResponseSize(size);
+                setFreq(i, 100.0 * std::pow(4.0, static_cast<double>(i)));
+                setGain(i, 6.0);
+            }
+            route();
+        }
+
+        void setFreq(const size_t i, const double x) {
+            iirs[i].setFreq(x);
+            ideals[i].setFreq(x);
+        }
+
+        void setGain(const size_t i, const double x) {
+            iirs[i].setGain(x);
+            ideals[i].setGain(x);
+        }
+
+        void route() {
+            for (auto &x: indices) {
+                x.clear();
+            }
+            for (size_t i = 0; i < bandNum; ++i) {
+                indices[groups[i]].push(i);
+            }
+        }
+    };
+
+    template<typename Correction>
+    Correction makeCorrection(Bands &bands, zlContainer::FixedMaxSizeArray<size_t, bandNum> &indices) {
+        if constexpr (std::is_same_v<Correction, Linear>) {
+            return Correction{bands.ideals, indices, bands.bypass, bands.w1};
+        } else {
+            return Correction{bands.iirs, bands.ideals, indices, bands.bypass, bands.w1, bands.w2};
+        }
+    }
+
+    /**
+     * run a job the way StereoCorrection does, the left group is skipped if it is not in use
+     */
+    template<typename Correction>
+    void runJob(std::array<Correction, 2> &corrections, const bool useLeft) {
+        for (auto &c: corrections) {
+            c.syncRouting();
+        }
+        corrections[0].update();
+        if (useLeft) {
+            corrections[1].update();
+        }
+    }
+
+    /**
+     * compare the corrections with a fresh one, which builds every band from the current responses
+     */
+    template<typename Correction>
+    void checkAgainstFullUpdate(const std::array<Correction, 2> &corrections, Bands &bands) {
+        for (size_t group = 0; group < 2; ++group) {
+            auto reference = makeCorrection<Correction>(bands, bands.indices[group]);
+            reference.prepare({sampleRate, 512, 2});
+            reference.syncRouting();
+            reference.update();
+            const auto &actual = corrections[group].getCorrections();
+            const auto &expected = reference.getCorrections();
+            REQUIRE(actual.size() == expected.size());
+            for (size_t j = 0; j < actual.size(); ++j) {
+                INFO("group " << group << ", bin " << j);
+                REQUIRE(std::abs(actual[j] - expected[j]) <= 1e-5f * std::max(1.f, std::abs(expected[j])));
+            }
+        }
+    }
+
+    /**
+     * the FIR of a response the way UniformPartitionConv builds it, in double precision
+     * i.e. the inverse DFT shifted by half of the kernel size and multiplied with a periodic Hann window
+     */
+    std::vector<double> getReferenceKernel(const std::vector<std::complex<double> > &response) {
+        const auto size = (response.size() - 1) * 2;
+        const auto half = size / 2;
+        std::vector<std::complex<double> > twiddles(size);
+        for (size_t i = 0; i < size; ++i) {
+            twiddles[i] = std::polar(1.0, 2.0 * std::numbers::pi * static_cast<double>(i) / static_cast<double>(size));
+        }
+        std::vector<double> kernel(size);
+        for (size_t t = 0; t < size; ++t) {
+            const auto n = (t + half) % size;
+            double sum = response[0].real() + response[half].real() * (n % 2 == 0 ? 1.0 : -1.0);
+            for (size_t k = 1; k < half; ++k) {
+                sum += 2.0 * (response[k] * twiddles[(k * n) % size]).real();
+            }
+            const auto window = .5 - .5 * std::cos(
+                                    2.0 * std::numbers::pi * static_cast<double>(t) / static_cast<double>(size));
+            kernel[t] = sum / static_cast<double>(size) * window;
+        }
+        return kernel;
+    }
+
+    /**
+     * convolve the whole input with the 2x2 kernel matrix {{h00, h01}, {h10, h11}} directly
+     * the output is delayed by the partition size, a mono input only uses h00
+     */
+    std::array<std::vector<double>, 2> convolveDirectly(const std::array<std::vector<double>, 4> &kernels,
+                                                       const std::array<std::vector<double>, 2> &inputs,
+                                                       const size_t numChannels, const size_t delay) {
+        const auto length = inputs[0].size();
+        std::array<std::vector<double>, 2> outputs{std::vector<double>(length), std::vector<double>(length)};
+        for (size_t n = delay; n < length; ++n) {
+            const auto m = n - delay;
+            for (size_t t = 0; t < kernels[0].size() && t <= m; ++t) {
+                const auto l = inputs[0][m - t];
+                if (numChannels == 1) {
+                    outputs[0][n] += kernels[0][t] * l;
+                } else {
+                    const auto r = inputs[1][m - t];
+                    outputs[0][n] += kernels[0][t] * l + kernels[1][t] * r;
+                    outputs[1][n] += kernels[2][t] * l + kernels[3][t] * r;
+                }
+            }
+        }
+        return outputs;
+    }
+
+    /**
+     * process the whole input with blocks of the block size
+     */
+    template<typename Processor>
+    std::array<std::vector<double>, 2> processInBlocks(Processor &&processor,
+                                                      const std::array<std::vector<double>, 2> &inputs,
+                                                      const size_t numChannels, const size_t blockSize) {
+        auto outputs = inputs;
+        juce::AudioBuffer<double> buffer(static_cast<int>(numChannels), static_cast<int>(blockSize));
+        for (size_t start = 0; start < inputs[0].size(); start += blockSize) {
+            const auto size = std::min(blockSize, inputs[0].size() - start);
+            juce::AudioBuffer<double> block(buffer.getArrayOfWritePointers(), static_cast<int>(numChannels),
+                                            static_cast<int>(size));
+            for (size_t channel = 0; channel < numChannels; ++channel) {
+                std::copy(inputs[channel].begin() + static_cast<std::ptrdiff_t>(start),
+                          inputs[channel].begin() + static_cast<std::ptrdiff_t>(start + size),
+                          block.getWritePointer(static_cast<int>(channel)));
+            }
+            processor(block);
+            for (size_t channel = 0; channel < numChannels; ++channel) {
+                std::copy(block.getWritePointer(static_cast<int>(channel)),
+                          block.getWritePointer(static_cast<int>(channel)) + size,
+                          outputs[channel].begin() + static_cast<std::ptrdiff_t>(start));
+            }
+        }
+        return outputs;
+    }
+
+    std::array<std::vector<double>, 2> getNoise(const size_t length, const unsigned int seed) {
+        juce::AudioBuffer<double> buffer(2, static_cast<int>(length));
+        zlTest::fillNoise(buffer, seed);
+        return {
+            std::vector<double>(buffer.getWritePointer(0), buffer.getWritePointer(0) + length),
+            std::vector<double>(buffer.getWritePointer(1), buffer.getWritePointer(1) + length)
+        };
+    }
+
+    double getMaxError(const std::array<std::vector<double>, 2> &actual,
+                       const std::array<std::vector<double>, 2> &expected, const size_t numChannels) {
+        double maxError = 0.0;
+        for (size_t channel = 0; channel < numChannels; ++channel) {
+            for (size_t i = 0; i < actual[channel].size(); ++i) {
+                maxError = std::max(maxError, std::abs(actual[channel][i] - expected[channel][i]));
+            }
+        }
+        return maxError;
+    }
+}
+
+TEST_CASE("ProductTree matches the direct product", "[correction]") {
+    constexpr size_t leafNum = 5;
+    constexpr size_t size = 64;
+    zlFilter::ProductTree<std::complex<float>, leafNum> tree;
+    tree.setSize(size);
+    std::array<std::vector<std::complex<float> >, leafNum> leaves;
+    for (auto &leaf: leaves) {
+        leaf.resize(size, std::complex(1.f, 0.f));
+    }
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> magDist(.5f, 2.f), argDist(-3.f, 3.f);
+    std::uniform_int_distribution<size_t> leafDist(0, leafNum - 1);
+    for (size_t round = 0; round < 100; ++round) {
+        const auto idx = leafDist(gen);
+        if (round % 7 == 0) {
+            std::fill(leaves[idx].begin(), leaves[idx].end(), std::complex(1.f, 0.f));
+            tree.setLeafToOne(idx);
+        } else {
+            for (auto &x: leaves[idx]) {
+                x = std::polar(magDist(gen), argDist(gen));
+            }
+            tree.getLeaf(idx) = leaves[idx];
+            tree.setToUpdate(idx);
+        }
+        const auto &product = tree.update();
+        for (size_t j = 0; j < size; ++j) {
+            auto expected = std::complex(1.f, 0.f);
+            for (const auto &leaf: leaves) {
+                expected *= leaf[j];
+            }
+            REQUIRE(std::abs(product[j] - expected) <= 1e-5f * std::max(1.f, std::abs(expected)));
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("Correction rebuilds bands routed back from another group", "[correction]",
+                   Prototype, Mixed, Linear) {
+    Bands bands;
+    std::array<TestType, 2> corrections{
+        makeCorrection<TestType>(bands, bands.indices[0]),
+        makeCorrection<TestType>(bands, bands.indices[1])
+    };
+    for (auto &c: corrections) {
+        c.prepare({sampleRate, 512, 2});
+    }
+    bands.prepare(corrections[0].getCorrectionSize());
+
+    // the only left band
+    bands.groups[0] = 1;
+    bands.route();
+    runJob(corrections, true);
+    checkAgainstFullUpdate(corrections, bands);
+
+    // move it to the stereo group, then the left group is no longer in use
+    bands.groups[0] = 0;
+    bands.route();
+    for (auto &c: corrections) {
+        c.setToUpdate();
+    }
+    runJob(corrections, false);
+
+    // edit it in the stereo group, which consumes the updated responses
+    bands.setGain(0, -9.0);
+    bands.setFreq(0, 250.0);
+    runJob(corrections, false);
+
+    // move it back to the left group
+    bands.groups[0] = 1;
+    bands.route();
+    for (auto &c: corrections) {
+        c.setToUpdate();
+    }
+    runJob(corrections, true);
+    checkAgainstFullUpdate(corrections, bands);
+}
+
+TEMPLATE_TEST_CASE("Correction follows bypass toggles", "[correction]", Prototype, Mixed, Linear) {
+    Bands bands;
+    std::array<TestType, 2> corrections{
+        makeCorrection<TestType>(bands, bands.indices[0]),
+        makeCorrection<TestType>(bands, bands.indices[1])
+    };
+    for (auto &c: corrections) {
+        c.prepare({sampleRate, 512, 2});
+    }
+    bands.prepare(corrections[0].getCorrectionSize());
+    bands.groups = {0, 1, 0, 1};
+    bands.route();
+    runJob(corrections, true);
+
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<size_t> bandDist(0, bandNum - 1);
+    std::uniform_real_distribution<double> gainDist(-12.0, 12.0);
+    for (size_t round = 0; round < 40; ++round) {
+        const auto idx = bandDist(gen);
+        if (round % 3 == 0) {
+            // the controller updates all corrections when the bypass state changes
+            bands.bypass[idx] = !bands.bypass[idx];
+            for (auto &c: corrections) {
+                c.setToUpdate();
+            }
+        } else {
+            // a bypassed band may be edited as well
+            bands.setGain(idx, gainDist(gen));
+        }
+        runJob(corrections, true);
+        checkAgainstFullUpdate(corrections, bands);
+    }
+}
+
+TEST_CASE("UniformPartitionConv matches direct convolution", "[correction]") {
+    const auto numChannels = static_cast<size_t>(GENERATE(1, 2));
+    const auto isDiagonal = GENERATE(true, false);
+    const auto blockSize = static_cast<size_t>(GENERATE(1, 37, 480, 4096));
+    constexpr size_t kernelOrder = 10, partitionOrder = 7;
+    constexpr size_t kernelSize = static_cast<size_t>(1) << kernelOrder;
+    constexpr size_t numBins = kernelSize / 2 + 1;
+
+    // smooth random responses with random delays, which are about one order of magnitude around 1
+    std::mt19937 gen(static_cast<unsigned int>(blockSize));
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::array<std::vector<std::complex<float> >, 4> responses;
+    std::array<std::vector<double>, 4> kernels;
+    for (size_t e = 0; e < 4; ++e) {
+        const auto a = dist(gen), b = dist(gen), delay = 20.0 * dist(gen);
+        std::vector<std::complex<double> > response(numBins);
+        for (size_t i = 0; i < numBins; ++i) {
+            const auto x = static_cast<double>(i) / static_cast<double>(numBins - 1);
+            response[i] = std::polar(std::exp(a * std::sin(3.0 * x) + b * x),
+                                     -std::numbers::pi * x * delay);
+        }
+        responses[e].resize(numBins);
+        std::transform(response.begin(), response.end(), responses[e].begin(),
+                       [](const auto &c) { return std::complex<float>(c); });
+        // the engine designs in float, the reference is built from the same float response
+        std::transform(responses[e].begin(), responses[e].end(), response.begin(),
+                       [](const auto &c) { return std::complex<double>(c); });
+        kernels[e] = getReferenceKernel(response);
+    }
+    if (isDiagonal || numChannels == 1) {
+        kernels[1] = std::vector<double>(kernelSize, 0.0);
+        kernels[2] = kernels[1];
+        kernels[3] = kernels[0];
+    }
+
+    zlConvolution::UniformPartitionConv<double> conv;
+    conv.prepare(kernelOrder, partitionOrder, numChannels);
+    REQUIRE(conv.getLatency() == static_cast<int>((static_cast<size_t>(1) << partitionOrder) + kernelSize / 2));
+    conv.setBackKernel(responses[0], responses[1], responses[2], responses[3], isDiagonal);
+    // swap the kernel in at the first hop, which is silent, so that the crossfade does not show up
+    bool isSwapped = false;
+    const auto inputs = getNoise(kernelSize * 6, 7);
+    auto silentInputs = inputs;
+    for (auto &x: silentInputs) {
+        std::fill(x.begin(), x.begin() + static_cast<std::ptrdiff_t>(conv.getPartitionSize()), 0.0);
+    }
+    const auto actual = processInBlocks([&](juce::AudioBuffer<double> &block) {
+        conv.process(block, [&]() {
+            if (!isSwapped) {
+                conv.swapKernel();
+                isSwapped = true;
+            }
+        });
+    }, silentInputs, numChannels, blockSize);
+    const auto expected = convolveDirectly(kernels, silentInputs, numChannels, conv.getPartitionSize());
+    // the noise is about -12 dBFS, the difference comes from float FFT rounding only
+    CHECK(getMaxError(actual, expected, numChannels) < 1e-4);
+}
+
+TEST_CASE("UniformPartitionConv crossfades a swapped kernel over one hop", "[correction]") {
+    constexpr size_t kernelOrder = 10, partitionOrder = 7;
+    constexpr size_t kernelSize = static_cast<size_t>(1) << kernelOrder;
+    constexpr size_t partitionSize = static_cast<size_t>(1) << partitionOrder;
+    zlConvolution::UniformPartitionConv<double> conv;
+    conv.prepare(kernelOrder, partitionOrder, 2);
+    // a gain of 2, which is swapped in once the output of the unity kernel has settled
+    const std::vector<std::complex<float> > twos(kernelSize / 2 + 1, std::complex(2.f, 0.f));
+    conv.setBackKernel(twos, twos, twos, twos, true);
+    const auto swapHop = static_cast<size_t>(conv.getLatency()) / partitionSize + 2;
+    size_t hop = 0;
+    const std::array inputs{std::vector<double>(kernelSize * 2, 1.0), std::vector<double>(kernelSize * 2, 1.0)};
+    const auto outputs = processInBlocks([&](juce::AudioBuffer<double> &block) {
+        conv.process(block, [&]() {
+            if (hop == swapHop) {
+                conv.swapKernel();
+            }
+            hop += 1;
+        });
+    }, inputs, 2, 64);
+    for (size_t channel = 0; channel < 2; ++channel) {
+        const auto &y = outputs[channel];
+        const auto settled = static_cast<size_t>(conv.getLatency());
+        CHECK(std::abs(y[settled] - 1.0) < 1e-5);
+        CHECK(std::abs(y.back() - 2.0) < 1e-5);
+        // the gain ramps up over one hop instead of jumping
+        for (size_t i = settled; i + 1 < y.size(); ++i) {
+            INFO("channel " << channel << ", sample " << i);
+            REQUIRE(std::abs(y[i + 1] - y[i]) < 1.0 / static_cast<double>(partitionSize) + 1e-5);
+        }
+    }
+}
+
+TEST_CASE("StereoCorrection matches direct convolution of its corrections", "[correction]") {
+    // stereo, L/R, L/R + M/S and mono (with L/R + M/S)
+    const auto config = GENERATE(0, 1, 2, 3);
+    const auto numChannels = static_cast<size_t>(config == 3 ? 1 : 2);
+    const auto useLR = config >= 1, useMS = config >= 2;
+    constexpr int blockSize = 480;
+
+    Bands bands;
+    std::array<Prototype, 5> corrections{
+        makeCorrection<Prototype>(bands, bands.indices[0]),
+        makeCorrection<Prototype>(bands, bands.indices[1]),
+        makeCorrection<Prototype>(bands, bands.indices[2]),
+        makeCorrection<Prototype>(bands, bands.indices[3]),
+        makeCorrection<Prototype>(bands, bands.indices[4])
+    };
+    zlFilter::CorrectionWorker worker;
+    zlFilter::StereoCorrection<double, Prototype> stage{corrections, worker};
+    stage.prepare({sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels)});
+    bands.prepare(stage.getCorrectionSize());
+    // the group of each band
+    constexpr std::array<std::array<size_t, bandNum>, 4> routings{
+        {{0, 0, 0, 0}, {0, 1, 2, 1}, {0, 1, 3, 4}, {0, 1, 3, 4}}
+    };
+    bands.groups = routings[static_cast<size_t>(config)];
+    bands.route();
+    const std::array<float, 5> gains{.9f, 1.1f, .8f, 1.2f, .7f};
+    for (size_t i = 0; i < 5; ++i) {
+        stage.setGroupGain(i, static_cast<double>(gains[i]));
+    }
+    stage.setGroups(useLR, useMS);
+    worker.start();
+
+    // request the corrections and wait for the worker, the kernel is swapped in at the next hop
+    const auto kernelSize = static_cast<size_t>(1) << corrections[0].getFFTOrder();
+    const auto partitionSize = static_cast<size_t>(stage.getLatency()) - kernelSize / 2;
+    juce::AudioBuffer<double> buffer(static_cast<int>(numChannels), blockSize);
+    for (size_t round = 0; round < 2; ++round) {
+        for (size_t i = 0; i < partitionSize / blockSize + 1; ++i) {
+            buffer.clear();
+            stage.process(buffer);
+        }
+        juce::Thread::sleep(200);
+    }
+    stage.reset();
+
+    // the matrix applied to {L, R} is the composition of the group corrections on each channel
+    std::array<std::vector<double>, 4> kernels;
+    {
+        std::array<std::vector<std::complex<double> >, 4> matrix;
+        for (auto &m: matrix) {
+            m.resize(stage.getCorrectionSize());
+        }
+        for (size_t i = 0; i < stage.getCorrectionSize(); ++i) {
+            const auto apply = [&](std::complex<double> l, std::complex<double> r) {
+                const auto c = [&](const size_t group) {
+                    return std::complex<double>(corrections[group].getCorrections()[i]) *
+                           static_cast<double>(gains[group]);
+                };
+                if (useLR) {
+                    l *= c(1);
+                    r *= c(2);
+                }
+                if (useMS) {
+                    auto m = (l + r) * .5, s = (l - r) * .5;
+                    m *= c(3);
+                    s *= c(4);
+                    l = m + s;
+                    r = m - s;
+                }
+                return std::array{l * c(0), r * c(0)};
+            };
+            if (numChannels == 1) {
+                // a mono channel is the left channel of identical stereo channels
+                matrix[0][i] = apply(1.0, 1.0)[0];
+            } else {
+                const auto column0 = apply(1.0, 0.0), column1 = apply(0.0, 1.0);
+                matrix[0][i] = column0[0];
+                matrix[1][i] = column1[0];
+                matrix[2][i] = column0[1];
+                matrix[3][i] = column1[1];
+            }
+        }
+        for (size_t e = 0; e < (numChannels == 1 ? 1 : 4); ++e) {
+            // the stage designs the kernels in float
+            for (auto &x: matrix[e]) {
+                x = std::complex<double>(std::complex<float>(x));
+            }
+            kernels[e] = getReferenceKernel(matrix[e]);
+        }
+    }
+
+    const auto inputs = getNoise(kernelSize * 6, 11);
+    const auto actual = processInBlocks([&](juce::AudioBuffer<double> &block) {
+        stage.process(block);
+    }, inputs, numChannels, blockSize);
+    const auto expected = convolveDirectly(kernels, inputs, numChannels, partitionSize);
+    CHECK(getMaxError(actual, expected, numChannels) < 1e-4);
+}
+
+TEST_CASE("StereoCorrection delays an impulse by its latency", "[correction]") {
+    const auto numChannels = static_cast<size_t>(GENERATE(1, 2));
+    const auto isBypassed = GENERATE(false, true);
+    constexpr int blockSize = 480;
+
+    // without any band, every correction is 1
+    Bands bands;
+    std::array<Linear, 5> corrections{
+        makeCorrection<Linear>(bands, bands.indices[0]),
+        makeCorrection<Linear>(bands, bands.indices[1]),
+        makeCorrection<Linear>(bands, bands.indices[2]),
+        makeCorrection<Linear>(bands, bands.indices[3]),
+        makeCorrection<Linear>(bands, bands.indices[4])
+    };
+    zlFilter::CorrectionWorker worker;
+    zlFilter::StereoCorrection<double, Linear> stage{corrections, worker};
+    stage.prepare({sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels)});
+    // the linear structure used to delay by the full FFT size
+    const auto fftSize = static_cast<int>(static_cast<size_t>(1) << corrections[0].getFFTOrder());
+    REQUIRE(stage.getLatency() == fftSize / 2 + fftSize / 8);
+
+    constexpr size_t impulsePos = 1000;
+    std::array<std::vector<double>, 2> inputs{
+        std::vector<double>(static_cast<size_t>(fftSize) * 2, 0.0),
+        std::vector<double>(static_cast<size_t>(fftSize) * 2, 0.0)
+    };
+    inputs[0][impulsePos] = 1.0;
+    inputs[1][impulsePos] = -.5;
+    const auto outputs = processInBlocks([&](juce::AudioBuffer<double> &block) {
+        if (isBypassed) {
+            stage.process<true>(block);
+        } else {
+            stage.process(block);
+        }
+    }, inputs, numChannels, blockSize);
+    const auto peakPos = impulsePos + static_cast<size_t>(stage.getLatency());
+    for (size_t channel = 0; channel < numChannels; ++channel) {
+        for (size_t i = 0; i < outputs[channel].size(); ++i) {
+            INFO("channel " << channel << ", sample " << i);
+            const auto expected = i == peakPos ? inputs[channel][impulsePos] : 0.0;
+            REQUIRE(std::abs(outputs[channel][i] - expected) < 1e-5);
+        }
+    }
+}
@@ -0,0 +1,179 @@
+// Copyright (C) 2024 - zsliu98
+// This file is part of ZLEqualizer
+//
+// ZLEqualizer is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License Version 3 as published by the Free Software Foundation.
+//
+// ZLEqualizer is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License along with ZLEqualizer. If not, see <https://www.gnu.org/licenses/>.
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "PluginProcessor.hpp"
+#include "test_helpers.hpp"
+
+namespace {
+    constexpr size_t activeBandNum = 8;
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+
+    /**
+     * a controller driven by the parameters of the processor, the way the processor drives its own one
+     */
+    template<typename FloatType>
+    struct Engine {
+        zlDSP::Controller<FloatType> controller;
+        zlDSP::FiltersAttach<FloatType> filtersAttach;
+        zlDSP::ChoreAttach<FloatType> choreAttach;
+        juce::AudioBuffer<FloatType> buffer{4, blockSize};
+
+        explicit Engine(PluginProcessor &processor)
+            : controller(processor),
+              filtersAttach(processor, processor.parameters, processor.parametersNA, controller),
+              choreAttach(processor, processor.parameters, processor.parametersNA, controller) {
+        }
+
+        void process(const juce::AudioBuffer<double> &source) {
+            for (int channel = 0; channel < 4; ++channel) {
+                for (int i = 0; i < blockSize; ++i) {
+                    buffer.setSample(channel, i, static_cast<FloatType>(source.getSample(channel, i)));
+                }
+            }
+            controller.process(buffer);
+        }
+
+        bool isMainSilent() const {
+            return buffer.getMagnitude(0, 0, blockSize) == FloatType(0) &&
+                   buffer.getMagnitude(1, 0, blockSize) == FloatType(0);
+        }
+    };
+
+    void setPeakBand(PluginProcessor &processor, const size_t i, const float freq, const float gain) {
+        zlTest::setParameter(processor.parametersNA, zlDSP::appendSuffix(zlState::active::ID, i), 1.f);
+        zlTest::setParameter(processor.parameters, zlDSP::appendSuffix(zlDSP::fType::ID, i),
+                             static_cast<float>(zlDSP::fType::peak));
+        zlTest::setParameter(processor.parameters, zlDSP::appendSuffix(zlDSP::freq::ID, i), freq);
+        zlTest::setParameter(processor.parameters, zlDSP::appendSuffix(zlDSP::gain::ID, i), gain);
+    }
+}
+
+TEST_CASE("Float engine stays within the stated bound of the double engine", "[engine]") {
+    // {structure, the frequency of the lowest band, the relative error per band in dB}
+    const auto [structure, lowestFreq, boundPerBand] = GENERATE(
+        table<zlDSP::filterStructure::FilterStructure, float, double>({
+            {zlDSP::filterStructure::minimum, 20.f, -120.0},
+            {zlDSP::filterStructure::svf, 20.f, -120.0},
+            {zlDSP::filterStructure::parallel, 20.f, -120.0}
+        }));
+    const auto q = GENERATE(0.707f, 2.f, 10.f);
+
+    PluginProcessor processor;
+    Engine<float> floatEngine(processor);
+    Engine<double> doubleEngine(processor);
+    zlTest::setParameter(processor.parameters, zlDSP::filterStructure::ID, static_cast<float>(structure));
+    for (size_t i = 0; i < activeBandNum; ++i) {
+        zlTest::setParameter(processor.parametersNA, zlDSP::appendSuffix(zlState::active::ID, i), 1.f);
+        zlTest::setParameter(processor.parameters, zlDSP::appendSuffix(zlDSP::fType::ID, i),
+                                  static_cast<float>(zlDSP::fType::peak));
+        zlTest::setParameter(processor.parameters, zlDSP::appendSuffix(zlDSP::freq::ID, i),
+                                  lowestFreq * std::pow(2.f, static_cast<float>(i) * 1.25f));
+        zlTest::setParameter(processor.parameters, zlDSP::appendSuffix(zlDSP::gain::ID, i),
+                                  i % 2 == 0 ? 6.f : -6.f);
+        zlTest::setParameter(processor.parameters, zlDSP::appendSuffix(zlDSP::Q::ID, i), q);
+    }
+    const juce::dsp::ProcessSpec spec{sampleRate, static_cast<juce::uint32>(blockSize), 2};
+    floatEngine.controller.prepare(spec);
+    doubleEngine.controller.prepare(spec);
+
+    juce::AudioBuffer<double> source(4, blockSize);
+    double errorEnergy = 0.0, signalEnergy = 0.0;
+    constexpr int blockNum = 2 * static_cast<int>(sampleRate) / blockSize;
+    for (int j = 0; j < blockNum; ++j) {
+        zlTest::fillNoise(source, static_cast<unsigned int>(j));
+        floatEngine.process(source);
+        doubleEngine.process(source);
+        // skip the first second, in which the parameters are smoothed
+        if (j < blockNum / 2) continue;
+        for (int channel = 0; channel < 2; ++channel) {
+            for (int i = 0; i < blockSize; ++i) {
+                const auto y = doubleEngine.buffer.getSample(channel, i);
+                const auto e = static_cast<double>(floatEngine.buffer.getSample(channel, i)) - y;
+                errorEnergy += e * e;
+                signalEnergy += y * y;
+            }
+        }
+    }
+
+    const auto errorDB = 10.0 * std::log10(errorEnergy / signalEnergy);
+    INFO("structure " << static_cast<int>(structure) << ", Q " << q << ", error " << errorDB << " dB");
+    // the errors of the bands add up at worst coherently
+    CHECK(errorDB < boundPerBand + 20.0 * std::log10(static_cast<double>(activeBandNum)));
+}
+
+TEST_CASE("Controller idles on input below the silence floor", "[engine]") {
+    const auto floor = GENERATE(zlDSP::silenceFloor::defaultV, -100.f);
+
+    PluginProcessor processor;
+    Engine<double> engine(processor);
+    setPeakBand(processor, 0, 1000.f, 6.f);
+    zlTest::setParameter(processor.parameters, zlDSP::silenceFloor::ID, floor);
+    engine.controller.prepare({sampleRate, static_cast<juce::uint32>(blockSize), 2});
+
+    // noise at about -120 dBFS, which is above digital silence but below a -100 dB floor
+    juce::AudioBuffer<double> source(4, blockSize);
+    constexpr int blockNum = static_cast<int>(sampleRate) / blockSize;
+    for (int j = 0; j < blockNum; ++j) {
+        zlTest::fillNoise(source, static_cast<unsigned int>(j));
+        source.applyGain(4e-6);
+        engine.process(source);
+    }
+    INFO("silence floor " << floor << " dB");
+    CHECK(engine.isMainSilent() == (floor > zlDSP::silenceFloor::defaultV));
+}
+
+TEST_CASE("Controller resumes bit-exact after idle with phase flip on", "[engine]") {
+    const auto structure = GENERATE(zlDSP::filterStructure::minimum, zlDSP::filterStructure::svf,
+                                    zlDSP::filterStructure::parallel);
+
+    PluginProcessor processor;
+    // the first one goes idle after some signal, the second one has only seen silence
+    Engine<double> resumed(processor), fresh(processor);
+    zlTest::setParameter(processor.parameters, zlDSP::filterStructure::ID, static_cast<float>(structure));
+    zlTest::setParameter(processor.parameters, zlDSP::phaseFlip::ID, 1.f);
+    setPeakBand(processor, 0, 100.f, 6.f);
+    setPeakBand(processor, 1, 4000.f, -6.f);
+    const juce::dsp::ProcessSpec spec{sampleRate, static_cast<juce::uint32>(blockSize), 2};
+    resumed.controller.prepare(spec);
+    fresh.controller.prepare(spec);
+
+    juce::AudioBuffer<double> source(4, blockSize), silence(4, blockSize);
+    silence.clear();
+    constexpr int blockNum = static_cast<int>(sampleRate) / blockSize;
+    for (int j = 0; j < blockNum; ++j) {
+        zlTest::fillNoise(source, static_cast<unsigned int>(j));
+        resumed.process(source);
+        fresh.process(silence);
+    }
+    for (int j = 0; j < 2 * blockNum; ++j) {
+        resumed.process(silence);
+        fresh.process(silence);
+    }
+    REQUIRE(resumed.isMainSilent());
+
+    // the signal returns, the output should be exactly the one of an engine whose tail has fully decayed
+    bool hasSignal = false;
+    for (int j = 0; j < blockNum; ++j) {
+        zlTest::fillNoise(source, static_cast<unsigned int>(blockNum + j));
+        resumed.process(source);
+        fresh.process(source);
+        hasSignal = hasSignal || !resumed.isMainSilent();
+        INFO("structure " << static_cast<int>(structure) << ", block " << j);
+        for (int channel = 0; channel < 2; ++channel) {
+            for (int i = 0; i < blockSize; ++i) {
+                REQUIRE(resumed.buffer.getSample(channel, i) == fresh.buffer.getSample(channel, i));
+            }
+        }
+    }
+    CHECK(hasSignal);
+}
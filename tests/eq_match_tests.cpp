@@ -0,0 +1,201 @@
+// Copyright (C) 2024 - zsliu98
+// This file is part of ZLEqualizer
+//
+// ZLEqualizer is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License Version 3 as published by the Free Software Foundation.
+//
+// ZLEqualizer is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License along with ZLEqualizer. If not, see <https://www.gnu.org/licenses/>.
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <memory>
+#include <numbers>
+#include <random>
+
+#include "dsp/eq_match/eq_match_optimizer.hpp"
+
+namespace {
+    constexpr size_t diffsSize = 251;
+    using Optimizer = zlEqMatch::EqMatchOptimizer<16>;
+
+    /**
+     * a target curve with a boost around 200 Hz and a cut around 5 kHz, which one band can not fit
+     */
+    std::vector<double> getTwoBandDiffs() {
+        std::vector<double> diffs(diffsSize);
+        for (size_t i = 0; i < diffsSize; ++i) {
+            const auto freqLog = Optimizer::diffMinFreqLog + (Optimizer::diffMaxFreqLog - Optimizer::diffMinFreqLog) *
+                                 static_cast<double>(i) / static_cast<double>(diffsSize - 1);
+            diffs[i] = 6.0 * std::exp(-std::pow((freqLog - std::log(200.0)) / .5, 2.0))
+                       - 6.0 * std::exp(-std::pow((freqLog - std::log(5000.0)) / .5, 2.0));
+        }
+        return diffs;
+    }
+
+    /**
+     * the angular frequencies of the diffs
+     */
+    std::vector<double> getDiffWs() {
+        std::vector<double> ws(diffsSize);
+        for (size_t i = 0; i < diffsSize; ++i) {
+            const auto freqLog = Optimizer::diffMinFreqLog + (Optimizer::diffMaxFreqLog - Optimizer::diffMinFreqLog) *
+                                 static_cast<double>(i) / static_cast<double>(diffsSize - 1);
+            ws[i] = std::exp(freqLog) / 48000.0 * 2.0 * std::numbers::pi;
+        }
+        return ws;
+    }
+}
+
+TEST_CASE("EqMatchOptimizer keeps fitting after the first band", "[eq_match]") {
+    const auto diffs = getTwoBandDiffs();
+    auto optimizer = std::make_unique<Optimizer>();
+    optimizer->setDiffs(diffs.data(), diffs.size());
+    optimizer->runDeterministic();
+
+    const auto &mse = optimizer->getMSE();
+    auto &sol = optimizer->getSol();
+    // one band leaves the other bump, so the fit has to go on with the second band
+    REQUIRE(mse[0] > Optimizer::eps);
+    CHECK(mse[1] < mse[0]);
+    CHECK(std::abs(sol[0].getGain()) > 1.0);
+    CHECK(std::abs(sol[1].getGain()) > 1.0);
+    // one band for each bump
+    CHECK((sol[0].getFreq() < 1000.0) != (sol[1].getFreq() < 1000.0));
+}
+
+TEST_CASE("Ideal analytic gradients match finite differences", "[eq_match]") {
+    const auto filterType = GENERATE(zlFilter::FilterType::peak, zlFilter::FilterType::lowShelf,
+                                     zlFilter::FilterType::highShelf, zlFilter::FilterType::tiltShelf,
+                                     zlFilter::FilterType::lowPass, zlFilter::FilterType::highPass,
+                                     zlFilter::FilterType::bandPass, zlFilter::FilterType::notch);
+    const auto order = GENERATE(as<size_t>{}, 1, 2, 4, 6);
+
+    const auto ws = getDiffWs();
+    zlFilter::Ideal<double, Optimizer::maximumOrder> filter;
+    filter.prepare(48000.0);
+    filter.prepareDBSize(diffsSize);
+    filter.setFilterType(filterType);
+    filter.setOrder(order);
+    // the gradients are w.r.t. log(freq), gain (dB) and log(Q)
+    const auto setParas = [&](const std::array<double, 3> &x) {
+        filter.setFreq(std::exp(x[0]));
+        filter.setGain(x[1]);
+        filter.setQ(std::exp(x[2]));
+    };
+
+    std::mt19937 gen(static_cast<unsigned int>(filterType) * 16 + static_cast<unsigned int>(order));
+    // stay away from the bounds, so that the central differences do not leave the parameter range
+    std::array<std::uniform_real_distribution<double>, 3> dists{
+        std::uniform_real_distribution<double>(Optimizer::minFreqLog + .1, Optimizer::maxFreqLog - .1),
+        std::uniform_real_distribution<double>(Optimizer::minGain + 1., Optimizer::maxGain - 1.),
+        std::uniform_real_distribution<double>(Optimizer::minQLog + .1, Optimizer::maxQLog - .1)
+    };
+    // Ideal ignores parameter changes below 1e-6, so the step has to be larger than that
+    constexpr std::array<double, 3> hs{1e-4, 1e-3, 1e-4};
+    for (size_t trial = 0; trial < 50; ++trial) {
+        std::array<double, 3> x{};
+        for (size_t j = 0; j < 3; ++j) {
+            x[j] = dists[j](gen);
+        }
+        if (filterType == zlFilter::FilterType::notch) {
+            // the dB of a notch has a pole at its center, keep it halfway between two diff frequencies
+            const auto step = (Optimizer::diffMaxFreqLog - Optimizer::diffMinFreqLog) /
+                              static_cast<double>(diffsSize - 1);
+            x[0] = Optimizer::diffMinFreqLog + (std::floor((x[0] - Optimizer::diffMinFreqLog) / step) + .5) * step;
+        }
+        setParas(x);
+        filter.updateMagnitudeAndGrads(ws);
+        const auto dBGrads = filter.getDBGrads();
+        for (size_t j = 0; j < 3; ++j) {
+            auto xp = x, xm = x;
+            xp[j] += hs[j];
+            xm[j] -= hs[j];
+            setParas(xp);
+            filter.updateMagnitude(ws);
+            const auto dBP = filter.getDBs();
+            setParas(xm);
+            filter.updateMagnitude(ws);
+            const auto &dBM = filter.getDBs();
+            double maxError = 0.0, maxGrad = 0.0;
+            for (size_t i = 0; i < diffsSize; ++i) {
+                const auto fdGrad = (dBP[i] - dBM[i]) / (2 * hs[j]);
+                maxError = std::max(maxError, std::abs(fdGrad - dBGrads[j][i]));
+                maxGrad = std::max(maxGrad, std::abs(dBGrads[j][i]));
+            }
+            INFO("trial " << trial << ", parameter " << j << ", max gradient " << maxGrad);
+            CHECK(maxError <= 1e-4 * std::max(maxGrad, 1.0));
+        }
+    }
+}
+
+TEST_CASE("EqMatchOptimizer stops at a stationary point of the mse", "[eq_match]") {
+    const auto filterType = GENERATE(zlFilter::FilterType::lowShelf, zlFilter::FilterType::peak,
+                                     zlFilter::FilterType::highShelf);
+    const auto order = GENERATE(as<size_t>{}, 2, 4, 6);
+
+    const auto ws = getDiffWs();
+    zlFilter::Ideal<double, Optimizer::maximumOrder> filter;
+    filter.prepare(48000.0);
+    filter.prepareDBSize(diffsSize);
+    filter.setFilterType(filterType);
+    filter.setOrder(order);
+    // a band of the tested type plus a ripple which no band can fit, so that the mse stays above zero
+    filter.setFreq(800.0);
+    filter.setGain(8.0);
+    filter.setQ(1.2);
+    filter.updateMagnitude(ws);
+    std::vector<double> diffs(diffsSize);
+    for (size_t i = 0; i < diffsSize; ++i) {
+        diffs[i] = filter.getDBs()[i] + std::sin(static_cast<double>(i) * .3);
+    }
+
+    auto optimizer = std::make_unique<Optimizer>();
+    optimizer->setDiffs(diffs.data(), diffs.size());
+    // the deterministic fit leaves out the last diff, so do the stochastic one
+    constexpr size_t endIdx = diffsSize - 1;
+    // the deterministic fit only uses the second order, other orders go through the stochastic one
+    if (order == 2) {
+        optimizer->runDeterministic(0, endIdx);
+    } else {
+        optimizer->runStochasticPlus({order}, 0, endIdx);
+    }
+    const auto &fitted = optimizer->getSol()[0];
+    REQUIRE(fitted.getFilterType() == filterType);
+    REQUIRE(fitted.getOrder() == order);
+
+    // the mse of the first band against the target, in the parameters the optimizer works with
+    const auto getMSE = [&](const std::array<double, 3> &x) {
+        filter.setFreq(std::exp(x[0]));
+        filter.setGain(x[1] / Optimizer::gainScale);
+        filter.setQ(std::exp(x[2]));
+        filter.updateMagnitude(ws);
+        const auto &dB = filter.getDBs();
+        double mse = 0.0;
+        for (size_t i = 0; i < endIdx; ++i) {
+            mse += (dB[i] - diffs[i]) * (dB[i] - diffs[i]);
+        }
+        // the optimizer divides by the number of all diffs
+        return mse / static_cast<double>(diffsSize);
+    };
+    const std::array<double, 3> x{
+        std::log(fitted.getFreq()), fitted.getGain() * Optimizer::gainScale, std::log(fitted.getQ())
+    };
+    const auto mse = getMSE(x);
+    REQUIRE(mse > Optimizer::eps);
+    CHECK(std::abs(mse - optimizer->getMSE()[0]) <= 1e-6 * mse);
+
+    // Levenberg-Marquardt stops once the improvement is tiny, i.e. close to where the gradient vanishes
+    // Ideal ignores parameter changes below 1e-6, so the step has to be larger than that
+    constexpr double h = 1e-4;
+    for (size_t j = 0; j < 3; ++j) {
+        if (x[j] <= Optimizer::lowerBound[j] + h || x[j] >= Optimizer::upperBound[j] - h) { continue; }
+        auto xp = x, xm = x;
+        xp[j] += h;
+        xm[j] -= h;
+        const auto fdGrad = (getMSE(xp) - getMSE(xm)) / (2 * h);
+        INFO("parameter " << j << ", mse " << mse << ", finite difference gradient " << fdGrad);
+        CHECK(std::abs(fdGrad) <= 5e-3 * mse);
+    }
+}
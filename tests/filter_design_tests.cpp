@@ -0,0 +1,246 @@
+// Copyright (C) 2024 - zsliu98
+// This file is part of ZLEqualizer
+//
+// ZLEqualizer is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License Version 3 as published by the Free Software Foundation.
+//
+// ZLEqualizer is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License along with ZLEqualizer. If not, see <https://www.gnu.org/licenses/>.
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <complex>
+#include <cstring>
+#include <numbers>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "dsp/filter/filter.hpp"
+
+namespace {
+    /**
+     * logarithmically spaced values from start to end (both included)
+     */
+    std::vector<double> getLogGrid(const double start, const double end, const size_t num) {
+        std::vector<double> xs(num);
+        for (size_t i = 0; i < num; ++i) {
+            xs[i] = start * std::pow(end / start, static_cast<double>(i) / static_cast<double>(num - 1));
+        }
+        return xs;
+    }
+
+    /**
+     * the parameter ranges of the plugin, freq 10 ~ 20000 Hz, gain -30 ~ 30 dB, Q 0.025 ~ 25
+     */
+    const auto freqs = getLogGrid(10.0, 20000.0, 97);
+    const auto qs = getLogGrid(0.025, 25.0, 41);
+    const auto gains = [] {
+        std::vector<double> xs;
+        for (int i = -40; i <= 40; ++i) {
+            xs.push_back(static_cast<double>(i) * 0.75);
+        }
+        return xs;
+    }();
+
+    constexpr size_t arraySize = 16;
+    using Coeffs = std::array<std::array<double, 6>, arraySize>;
+
+    // the filter types of the plugin (zlDSP::fType)
+    constexpr std::array<zlFilter::FilterType, 8> filterTypes{
+        zlFilter::FilterType::peak, zlFilter::FilterType::lowShelf, zlFilter::FilterType::lowPass,
+        zlFilter::FilterType::highShelf, zlFilter::FilterType::highPass, zlFilter::FilterType::notch,
+        zlFilter::FilterType::bandPass, zlFilter::FilterType::tiltShelf
+    };
+    constexpr std::array<size_t, 7> orders{1, 2, 4, 6, 8, 12, 16};
+
+    /**
+     * design without the cache
+     */
+    size_t designDirect(const zlFilter::FilterType filterType, const size_t n,
+                        const double f, const double fs, const double gDB, const double q0, Coeffs &coeffs) {
+        using zlFilter::MartinCoeff;
+        return zlFilter::FilterDesign::updateCoeffs<arraySize,
+            MartinCoeff::get1LowShelf, MartinCoeff::get1HighShelf, MartinCoeff::get1TiltShelf,
+            MartinCoeff::get1LowPass, MartinCoeff::get1HighPass,
+            MartinCoeff::get2Peak,
+            MartinCoeff::get2LowShelf, MartinCoeff::get2HighShelf, MartinCoeff::get2TiltShelf,
+            MartinCoeff::get2LowPass, MartinCoeff::get2HighPass,
+            MartinCoeff::get2BandPass, MartinCoeff::get2Notch>(filterType, n, f, fs, gDB, q0, coeffs);
+    }
+
+    bool isSame(const Coeffs &x, const Coeffs &y, const size_t num) {
+        return std::memcmp(x.data(), y.data(), num * sizeof(x[0])) == 0;
+    }
+
+    struct Param {
+        zlFilter::FilterType filterType;
+        size_t n;
+        double f, fs, gDB, q0;
+    };
+
+    /**
+     * random parameters within the ranges of the plugin, the gain is not on the 0.01 dB grid
+     */
+    std::vector<Param> getRandomParams(const size_t num, const unsigned int seed) {
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<size_t> typeDist(0, filterTypes.size() - 1), orderDist(0, orders.size() - 1);
+        std::uniform_real_distribution<double> logFreqDist(std::log(10.0), std::log(20000.0));
+        std::uniform_real_distribution<double> gainDist(-30.0, 30.0);
+        std::uniform_real_distribution<double> logQDist(std::log(0.025), std::log(25.0));
+        constexpr std::array<double, 4> sampleRates{44100.0, 48000.0, 96000.0, 192000.0};
+        std::vector<Param> params(num);
+        for (auto &p: params) {
+            p = {
+                filterTypes[typeDist(gen)], orders[orderDist(gen)], std::exp(logFreqDist(gen)),
+                sampleRates[gen() % sampleRates.size()], gainDist(gen), std::exp(logQDist(gen))
+            };
+        }
+        return params;
+    }
+}
+
+TEST_CASE("BatchDesign matches MartinCoeff::get2Peak", "[filter_design]") {
+    const auto sampleRate = GENERATE(44100.0, 48000.0, 96000.0, 192000.0);
+    constexpr size_t batchSize = 8;
+
+    struct Param {
+        double f, gDB, q0;
+    };
+    std::vector<Param> params;
+    for (const auto f: freqs) {
+        for (const auto gDB: gains) {
+            for (const auto q0: qs) {
+                params.push_back({f, gDB, q0});
+            }
+        }
+    }
+
+    zlFilter::BatchDesign<batchSize> batch;
+    double maxLowError = 0.0, maxHighError = 0.0;
+    for (size_t start = 0; start < params.size(); start += batchSize) {
+        const auto end = std::min(start + batchSize, params.size());
+        batch.clear();
+        for (size_t i = start; i < end; ++i) {
+            batch.push(params[i].f, sampleRate, params[i].gDB, params[i].q0);
+        }
+        batch.design();
+        for (size_t i = start; i < end; ++i) {
+            const auto w0 = 2 * std::numbers::pi * params[i].f / sampleRate;
+            const auto ref = zlFilter::MartinCoeff::get2Peak(w0, zlFilter::db_to_gain(params[i].gDB), params[i].q0);
+            const auto coeff = batch.getCoeff(i - start);
+            double maxRef = 0.0, maxDiff = 0.0;
+            for (size_t j = 0; j < 6; ++j) {
+                REQUIRE(std::isfinite(coeff[j]));
+                maxRef = std::max(maxRef, std::abs(ref[j]));
+                maxDiff = std::max(maxDiff, std::abs(coeff[j] - ref[j]));
+            }
+            auto &maxError = w0 > 0.01 ? maxHighError : maxLowError;
+            maxError = std::max(maxError, maxDiff / maxRef);
+        }
+    }
+
+    INFO("sample rate " << sampleRate);
+    CHECK(maxHighError < 1e-8);
+    CHECK(maxLowError < 1e-5);
+}
+
+TEST_CASE("MartinCoeff::updateCoeffs matches the direct design", "[filter_design]") {
+    const auto params = getRandomParams(2000, 1);
+    Coeffs cached{}, direct{};
+    for (const auto &p: params) {
+        const auto directNum = designDirect(p.filterType, p.n, p.f, p.fs, p.gDB, p.q0, direct);
+        // the first call may miss and the second one should hit, both return the same design
+        for (size_t round = 0; round < 2; ++round) {
+            const auto num = zlFilter::MartinCoeff::updateCoeffs(p.filterType, p.n, p.f, p.fs, p.gDB, p.q0, cached);
+            REQUIRE(num == directNum);
+            REQUIRE(isSame(cached, direct, num));
+        }
+    }
+}
+
+TEST_CASE("MartinCoeff::updateCoeffs is consistent across threads", "[filter_design]") {
+    // more keys than slots, so that the threads keep evicting and overwriting each other's slots
+    const auto params = getRandomParams(1024, 2);
+    std::vector<Coeffs> directs(params.size());
+    std::vector<size_t> directNums(params.size());
+    for (size_t i = 0; i < params.size(); ++i) {
+        const auto &p = params[i];
+        directNums[i] = designDirect(p.filterType, p.n, p.f, p.fs, p.gDB, p.q0, directs[i]);
+    }
+
+    std::atomic<size_t> mismatchNum{0};
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937 gen(t);
+            Coeffs cached{};
+            for (size_t k = 0; k < 20000; ++k) {
+                // the threads share a small set of hot keys and a large set of cold ones
+                const auto i = k % 2 == 0 ? gen() % 16 : gen() % params.size();
+                const auto &p = params[i];
+                const auto num = zlFilter::MartinCoeff::updateCoeffs(p.filterType, p.n, p.f, p.fs, p.gDB, p.q0,
+                                                                     cached);
+                if (num != directNums[i] || !isSame(cached, directs[i], num)) {
+                    mismatchNum.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+    CHECK(mismatchNum.load() == 0);
+}
+
+TEST_CASE("MartinCoeff::updateCoeffs keeps the exact gain", "[filter_design]") {
+    SECTION("gains within 0.01 dB get their own designs") {
+        Coeffs x{}, y{}, direct{};
+        for (const auto &p: getRandomParams(500, 3)) {
+            const auto gDB = std::round(p.gDB * 100) * 0.01;
+            const auto xNum = zlFilter::MartinCoeff::updateCoeffs(p.filterType, p.n, p.f, p.fs, gDB - 0.0049, p.q0, x);
+            const auto yNum = zlFilter::MartinCoeff::updateCoeffs(p.filterType, p.n, p.f, p.fs, gDB + 0.0049, p.q0, y);
+            REQUIRE(xNum == designDirect(p.filterType, p.n, p.f, p.fs, gDB - 0.0049, p.q0, direct));
+            REQUIRE(isSame(x, direct, xNum));
+            REQUIRE(yNum == designDirect(p.filterType, p.n, p.f, p.fs, gDB + 0.0049, p.q0, direct));
+            REQUIRE(isSame(y, direct, yNum));
+        }
+    }
+
+    SECTION("the dynamic gain bypasses the cache with the same design") {
+        Coeffs cached{}, uncached{};
+        for (const auto &p: getRandomParams(500, 4)) {
+            const auto num = zlFilter::MartinCoeff::updateCoeffs(p.filterType, p.n, p.f, p.fs, p.gDB, p.q0, cached);
+            const auto uncachedNum = zlFilter::MartinCoeff::updateCoeffs<arraySize, false>(
+                p.filterType, p.n, p.f, p.fs, p.gDB, p.q0, uncached);
+            REQUIRE(num == uncachedNum);
+            REQUIRE(isSame(cached, uncached, num));
+        }
+    }
+}
+
+TEST_CASE("db_to_gain_fast is as accurate as db_to_gain", "[filter_design]") {
+    const auto getReference = [](const double db) {
+        return static_cast<double>(std::pow(10.0L, static_cast<long double>(db) / 20.0L));
+    };
+
+    SECTION("on the 0.01 dB grid") {
+        double maxError = 0.0;
+        for (int k = -10000; k <= 10000; ++k) {
+            const auto db = static_cast<double>(k) * 0.01;
+            const auto reference = getReference(db);
+            maxError = std::max(maxError, std::abs(zlFilter::db_to_gain_fast(db) - reference) / reference);
+        }
+        CHECK(maxError < 3e-15);
+    }
+
+    SECTION("off the grid") {
+        std::mt19937 gen(5);
+        std::uniform_real_distribution<double> dist(-150.0, 150.0);
+        for (size_t i = 0; i < 10000; ++i) {
+            const auto db = dist(gen);
+            REQUIRE(zlFilter::db_to_gain_fast(db) == zlFilter::db_to_gain(db));
+        }
+    }
+}
@@ -0,0 +1,98 @@
+// Copyright (C) 2024 - zsliu98
+// This file is part of ZLEqualizer
+//
+// ZLEqualizer is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License Version 3 as published by the Free Software Foundation.
+//
+// ZLEqualizer is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License along with ZLEqualizer. If not, see <https://www.gnu.org/licenses/>.
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "PluginProcessor.hpp"
+#include "test_helpers.hpp"
+
+#if ZL_RT_AUDIT
+
+namespace {
+    constexpr size_t activeBandNum = 8;
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+
+    /**
+     * set a parameter the way a host automates it, i.e. from the audio thread without notifying the host
+     * the parameter listeners of APVTS take a lock which is out of the plugin's hands,
+     * so it is called outside the audited processBlock, which then picks up the changes
+     */
+    void automateParameter(juce::RangedAudioParameter *para, const float value) {
+        para->setValue(para->convertTo0to1(value));
+    }
+
+    enum Routing {
+        internalSide, externalSide, mainSolo, sideSolo
+    };
+}
+
+TEST_CASE("Controller process is real-time safe", "[rt_audit]") {
+    const auto structure = GENERATE(range(0, 6));
+    const auto isLRMS = GENERATE(false, true);
+    const auto isDynamic = GENERATE(false, true);
+    const auto routing = GENERATE(Routing::internalSide, Routing::externalSide, Routing::mainSolo, Routing::sideSolo);
+
+    PluginProcessor processor;
+    zlTest::setParameter(processor.parameters, zlDSP::filterStructure::ID, static_cast<float>(structure));
+    zlTest::setParameter(processor.parameters, zlDSP::sideChain::ID, routing == Routing::internalSide ? 0.f : 1.f);
+    for (size_t i = 0; i < activeBandNum; ++i) {
+        const auto filterType = i == 0 ? zlDSP::fType::highPass : zlDSP::fType::peak;
+        zlTest::setParameter(processor.parametersNA, zlDSP::appendSuffix(zlState::active::ID, i), 1.f);
+        zlTest::setParameter(processor.parameters, zlDSP::appendSuffix(zlDSP::fType::ID, i),
+                                  static_cast<float>(filterType));
+        zlTest::setParameter(processor.parameters, zlDSP::appendSuffix(zlDSP::freq::ID, i),
+                                  40.f * std::pow(2.f, static_cast<float>(i) * 1.25f));
+        zlTest::setParameter(processor.parameters, zlDSP::appendSuffix(zlDSP::lrType::ID, i),
+                                  isLRMS ? static_cast<float>(i % 5) : 0.f);
+        zlTest::setParameter(processor.parameters, zlDSP::appendSuffix(zlDSP::dynamicON::ID, i),
+                                  isDynamic ? 1.f : 0.f);
+    }
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    // channels 0/1 are the main input and channels 2/3 are the external side chain
+    juce::AudioBuffer<zlDSP::EngineFloatType> buffer(4, blockSize);
+    juce::AudioBuffer<zlDSP::EngineFloatType> source(4, blockSize);
+    zlTest::fillNoise(source);
+    juce::MidiBuffer midiBuffer;
+    std::array<juce::RangedAudioParameter *, activeBandNum> gainParas{}, soloParas{};
+    const auto *soloID = routing == Routing::sideSolo ? zlDSP::sideSolo::ID : zlDSP::solo::ID;
+    for (size_t i = 0; i < activeBandNum; ++i) {
+        gainParas[i] = processor.parameters.getParameter(zlDSP::appendSuffix(zlDSP::gain::ID, i));
+        soloParas[i] = processor.parameters.getParameter(zlDSP::appendSuffix(soloID, i));
+    }
+
+    const auto runBlocks = [&](const int blockNum) {
+        for (int j = 0; j < blockNum; ++j) {
+            buffer.makeCopyOf(source, true);
+            // automate the band gains, so that the filters are redesigned on the audio thread
+            for (size_t i = 0; i < activeBandNum; ++i) {
+                automateParameter(gainParas[i], static_cast<float>((j + static_cast<int>(i)) % 13 - 6));
+            }
+            // move the solo across the bands, so that the solo filter is redesigned on the audio thread
+            if (routing == Routing::mainSolo || routing == Routing::sideSolo) {
+                const auto soloIdx = static_cast<size_t>(j / 8) % activeBandNum;
+                for (size_t i = 0; i < activeBandNum; ++i) {
+                    automateParameter(soloParas[i], i == soloIdx ? 1.f : 0.f);
+                }
+            }
+            processor.processBlock(buffer, midiBuffer);
+        }
+    };
+
+    // processBlock audits itself from the first block after prepareToPlay
+    // only the tail notification is exempt, and it is counted apart from the violations
+    zlChore::RTAudit::resetViolationNum();
+    runBlocks(3 * static_cast<int>(sampleRate) / blockSize);
+    INFO("one-shot violations: " << zlChore::RTAudit::getOneShotViolationNum());
+    CHECK(zlChore::RTAudit::getViolationNum() == 0);
+}
+
+#endif
@@ -0,0 +1,45 @@
+// Copyright (C) 2024 - zsliu98
+// This file is part of ZLEqualizer
+//
+// ZLEqualizer is free software: you can redistribute it and/or modify it under the terms of the GNU Affero General Public License Version 3 as published by the Free Software Foundation.
+//
+// ZLEqualizer is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Affero General Public License for more details.
+//
+// You should have received a copy of the GNU Affero General Public License along with ZLEqualizer. If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ZLEQUALIZER_TEST_HELPERS_HPP
+#define ZLEQUALIZER_TEST_HELPERS_HPP
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+#include <random>
+#include <string>
+
+namespace zlTest {
+    /**
+     * set a parameter with its plain (denormalized) value and notify all listeners
+     */
+    inline void setParameter(juce::AudioProcessorValueTreeState &parameters,
+                             const std::string &ID, const float value) {
+        auto *para = parameters.getParameter(ID);
+        jassert(para != nullptr);
+        para->setValueNotifyingHost(para->convertTo0to1(value));
+    }
+
+    /**
+     * fill the buffer with white noise at about -12 dBFS
+     */
+    template<typename FloatType>
+    void fillNoise(juce::AudioBuffer<FloatType> &buffer, const unsigned int seed = 42) {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<FloatType> dist(FloatType(-.25), FloatType(.25));
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+            auto *samples = buffer.getWritePointer(channel);
+            for (int i = 0; i < buffer.getNumSamples(); ++i) {
+                samples[i] = dist(gen);
+            }
+        }
+    }
+}
+
+#endif //ZLEQUALIZER_TEST_HELPERS_HPP